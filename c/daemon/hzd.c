@@ -0,0 +1,887 @@
+/*****************************************************************************
+* | File        :   hzd.c
+* | Author      :   Highz team
+* | Function    :   Acquisition daemon with a local control socket
+* | Info        :
+*----------------
+* | This version:   V1.0
+* | Date        :   2026-10-19
+* | Info        :
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documnetation files (the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to  whom the Software is
+# furished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included in
+# all copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS OR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+# THE SOFTWARE.
+#
+******************************************************************************/
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdarg.h>
+#include <string.h>
+#include <signal.h>
+#include <errno.h>
+#include <time.h>
+#include <poll.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include "ADS1263.h"
+#include "ADS1263_Map.h"
+#include "ADS1263_MultiBus.h"
+#include "ADS1263_Reconfig.h"
+#include "ADS1263_Calib.h"
+#include "ADS1263_Sched.h"
+#include "ADS1263_Timing.h"
+#include "ADS1263_RT.h"
+#include "ADS1263_Session.h"
+#include "ADS1263_Capture.h"
+#include "ADS1263_Pyramid.h"
+#include "ADS1263_Arrow.h"
+#include "ADS1263_Shm.h"
+#include "ADS1263_Latest.h"
+
+/******************************************************************************
+hzd: long-running acquisition daemon
+
+    hzd [-m channels.map] [-s socket] [-a]
+
+    -m       channel map (default channels.map)
+    -s       control socket (default /run/hzd.sock)
+    -a       start acquiring at once instead of waiting for "start"
+
+The daemon brings the chips up once and then owns them. Sweeps go to the
+same outputs as examples/main.c (capture, pyramid, Arrow stream) and to
+shared memory: the sweep ring live readers follow (tools/hzwatch) and the
+latest-sweep snapshot pollers read.
+
+A restart (crash, upgrade) loses no sweep of the capture. The sweep ring
+outlives the process and records how far the capture has written
+(ADS1263_Shm_Commit). The next hzd takes the ring over, writes the sweeps
+that had not reached the disk into its new capture and carries on with
+the sweep numbering. The pyramid and the Arrow stream are not replayed:
+after a crash the pyramid lacks the buckets it had not flushed yet
+(ADS1263_PYRAMID_CONFIG.FlushBuckets) and the stream the batches it had
+not written.
+Output files are named after the first sweep they hold, so the files of
+successive runs follow on from each other. Existing files are never
+overwritten: when a name is taken (the ring was lost and numbering
+started again) "-2", "-3" ... is added. On exit the chips are left
+configured and idle: the next start finds their configuration hash
+unchanged (ADS1263_Startup) and skips the register set-up and
+calibration. "quit reset" powers them down instead.
+
+Control is a line protocol on a Unix stream socket (tools/hzctl, or
+socat - UNIX-CONNECT:/run/hzd.sock). The socket is created with mode
+HZD_SOCKET_MODE (0660): only the owner of hzd (usually root) and members
+of its group may connect. Start hzd under the group of its operators
+(e.g. "sg hzd -c hzd") to hand control to them. One command per line; the reply is
+zero or more data lines and then a line "ok [detail]" or "err <reason>":
+
+    start               resume acquisition (bus threads started)
+    stop                pause acquisition; outputs stay open
+    reconfigure <map>   switch to another map of the same chips: rates,
+                        channels, filters. Staged with
+                        ADS1263_MultiBus_Reconfigure, so the chips are not
+                        re-initialised and no sweep is lost; replies with
+                        the epoch the new sweeps carry
+    stats               "key value" lines: state, sweeps, sweep rate,
+                        "rate <chip.channel> <Hz>" per channel, outputs
+    snapshot            the newest sweep, one line per channel
+    quit [reset]        stop and exit; reset also powers the chips down
+
+start, stop and reconfigure are carried out by the acquisition thread
+between two sweeps, so the reply comes when the current sweep ends. A
+command waits at most HZD_WAIT_MS (5 s) for it: where one sweep takes
+longer, the reply is "err acquisition thread did not answer" and the
+command is still carried out after that sweep. stats and snapshot are
+answered by the control thread from counters and the latest-sweep
+snapshot (ADS1263_Latest.h), without touching the acquisition at all.
+
+The hz= dividers of a map come from estimated sweep times. Once a second
+the acquisition thread compares the achieved rates with the targets; when
+a channel falls under its target the dividers are rebuilt for the
+measured sweep rate and staged like a reconfiguration (a new epoch). A
+channel that cannot reach its target even then is reported once.
+******************************************************************************/
+#define REF             5.08                    //Reference voltage of every chip
+#define DETECTOR_TABLE  "detector_cal.txt"      //Log-detector dBm curves, optional
+#define CONFIG_HASH     "ads1263_config.hash"   //Chips matching it are not reconfigured
+#define CALIB_FILE      "ads1263_calib.txt"     //OFCAL/FSCAL per chip and data rate
+#define RECAL_INTERVAL  600                     //Seconds between background offset calibrations
+#define RT_PRIORITY     80                      //SCHED_FIFO priority of the bus threads, 0 = off
+#define RT_CPU_BUS0     3                       //CPU of the spidev0 thread, -1 = any
+#define RT_CPU_BUS1     2                       //CPU of the spidev1 thread, -1 = any
+#define HUGE_PAGES      1                       //Session arena in 2 MB pages when reserved
+#define CAPTURE_FILE    "capture-%s.hzc"        //Every sweep, chunked and indexed; NULL = none
+#define PYRAMID_FILE    "capture-%s.hzp"        //Min/max/mean per channel; NULL = none
+#define ARROW_FILE      "capture-%s.arrows"     //Arrow IPC stream; NULL = none
+                                                //%s = first sweep of the file, -<n> if taken
+#define RING_SLOTS      8192                    //Sweeps kept across a restart, > what the capture buffers
+#define PUSH_FRAMES     1024                    //Capture frames in memory before they are written
+
+#define HZD_SOCKET      "/run/hzd.sock"
+#define HZD_SOCKET_MODE 0660                    //Owner and group only: any client can stop the chips
+#define HZD_CLIENTS     8
+#define HZD_LINE        512
+#define HZD_WAIT_MS     5000                    //Longest a command waits for the acquisition thread
+
+typedef enum
+{
+    CMD_NONE = 0,
+    CMD_START,
+    CMD_STOP,
+    CMD_RECONFIG,
+}HZD_COMMAND;
+
+typedef struct
+{
+    int      Fd;
+    size_t   Len;
+    char     Line[HZD_LINE];
+} HZD_CLIENT;
+
+static ADS1263_MAP Map;                 // Names of the sweeps being consumed
+static ADS1263_MAP Staged;              // Map of a reconfiguration in flight
+static ADS1263_SCAN NewScan;
+static ADS1263_SCAN TuneScan;           // Copy of the table being scanned, for ADS1263_Sched_Retune
+static pthread_mutex_t MapLock = PTHREAD_MUTEX_INITIALIZER;
+static ADS1263_SESSION Session;
+static ADS1263_CAPTURE Recorder;
+static ADS1263_PYRAMID Summary;
+static ADS1263_ARROW Table;
+static ADS1263_SHM Ring;
+static ADS1263_LATEST Newest;
+static UBYTE Capture, Pyramid, Arrow, HavePower;
+static UBYTE Started;                   // Session_Start done
+static volatile UBYTE Acquiring;
+static volatile UBYTE Pending;          // Staged waits for its epoch
+static UDOUBLE PendingEpoch;
+static UBYTE Tuning;                    // Rebuilt dividers wait for their epoch
+static UDOUBLE TuneEpoch;
+static UDOUBLE Warned;                  // 1 + epoch of the last starved-target warning
+static uint64_t Base;                   // Sweeps before the last start
+static volatile sig_atomic_t Quit;
+static UBYTE Reset;                     // Power the chips down on exit
+
+// Commands handed to the acquisition thread
+static struct
+{
+    pthread_mutex_t Lock;
+    pthread_cond_t  Cond;
+    HZD_COMMAND Command;        // CMD_NONE once carried out
+    UBYTE    Status;
+    char     Reply[128];
+} Mail = {PTHREAD_MUTEX_INITIALIZER, PTHREAD_COND_INITIALIZER, CMD_NONE, 0, ""};
+
+static void Handler(int signo)
+{
+    (void)signo;
+    Quit = 1;
+}
+
+/******************************************************************************
+Acquisition thread
+******************************************************************************/
+static UBYTE Acq_Start(void)
+{
+    if(Acquiring)
+        return 0;
+    if(!Started) {
+        TuneScan = *Session.Scan;
+        if(ADS1263_Session_Start(&Session) != 0)
+            return 1;
+        Started = 1;
+    } else if(ADS1263_MultiBus_Start(Session.MultiBus, Session.Scan) != 0) {
+        return 1;
+    } else {
+        // The new bus threads allocated; the check covers the run from here
+        ADS1263_Session_Mark(&Session);
+    }
+    // MultiBus counts from 0 again; sweep numbers in the outputs keep going
+    Base = Ring.Next;
+    Acquiring = 1;
+    return 0;
+}
+
+static void Acq_SwapMap(void)
+{
+    pthread_mutex_lock(&MapLock);
+    Map = Staged;
+    TuneScan = NewScan;
+    Tuning = 0;
+    Pending = 0;
+    pthread_mutex_unlock(&MapLock);
+}
+
+static void Acq_Stop(void)
+{
+    if(!Acquiring)
+        return;
+    ADS1263_MultiBus_Stop(Session.MultiBus);
+    Acquiring = 0;
+    // A change staged but not reached: the bus threads are gone, apply it here
+    if(Pending && ADS1263_Reconfig_Scan(Session.Scan, &NewScan) == 0)
+        Acq_SwapMap();
+    else if(Tuning)
+        ADS1263_Reconfig_Scan(Session.Scan, &TuneScan);
+    Tuning = 0;
+}
+
+/* the hz= targets were set from estimated sweep times: correct them from measured ones */
+static void Acq_Retune(void)
+{
+    static ADS1263_SCAN retuned;
+    UDOUBLE epoch;
+    UBYTE starved;
+
+    // One change at a time; a reconfiguration brings dividers of its own
+    if(Pending || Tuning || (starved = ADS1263_Sched_Starved(&TuneScan, Session.Rates)) == 0)
+        return;
+    retuned = TuneScan;
+    if(ADS1263_Sched_Retune(&retuned, Session.Rates) == 0) {
+        if(Warned != Session.Scan->Epoch + 1)
+            printf("hzd: %d channels stay under their hz= target at %.1f sweeps/s \r\n", starved,
+                   Session.Rates->SweepHz);
+        Warned = Session.Scan->Epoch + 1;
+        return;
+    }
+    if(ADS1263_MultiBus_Reconfigure(Session.MultiBus, &retuned, &epoch) != 0)
+        return;
+    printf("hzd: sweeps run at %.1f/s, %d channels under their hz= target: dividers rebuilt for epoch %lu \r\n",
+           Session.Rates->SweepHz, starved, (unsigned long)epoch);
+    TuneScan = retuned;
+    TuneEpoch = epoch;
+    Tuning = 1;
+}
+
+static void Acq_Serve(void)
+{
+    UDOUBLE epoch;
+
+    pthread_mutex_lock(&Mail.Lock);
+    Mail.Status = 0;
+    Mail.Reply[0] = '\0';
+    switch(Mail.Command) {
+    case CMD_START:
+        Mail.Status = Acq_Start();
+        snprintf(Mail.Reply, sizeof(Mail.Reply), Mail.Status ? "bus threads did not start" : "epoch %lu",
+                 (unsigned long)Session.Scan->Epoch);
+        break;
+    case CMD_STOP:
+        Acq_Stop();
+        break;
+    case CMD_RECONFIG:
+        if(Acquiring) {
+            // Staged; every bus switches at the same sweep
+            Mail.Status = ADS1263_MultiBus_Reconfigure(Session.MultiBus, &NewScan, &epoch);
+            if(Mail.Status == 0) {
+                PendingEpoch = epoch;
+                Pending = 1;
+            }
+        } else {
+            Mail.Status = ADS1263_Reconfig_Scan(Session.Scan, &NewScan);
+            epoch = Session.Scan->Epoch;
+            if(Mail.Status == 0)
+                Acq_SwapMap();
+        }
+        if(Mail.Status != 0)
+            snprintf(Mail.Reply, sizeof(Mail.Reply), "previous change still being applied, retry");
+        else
+            snprintf(Mail.Reply, sizeof(Mail.Reply), "epoch %lu", (unsigned long)epoch);
+        break;
+    default:
+        break;
+    }
+    Mail.Command = CMD_NONE;
+    pthread_cond_broadcast(&Mail.Cond);
+    pthread_mutex_unlock(&Mail.Lock);
+}
+
+/* a sweep to the files */
+static void Store(const ADS1263_FRAME *Frame)
+{
+    if(Capture)
+        ADS1263_Capture_Append(&Recorder, Frame);
+    if(Pyramid)
+        ADS1263_Pyramid_Append(&Summary, Frame);
+    if(Arrow)
+        ADS1263_Arrow_Append(&Table, Frame);
+}
+
+/* the sweeps the previous run left in the ring without capturing them */
+static void Acq_Replay(void)
+{
+    static ADS1263_FRAME frame;
+    ADS1263_SHM old;
+    ADS1263_SHM_STATUS status;
+    uint64_t stored = 0;
+
+    // Saved is the capture's progress only: the pyramid and the Arrow stream
+    // already hold some of these sweeps, so they are not given them again
+    if(!Capture || ADS1263_Shm_Unsaved(&old, &Ring) == 0)
+        return;
+    while((status = ADS1263_Shm_Read(&old, &frame)) == ADS1263_SHM_OK || status == ADS1263_SHM_OVERRUN) {
+        if(status != ADS1263_SHM_OK)
+            continue;
+        ADS1263_Capture_Append(&Recorder, &frame);
+        stored++;
+    }
+    printf("hzd: wrote %llu sweeps of the previous run, %llu were lost \r\n", (unsigned long long)stored,
+           (unsigned long long)old.Missed);
+    ADS1263_Shm_Detach(&old);
+}
+
+static void Acq_Loop(void)
+{
+    struct timespec until;
+    ADS1263_FRAME *Frame;
+
+    while(!Quit) {
+        if(__atomic_load_n(&Mail.Command, __ATOMIC_ACQUIRE) != CMD_NONE)
+            Acq_Serve();
+        if(!Acquiring) {
+            pthread_mutex_lock(&Mail.Lock);
+            clock_gettime(CLOCK_REALTIME, &until);
+            until.tv_nsec += 200000000L;
+            if(until.tv_nsec >= 1000000000L) {
+                until.tv_sec++;
+                until.tv_nsec -= 1000000000L;
+            }
+            if(Mail.Command == CMD_NONE)
+                pthread_cond_timedwait(&Mail.Cond, &Mail.Lock, &until);
+            pthread_mutex_unlock(&Mail.Lock);
+            continue;
+        }
+        Frame = ADS1263_MultiBus_Acquire(Session.MultiBus);
+        if(Frame == NULL)
+            continue;
+        Frame->Header.Sequence += Base;
+        // The staged map names the sweeps from its epoch on
+        if(Pending && Frame->Header.Epoch == PendingEpoch)
+            Acq_SwapMap();
+        if(Tuning && Frame->Header.Epoch == TuneEpoch)
+            Tuning = 0;
+        if(Frame->Header.End_ns > Session.Rates->Time_ns + 1000000000ull) {
+            ADS1263_Sched_Update(Session.Scan, Session.Rates);
+            Acq_Retune();
+        }
+        ADS1263_Frame_ToVolts(Frame);
+        if(HavePower)
+            ADS1263_Frame_ToPower(Frame);
+        Store(Frame);
+        ADS1263_Shm_Publish(&Ring, Frame);
+        // A restart writes again what the capture has not written yet
+        ADS1263_Shm_Commit(&Ring, Capture ? ADS1263_Capture_Saved(&Recorder) : Ring.Next);
+        ADS1263_Latest_Publish(&Newest, Frame);
+        ADS1263_MultiBus_Release(Session.MultiBus);
+    }
+    Acq_Stop();
+}
+
+/******************************************************************************
+Control thread
+******************************************************************************/
+static int Reply(int Fd, const char *Format, ...) __attribute__((format(printf, 2, 3)));
+static int Reply(int Fd, const char *Format, ...)
+{
+    char line[HZD_LINE];
+    va_list ap;
+    int n;
+
+    va_start(ap, Format);
+    n = vsnprintf(line, sizeof(line) - 1, Format, ap);
+    va_end(ap);
+    if(n < 0)
+        return -1;
+    if(n > (int)sizeof(line) - 2)
+        n = sizeof(line) - 2;
+    line[n++] = '\n';
+    return send(Fd, line, n, MSG_NOSIGNAL) == n ? 0 : -1;
+}
+
+/* hand a command to the acquisition thread and wait for it to be carried out */
+static UBYTE Post(HZD_COMMAND Command, char *Out, size_t Size)
+{
+    struct timespec until;
+    UBYTE ret = 1;
+
+    clock_gettime(CLOCK_REALTIME, &until);
+    until.tv_sec += HZD_WAIT_MS / 1000;
+    pthread_mutex_lock(&Mail.Lock);
+    Mail.Command = Command;
+    pthread_cond_broadcast(&Mail.Cond);
+    while(Mail.Command != CMD_NONE) {
+        if(pthread_cond_timedwait(&Mail.Cond, &Mail.Lock, &until) == ETIMEDOUT)
+            break;
+    }
+    if(Mail.Command == CMD_NONE) {
+        ret = Mail.Status;
+        snprintf(Out, Size, "%s", Mail.Reply);
+    } else {
+        snprintf(Out, Size, "acquisition thread did not answer");
+    }
+    pthread_mutex_unlock(&Mail.Lock);
+    return ret;
+}
+
+/* a map for the running chips: same chips in the same order, new channels */
+static UBYTE Prepare(const char *Path, char *Out, size_t Size)
+{
+    static ADS1263_MAP parsed;
+    UBYTE remap[ADS1263_MAX_CHIPS];
+    UBYTE c, n;
+    UWORD i;
+
+    if(Pending) {
+        snprintf(Out, Size, "previous change not reached yet, retry");
+        return 1;
+    }
+    if(ADS1263_Map_Load(&parsed, Path) != 0) {
+        snprintf(Out, Size, "cannot load %s", Path);
+        return 1;
+    }
+    pthread_mutex_lock(&MapLock);
+    memset(&Staged, 0, sizeof(Staged));
+    memcpy(Staged.Device, Map.Device, sizeof(Staged.Device));
+    for(c = 0; c < ADS1263_MAX_CHIPS; c++)
+        remap[c] = ADS1263_MAP_ANY;
+    for(n = 0; n < Map.ChipCount; n++) {
+        for(c = 0; c < parsed.ChipCount; c++) {
+            if(parsed.Chip[c].Bus == Map.Chip[n].Bus && parsed.Chip[c].CS == Map.Chip[n].CS)
+                break;
+        }
+        if(c == parsed.ChipCount) {
+            pthread_mutex_unlock(&MapLock);
+            snprintf(Out, Size, "chip %s (bus %d CS %d) missing from %s", Map.Chip[n].Name,
+                     Map.Chip[n].Bus, Map.Chip[n].CS, Path);
+            return 1;
+        }
+        remap[c] = n;
+        Staged.Chip[n] = parsed.Chip[c];
+        Staged.Chip[n].Id = Map.Chip[n].Id;
+    }
+    Staged.ChipCount = Map.ChipCount;
+    pthread_mutex_unlock(&MapLock);
+    // Chips the daemon did not bring up are left out, as Map_Discover would
+    for(i = 0; i < parsed.ChannelCount; i++) {
+        UBYTE chip = parsed.Channel[i].Chip;
+        if(chip != ADS1263_MAP_ANY && remap[chip] == ADS1263_MAP_ANY)
+            continue;
+        Staged.Channel[Staged.ChannelCount] = parsed.Channel[i];
+        if(chip != ADS1263_MAP_ANY)
+            Staged.Channel[Staged.ChannelCount].Chip = remap[chip];
+        Staged.ChannelCount++;
+    }
+    if(ADS1263_Map_Compile(&Staged, &NewScan) != 0 || ADS1263_Reconfig_Check(Session.Scan, &NewScan) != 0) {
+        snprintf(Out, Size, "%s does not compile for the running chips", Path);
+        return 1;
+    }
+    return 0;
+}
+
+static void Stats(int Fd)
+{
+    static uint64_t last_sweeps, last_ns;
+    static char name[ADS1263_MAX_CHIPS * ADS1263_FRAME_STRIDE][2 * ADS1263_MAP_NAME + 1];
+    static float hz[ADS1263_MAX_CHIPS * ADS1263_FRAME_STRIDE];
+    ADS1263_TIMING_STATS timing;
+    UWORD i, n;
+    UBYTE chip, slot;
+    uint64_t sweeps = __atomic_load_n(&Ring.Header->Head, __ATOMIC_ACQUIRE);
+    uint64_t now = ADS1263_Clock_ns(CLOCK_MONOTONIC);
+
+    Reply(Fd, "state %s", Acquiring ? "running" : "stopped");
+    Reply(Fd, "epoch %lu", (unsigned long)Session.Scan->Epoch);
+    Reply(Fd, "sweeps %llu", (unsigned long long)sweeps);
+    if(last_ns != 0 && now > last_ns)
+        Reply(Fd, "sweep_hz %.2f", (sweeps - last_sweeps) * 1e9 / (now - last_ns));
+    last_sweeps = sweeps;
+    last_ns = now;
+    // Achieved rate per channel, as refreshed by the acquisition thread;
+    // names are copied out so a slow client never holds up a map swap
+    pthread_mutex_lock(&MapLock);
+    for(chip = 0, n = 0; chip < Map.ChipCount && chip < Session.Scan->ChipCount; chip++) {
+        for(slot = 0; slot < ADS1263_FRAME_STRIDE; slot++) {
+            const char *channel = ADS1263_Map_Name(&Map, chip, slot);
+            if(channel[0] == '\0')
+                break;
+            snprintf(name[n], sizeof(name[n]), "%s.%s", Map.Chip[chip].Name, channel);
+            hz[n++] = Session.Rates->Hz[chip][slot];
+        }
+    }
+    pthread_mutex_unlock(&MapLock);
+    for(i = 0; i < n; i++)
+        Reply(Fd, "rate %s %.1f", name[i], hz[i]);
+    ADS1263_Timing_GetStats(&timing);
+    Reply(Fd, "drdy_misses %llu", (unsigned long long)timing.Misses);
+    Reply(Fd, "drdy_timeouts %llu", (unsigned long long)timing.Timeouts);
+    Reply(Fd, "crc_errors %llu", (unsigned long long)ADS1263_CrcErrors());
+    if(Capture) {
+        ADS1263_CAPTURE_STATS s;
+        ADS1263_Capture_GetStats(&Recorder, &s);
+        Reply(Fd, "capture_frames %llu", (unsigned long long)s.Frames);
+        Reply(Fd, "capture_dropped %llu", (unsigned long long)s.Dropped);
+        Reply(Fd, "capture_bytes %llu", (unsigned long long)s.Disk.Written);
+    }
+    if(Pyramid) {
+        ADS1263_PYRAMID_STATS s;
+        ADS1263_Pyramid_GetStats(&Summary, &s);
+        Reply(Fd, "pyramid_buckets %llu", (unsigned long long)s.Buckets);
+        Reply(Fd, "pyramid_dropped %llu", (unsigned long long)s.Dropped);
+    }
+    if(Arrow) {
+        ADS1263_ARROW_STATS s;
+        ADS1263_Arrow_GetStats(&Table, &s);
+        Reply(Fd, "arrow_rows %llu", (unsigned long long)s.Rows);
+        Reply(Fd, "arrow_dropped %llu", (unsigned long long)s.Dropped);
+    }
+    Reply(Fd, "ok");
+}
+
+static void Snapshot(int Fd)
+{
+    static ADS1263_LATEST_SWEEP sweep;
+    static char label[ADS1263_LATEST_MAX][ADS1263_LATEST_LABEL];
+    UDOUBLE epoch;
+    UWORD i, n;
+
+    // Labels and values of the same epoch; a reconfiguration in between is rare
+    do {
+        n = ADS1263_Latest_Labels(&Newest, label, &epoch);
+        if(ADS1263_Latest_Read(&Newest, &sweep) != 0) {
+            Reply(Fd, "err no sweep yet");
+            return;
+        }
+    } while(sweep.Epoch != epoch);
+    Reply(Fd, "sweep %llu epoch %lu state %d flags 0x%lx time_ns %llu", (unsigned long long)sweep.Sequence,
+          (unsigned long)sweep.Epoch, sweep.CalState, (unsigned long)sweep.Flags, (unsigned long long)sweep.Time_ns);
+    for(i = 0; i < sweep.Count && i < n; i++) {
+        const ADS1263_LATEST_VALUE *v = &sweep.Value[i];
+        if(sweep.Flags & ADS1263_FRAME_POWER)
+            Reply(Fd, "%s IN%d %.9f V %.2f dBm 0x%x", label[i], v->Input, v->Volt, v->Power, v->Status);
+        else
+            Reply(Fd, "%s IN%d %.9f V 0x%x", label[i], v->Input, v->Volt, v->Status);
+    }
+    Reply(Fd, "ok");
+}
+
+static void Command(int Fd, char *Line)
+{
+    char out[192], *arg;
+    HZD_COMMAND cmd = CMD_NONE;
+
+    Line[strcspn(Line, "\r\n")] = '\0';
+    arg = strchr(Line, ' ');
+    if(arg != NULL) {
+        *arg++ = '\0';
+        arg += strspn(arg, " ");
+    }
+    out[0] = '\0';
+    if(strcmp(Line, "start") == 0) {
+        cmd = CMD_START;
+    } else if(strcmp(Line, "stop") == 0) {
+        cmd = CMD_STOP;
+    } else if(strcmp(Line, "reconfigure") == 0) {
+        if(arg == NULL || *arg == '\0') {
+            Reply(Fd, "err usage: reconfigure <map file>");
+            return;
+        }
+        if(Prepare(arg, out, sizeof(out)) != 0) {
+            Reply(Fd, "err %s", out);
+            return;
+        }
+        cmd = CMD_RECONFIG;
+    } else if(strcmp(Line, "stats") == 0) {
+        Stats(Fd);
+        return;
+    } else if(strcmp(Line, "snapshot") == 0) {
+        Snapshot(Fd);
+        return;
+    } else if(strcmp(Line, "quit") == 0) {
+        if(arg != NULL && strcmp(arg, "reset") == 0)
+            Reset = 1;
+        Quit = 1;
+        Reply(Fd, "ok");
+        return;
+    } else if(Line[0] == '\0') {
+        return;
+    } else {
+        Reply(Fd, "err unknown command %s", Line);
+        return;
+    }
+    if(Post(cmd, out, sizeof(out)) != 0)
+        Reply(Fd, "err %s", out);
+    else
+        Reply(Fd, out[0] ? "ok %s" : "ok%s", out);
+}
+
+static int Listen(const char *Path)
+{
+    struct sockaddr_un addr;
+    mode_t mask;
+    int fd, ret;
+
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if(strlen(Path) >= sizeof(addr.sun_path))
+        return -1;
+    strcpy(addr.sun_path, Path);
+    fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if(fd < 0)
+        return -1;
+    unlink(Path);
+    // Created with the right mode, so it is never open to everyone, not even briefly
+    mask = umask(~HZD_SOCKET_MODE & 0777);
+    ret = bind(fd, (struct sockaddr *)&addr, sizeof(addr));
+    umask(mask);
+    if(ret != 0 || listen(fd, HZD_CLIENTS) != 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+static void *Control(void *Arg)
+{
+    int server = *(int *)Arg;
+    HZD_CLIENT client[HZD_CLIENTS];
+    struct pollfd pfd[HZD_CLIENTS + 1];
+    int n, i;
+    ssize_t got;
+    char *end;
+
+    ADS1263_RT_EnterIo();
+    for(i = 0; i < HZD_CLIENTS; i++)
+        client[i].Fd = -1;
+    while(!Quit) {
+        pfd[0].fd = server;
+        pfd[0].events = POLLIN;
+        for(i = 0; i < HZD_CLIENTS; i++) {
+            pfd[i + 1].fd = client[i].Fd;
+            pfd[i + 1].events = POLLIN;
+        }
+        n = poll(pfd, HZD_CLIENTS + 1, 200);
+        if(n <= 0)
+            continue;
+        if(pfd[0].revents & POLLIN) {
+            int fd = accept(server, NULL, NULL);
+            for(i = 0; fd >= 0 && i < HZD_CLIENTS && client[i].Fd >= 0; i++)
+                ;
+            if(fd >= 0 && i == HZD_CLIENTS) {
+                Reply(fd, "err too many clients");
+                close(fd);
+            } else if(fd >= 0) {
+                client[i].Fd = fd;
+                client[i].Len = 0;
+            }
+        }
+        for(i = 0; i < HZD_CLIENTS; i++) {
+            HZD_CLIENT *c = &client[i];
+            if(c->Fd < 0 || !(pfd[i + 1].revents & (POLLIN | POLLHUP | POLLERR)))
+                continue;
+            got = recv(c->Fd, c->Line + c->Len, sizeof(c->Line) - 1 - c->Len, 0);
+            if(got <= 0) {
+                close(c->Fd);
+                c->Fd = -1;
+                continue;
+            }
+            c->Len += got;
+            c->Line[c->Len] = '\0';
+            // Every complete line is a command
+            while((end = strchr(c->Line, '\n')) != NULL) {
+                *end = '\0';
+                Command(c->Fd, c->Line);
+                c->Len -= end + 1 - c->Line;
+                memmove(c->Line, end + 1, c->Len + 1);
+            }
+            if(c->Len == sizeof(c->Line) - 1) {
+                Reply(c->Fd, "err line too long");
+                c->Len = 0;
+            }
+        }
+    }
+    for(i = 0; i < HZD_CLIENTS; i++) {
+        if(client[i].Fd >= 0)
+            close(client[i].Fd);
+    }
+    return NULL;
+}
+
+/******************************************************************************
+Start-up and shutdown
+******************************************************************************/
+static void Shutdown(void)
+{
+    UBYTE chip, saved = 1;
+
+    if(Capture)
+        saved = (ADS1263_Capture_Close(&Recorder) == 0);
+    if(Pyramid)
+        ADS1263_Pyramid_Close(&Summary);
+    if(Arrow)
+        ADS1263_Arrow_Close(&Table);
+    ADS1263_Latest_Close(&Newest);
+    if(Ring.Header != NULL) {
+        printf("Published %llu sweeps \r\n", (unsigned long long)Ring.Next);
+        // Otherwise the next run writes what is still in the ring
+        if(saved)
+            ADS1263_Shm_Commit(&Ring, Ring.Next);
+        ADS1263_Shm_Close(&Ring);
+    }
+    ADS1263_Calib_Save(CALIB_FILE);
+    // Left configured, the chips are reused as they are by the next start
+    for(chip = 0; Reset && chip < Map.ChipCount; chip++) {
+        DEV_SPI_SelectBus(Map.Chip[chip].Bus);
+        DEV_Module_Exit(Map.Chip[chip].RST, Map.Chip[chip].CS);
+    }
+}
+
+/* 1 if the output is off or its file does not exist yet */
+static UBYTE Output_Free(const char *Format, const char *Stem)
+{
+    char file[256];
+
+    if(Format == NULL)
+        return 1;
+    snprintf(file, sizeof(file), Format, Stem);
+    return access(file, F_OK) != 0;
+}
+
+/* name the outputs after the first sweep, never reusing an existing file */
+static void Output_Stem(char *Stem, size_t Size, unsigned long long First)
+{
+    unsigned n;
+
+    snprintf(Stem, Size, "%llu", First);
+    for(n = 2; !Output_Free(CAPTURE_FILE, Stem) || !Output_Free(PYRAMID_FILE, Stem) ||
+               !Output_Free(ARROW_FILE, Stem); n++)
+        snprintf(Stem, Size, "%llu-%u", First, n);
+}
+
+static void Usage(void)
+{
+    fprintf(stderr, "usage: hzd [-m channels.map] [-s socket] [-a]\r\n");
+    exit(2);
+}
+
+int main(int argc, char **argv)
+{
+    const char *map = "channels.map", *path = HZD_SOCKET;
+    ADS1263_CAPTURE_CONFIG Disk;
+    ADS1263_PYRAMID_CONFIG Zoom;
+    ADS1263_ARROW_CONFIG Columns;
+    ADS1263_RT_CONFIG Rt = {RT_PRIORITY, {RT_CPU_BUS0, RT_CPU_BUS1}, 1};
+    pthread_t control;
+    UBYTE autostart = 0, chip;
+    char stem[64], file[256];
+    int opt, server;
+    size_t Reserve;
+
+    while((opt = getopt(argc, argv, "m:s:a")) != -1) {
+        switch(opt) {
+        case 'm': map = optarg; break;
+        case 's': path = optarg; break;
+        case 'a': autostart = 1; break;
+        default: Usage();
+        }
+    }
+    signal(SIGINT, Handler);
+    signal(SIGTERM, Handler);
+    signal(SIGPIPE, SIG_IGN);
+    Ring.Fd = Newest.Fd = -1;
+
+    if(ADS1263_Map_Load(&Map, map) != 0 || ADS1263_Map_Discover(&Map) != 0) {
+        printf("hzd: no usable chips in %s \r\n", map);
+        return 1;
+    }
+    ADS1263_Capture_Defaults(&Disk);
+    ADS1263_Pyramid_Defaults(&Zoom);
+    ADS1263_Arrow_Defaults(&Columns);
+    Reserve = (CAPTURE_FILE ? ADS1263_Capture_Reserve(&Disk) : 0) +
+              (PYRAMID_FILE ? ADS1263_Pyramid_Reserve(&Zoom, &Map) : 0) +
+              (ARROW_FILE ? ADS1263_Arrow_Reserve(&Columns, &Map) : 0);
+    if(ADS1263_Session_Open(&Session, Reserve, HUGE_PAGES) != 0 || ADS1263_Map_Compile(&Map, Session.Scan) != 0)
+        return 1;
+    ADS1263_SetMode(0);
+    ADS1263_Calib_Load(CALIB_FILE);
+    if(ADS1263_Map_Init(&Map, CONFIG_HASH) != 0)
+        return 1;
+    if(ADS1263_Calib_Missing(Session.Scan) > 0)
+        ADS1263_Calib_Save(CALIB_FILE);
+    ADS1263_Calib_SetInterval(RECAL_INTERVAL);
+    for(chip = 0; chip < Session.Scan->ChipCount; chip++)
+        ADS1263_SetRef(chip, REF);
+    HavePower = (ADS1263_Detector_Load(DETECTOR_TABLE) == 0);
+    ADS1263_RT_Init(&Rt);
+
+    // The ring of the previous run, if there was one: sweep numbers carry on
+    if(ADS1263_Shm_Resume(&Ring, ADS1263_SHM_NAME, RING_SLOTS) != 0) {
+        Shutdown();
+        return 1;
+    }
+    Output_Stem(stem, sizeof(stem), (unsigned long long)Ring.Header->Saved);
+
+    // Outputs stay open across stop and start; a pause is a gap in time
+    Disk.PushFrames = PUSH_FRAMES;
+    Disk.Writer.Exclusive = Zoom.Writer.Exclusive = Columns.Writer.Exclusive = 1;
+    if(CAPTURE_FILE) {
+        snprintf(file, sizeof(file), CAPTURE_FILE, stem);
+        Capture = (ADS1263_Capture_Open(&Recorder, &Session, file, &Map, &Disk) == 0);
+    }
+    if(PYRAMID_FILE) {
+        snprintf(file, sizeof(file), PYRAMID_FILE, stem);
+        Pyramid = (ADS1263_Pyramid_Open(&Summary, &Session, file, &Map, &Zoom) == 0);
+    }
+    Columns.Values = HavePower ? ADS1263_ARROW_POWER : ADS1263_ARROW_VOLT;
+    if(ARROW_FILE) {
+        snprintf(file, sizeof(file), ARROW_FILE, stem);
+        Arrow = (ADS1263_Arrow_Open(&Table, &Session, file, &Map, &Columns) == 0);
+    }
+    Acq_Replay();
+    if(ADS1263_Latest_Create(&Newest, ADS1263_LATEST_NAME, &Map) != 0) {
+        Shutdown();
+        return 1;
+    }
+
+    server = Listen(path);
+    if(server < 0) {
+        printf("hzd: cannot listen on %s (%s) \r\n", path, strerror(errno));
+        Shutdown();
+        return 1;
+    }
+    if(pthread_create(&control, NULL, Control, &server) != 0) {
+        close(server);
+        Shutdown();
+        return 1;
+    }
+    printf("hzd: %d chips, control on %s \r\n", Session.Scan->ChipCount, path);
+    if(autostart && Acq_Start() != 0)
+        Quit = 1;
+    ADS1263_RT_EnterIo();
+
+    Acq_Loop();
+
+    pthread_join(control, NULL);
+    close(server);
+    unlink(path);
+    Shutdown();
+    if(Started)
+        ADS1263_Session_Check(&Session);
+    printf("hzd: stopped \r\n");
+    return 0;
+}
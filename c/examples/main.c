@@ -1,7 +1,19 @@
 #include <stdlib.h>     //exit()
 #include <signal.h>     //signal()
 #include <time.h>
-#include "/home/peterson/High-Pricision_AD_HAT/c/lib/Driver/ADS1263.h"
+#include "ADS1263.h"
+#include "ADS1263_Map.h"
+#include "ADS1263_MultiBus.h"
+#include "ADS1263_Calib.h"
+#include "ADS1263_Sched.h"
+#include "ADS1263_Timing.h"
+#include "ADS1263_RT.h"
+#include "ADS1263_Session.h"
+#include "ADS1263_Capture.h"
+#include "ADS1263_Pyramid.h"
+#include "ADS1263_Arrow.h"
+#include "ADS1263_Shm.h"
+#include "ADS1263_Latest.h"
 #include "stdio.h"
 #include <string.h>
 
@@ -9,71 +21,238 @@
 #define USE_DEV_LIB
 #define REF         5.08        //Modify according to actual voltage
                                 //external AVDD and AVSS(Default), or internal 2.5V
+#define DETECTOR_TABLE  "detector_cal.txt"  //Log-detector dBm curves, optional
+#define CHANNEL_MAP     "channels.map"      //Stack topology, see examples/channels.map
+#define CONFIG_HASH     "ads1263_config.hash"   //Chips matching it are not reconfigured
+#define CALIB_FILE      "ads1263_calib.txt"     //OFCAL/FSCAL per chip and data rate
+#define RECAL_INTERVAL  600                     //Seconds between background offset calibrations
+#define RT_PRIORITY     80                      //SCHED_FIFO priority of the bus threads, 0 = off
+#define RT_CPU_BUS0     3                       //CPU of the spidev0 thread, -1 = any
+#define RT_CPU_BUS1     2                       //CPU of the spidev1 thread, -1 = any
+#define HUGE_PAGES      1                       //Session arena in 2 MB pages when reserved
+#define CAPTURE_FILE    "capture.hzc"           //Every sweep, chunked and indexed; NULL = no capture
+#define PYRAMID_FILE    "capture.hzp"           //Min/max/mean per channel at every zoom level; NULL = none
+#define ARROW_FILE      "capture.arrows"        //Arrow IPC stream for analysis tools; NULL = none
+#define SHM_RING        ADS1263_SHM_NAME        //Live sweeps for local readers (tools/hzwatch); NULL = none
+#define SHM_LATEST      ADS1263_LATEST_NAME     //Newest value of every channel for pollers; NULL = none
+
+// Used when CHANNEL_MAP is missing: the three Highz ADCs, all ten inputs each
+static const char DefaultMap[] =
+    "chip adc1 cs=12 drdy=16 rst=18 rate=38400\n"
+    "chip adc2 cs=22 drdy=17 rst=18 rate=38400\n"
+    "chip adc3 cs=23 drdy=25 rst=18 rate=38400\n"
+    "ch adc1 0 in0\nch adc1 1 in1\nch adc1 2 in2\nch adc1 3 in3\nch adc1 4 in4\n"
+    "ch adc1 5 in5\nch adc1 6 in6\nch adc1 7 in7\nch adc1 8 in8\nch adc1 9 in9\n"
+    "ch adc2 0 in0\nch adc2 1 in1\nch adc2 2 in2\nch adc2 3 in3\nch adc2 4 in4\n"
+    "ch adc2 5 in5\nch adc2 6 in6\nch adc2 7 in7\nch adc2 8 in8\nch adc2 9 in9\n"
+    "ch adc3 0 in0\nch adc3 1 in1\nch adc3 2 in2\nch adc3 3 in3\nch adc3 4 in4\n"
+    "ch adc3 5 in5\nch adc3 6 in6\nch adc3 7 in7\nch adc3 8 in8\nch adc3 9 in9\n";
+
+static ADS1263_MAP Map;
+static ADS1263_SESSION Session;     // Scan table, frame ring and stats, one arena
+static ADS1263_CAPTURE Recorder;
+static UBYTE Capture;
+static ADS1263_PYRAMID Summary;
+static UBYTE Pyramid;
+static ADS1263_ARROW Table;
+static UBYTE Arrow;
+static ADS1263_SHM Ring;
+static UBYTE Publish;
+static ADS1263_LATEST Newest;
+static UBYTE Latest;
+static volatile sig_atomic_t Streaming, Stop;
+
+static void Exit(void)
+{
+    ADS1263_TIMING_STATS Timing;
+    UBYTE chip;
+    ADS1263_Timing_GetStats(&Timing);
+    printf("DRDY waits %llu, slept %llu, deadline misses %llu (worst %.1f us late), timeouts %llu \r\n",
+           (unsigned long long)Timing.Waits, (unsigned long long)Timing.Sleeps, (unsigned long long)Timing.Misses,
+           Timing.WorstLate_ns * 1e-3, (unsigned long long)Timing.Timeouts);
+    ADS1263_RT_Report();
+    if(Capture) {
+        ADS1263_CAPTURE_STATS Rec;
+        ADS1263_Capture_Close(&Recorder);
+        ADS1263_Capture_GetStats(&Recorder, &Rec);
+        printf("Capture %llu frames in %llu chunks (%llu dropped), %llu bytes written, %llu write errors, %d buffers queued at most \r\n",
+               (unsigned long long)Rec.Frames, (unsigned long long)Rec.Chunks, (unsigned long long)Rec.Dropped,
+               (unsigned long long)Rec.Disk.Written, (unsigned long long)Rec.Disk.Errors, Rec.Disk.Queued);
+        Capture = 0;
+    }
+    if(Pyramid) {
+        ADS1263_PYRAMID_STATS Sum;
+        ADS1263_Pyramid_Close(&Summary);
+        ADS1263_Pyramid_GetStats(&Summary, &Sum);
+        printf("Pyramid %llu buckets in %llu pages (%llu dropped), %llu bytes written \r\n",
+               (unsigned long long)Sum.Buckets, (unsigned long long)Sum.Pages, (unsigned long long)Sum.Dropped,
+               (unsigned long long)Sum.Disk.Written);
+        Pyramid = 0;
+    }
+    if(Arrow) {
+        ADS1263_ARROW_STATS Rows;
+        ADS1263_Arrow_Close(&Table);
+        ADS1263_Arrow_GetStats(&Table, &Rows);
+        printf("Arrow %llu rows in %llu batches (%llu dropped), %llu bytes written \r\n",
+               (unsigned long long)Rows.Rows, (unsigned long long)Rows.Batches, (unsigned long long)Rows.Dropped,
+               (unsigned long long)Rows.Disk.Written);
+        Arrow = 0;
+    }
+    if(Publish) {
+        printf("Published %llu sweeps to %s \r\n", (unsigned long long)Ring.Next, Ring.Name);
+        ADS1263_Shm_Close(&Ring);
+        Publish = 0;
+    }
+    if(Latest) {
+        ADS1263_Latest_Close(&Newest);
+        Latest = 0;
+    }
+    if(Session.Running)
+        ADS1263_Session_Check(&Session);
+    ADS1263_Calib_Save(CALIB_FILE);
+    // Close every bus in use
+    for(chip=0; chip<Map.ChipCount; chip++) {
+        DEV_SPI_SelectBus(Map.Chip[chip].Bus);
+        DEV_Module_Exit(Map.Chip[chip].RST, Map.Chip[chip].CS);
+    }
+}
 
 void  Handler(int signo)
 {
+    // The acquisition loop stops itself so the capture is flushed cleanly
+    if(Streaming) {
+        Stop = 1;
+        return;
+    }
     //System Exit
     printf("\r\n END \r\n");
-    DEV_Module_Exit();
+    Exit();
     exit(0);
 }
 
 int main(void)
 {
-    UDOUBLE ADC[10];
-    UWORD i;
-    double RES, TEMP;
+    UWORD i, chip;
     
     // Exception handling:ctrl + c
     signal(SIGINT, Handler);
     
     printf("ADS1263 Demo \r\n");
-    DEV_Module_Init(18, 12, get_DRDYPIN(12));
-    DEV_Module_Init(18, 22, get_DRDYPIN(22));
-    DEV_Module_Init(18, 23, get_DRDYPIN(23));
+    if(ADS1263_Map_Load(&Map, CHANNEL_MAP) != 0) {
+        printf("Using built-in channel map \r\n");
+        ADS1263_Map_Parse(&Map, DefaultMap);
+    }
+    // Keep only the chips that answer; more boards just need probe lines
+    if(ADS1263_Map_Discover(&Map) != 0) {
+        printf("No ADS1263 found \r\n");
+        exit(1);
+    }
+    ADS1263_CAPTURE_CONFIG Disk;
+    ADS1263_PYRAMID_CONFIG Zoom;
+    ADS1263_ARROW_CONFIG Columns;
+    ADS1263_Capture_Defaults(&Disk);
+    ADS1263_Pyramid_Defaults(&Zoom);
+    ADS1263_Arrow_Defaults(&Columns);
+    size_t Reserve = (CAPTURE_FILE ? ADS1263_Capture_Reserve(&Disk) : 0) +
+                     (PYRAMID_FILE ? ADS1263_Pyramid_Reserve(&Zoom, &Map) : 0) +
+                     (ARROW_FILE ? ADS1263_Arrow_Reserve(&Columns, &Map) : 0);
+    if(ADS1263_Session_Open(&Session, Reserve, HUGE_PAGES) != 0 ||
+       ADS1263_Map_Compile(&Map, Session.Scan) != 0) {
+        exit(1);
+    }
+    ADS1263_SCAN *Scan = Session.Scan;
 
     // 0 is singleChannel, 1 is diffChannel
     ADS1263_SetMode(0);
     
     // The faster the rate, the worse the stability
     // and the need to choose a suitable digital filter(REG_MODE1)
-    //doing 3 times to set up the 3 ADCs
-    if(ADS1263_init_ADC1(ADS1263_38400SPS, 12) == 1) {
-        printf("\r\n END \r\n");
-        DEV_Module_Exit();
-        exit(0);
-    }
-    if(ADS1263_init_ADC1(ADS1263_38400SPS, 22) == 1) {
-        printf("\r\n END \r\n");
-        DEV_Module_Exit();
-        exit(0);
-    }
-    if(ADS1263_init_ADC1(ADS1263_38400SPS, 23) == 1) {
+    ADS1263_Calib_Load(CALIB_FILE);
+    if(ADS1263_Map_Init(&Map, CONFIG_HASH) != 0) {
         printf("\r\n END \r\n");
-        DEV_Module_Exit();
+        Exit();
         exit(0);
     }
     
+    // Only the first boot (or a new data rate) pays for calibration
+    if(ADS1263_Calib_Missing(Scan) > 0)
+        ADS1263_Calib_Save(CALIB_FILE);
+    ADS1263_Calib_SetInterval(RECAL_INTERVAL);
+    
     printf("TEST_ADC1\r\n");
     
-    #define ChannelNumber 10
-    UBYTE ChannelList[ChannelNumber] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9};    // The channel must be less than 10
+    for(chip=0; chip<Scan->ChipCount; chip++) {
+        ADS1263_SetRef(chip, REF);
+    }
+    UBYTE HavePower = (ADS1263_Detector_Load(DETECTOR_TABLE) == 0);
+    
+    // Bus threads run pinned at SCHED_FIFO with locked memory;
+    // this thread only prints, so it keeps off their CPUs
+    ADS1263_RT_CONFIG Rt = {RT_PRIORITY, {RT_CPU_BUS0, RT_CPU_BUS1}, 1};
+    ADS1263_RT_Init(&Rt);
+    
+    // Frames go to disk from the I/O threads; a slow card drops, never stalls
+    if(CAPTURE_FILE && ADS1263_Capture_Open(&Recorder, &Session, CAPTURE_FILE, &Map, &Disk) == 0)
+        Capture = 1;
+    if(PYRAMID_FILE && ADS1263_Pyramid_Open(&Summary, &Session, PYRAMID_FILE, &Map, &Zoom) == 0)
+        Pyramid = 1;
+    Columns.Values = HavePower ? ADS1263_ARROW_POWER : ADS1263_ARROW_VOLT;
+    if(ARROW_FILE && ADS1263_Arrow_Open(&Table, &Session, ARROW_FILE, &Map, &Columns) == 0)
+        Arrow = 1;
+    // Plotters and monitors read sweeps from shared memory, never from the ADCs
+    if(SHM_RING && ADS1263_Shm_Create(&Ring, SHM_RING, 0) == 0)
+        Publish = 1;
+    if(SHM_LATEST && ADS1263_Latest_Create(&Newest, SHM_LATEST, &Map) == 0)
+        Latest = 1;
+    
+    // One sweep over the whole stack lands in a single frame,
+    // each SPI bus is scanned by its own thread
+    if(ADS1263_Session_Start(&Session) != 0) {
+        Exit();
+        exit(1);
+    }
+    ADS1263_RT_EnterIo();
+    Streaming = 1;
+    while(!Stop) {
+        ADS1263_FRAME *Frame = ADS1263_MultiBus_Acquire(Session.MultiBus);
+        if(Frame == NULL)
+            break;
+        // Achieved per-channel rates, refreshed about once a second
+        if(Frame->Header.End_ns > Session.Rates->Time_ns + 1000000000ull)
+            ADS1263_Sched_Update(Scan, Session.Rates);
+        ADS1263_Frame_ToVolts(Frame);
+        if(HavePower)
+            ADS1263_Frame_ToPower(Frame);
+        if(Capture)
+            ADS1263_Capture_Append(&Recorder, Frame);
+        if(Pyramid)
+            ADS1263_Pyramid_Append(&Summary, Frame);
+        if(Arrow)
+            ADS1263_Arrow_Append(&Table, Frame);
+        if(Publish)
+            ADS1263_Shm_Publish(&Ring, Frame);
+        if(Latest)
+            ADS1263_Latest_Publish(&Newest, Frame);
         
-    UDOUBLE Value[ChannelNumber] = {0};
-    while(1) {
-        ADS1263_GetAll(ChannelList, Value, ChannelNumber, 12, get_DRDYPIN(12));  // Get ADC1 value
-        ADS1263_GetAll(ChannelList, Value, ChannelNumber, 22, get_DRDYPIN(22));  // Get ADC1 value
-        ADS1263_GetAll(ChannelList, Value, ChannelNumber, 23, get_DRDYPIN(23));  // Get ADC1 value
-        for(i=0; i<ChannelNumber; i++) {
-            if((Value[i]>>31) == 1)
-                printf("IN%d is -%lf \r\n", ChannelList[i], REF*2 - Value[i]/2147483648.0 * REF);      //7fffffff + 1
-            else
-                printf("IN%d is %lf \r\n", ChannelList[i], Value[i]/2147483647.0 * REF);       //7fffffff
+        for(chip=0; chip<Frame->Header.ChipCount; chip++) {
+            for(i=0; i<Frame->Count[chip]; i++) {
+                const char *Name = ADS1263_Map_Name(&Map, chip, i);
+                if(HavePower)
+                    printf("%s %-8s IN%d is %lf V %7.2f dBm %8.1f Hz \r\n", Map.Chip[chip].Name, Name, Frame->Channel[chip][i], Frame->Volt[chip][i], Frame->Power[chip][i], Session.Rates->Hz[chip][i]);
+                else
+                    printf("%s %-8s IN%d is %lf %8.1f Hz \r\n", Map.Chip[chip].Name, Name, Frame->Channel[chip][i], Frame->Volt[chip][i], Session.Rates->Hz[chip][i]);
+            }
         }
-        for(i=0; i<ChannelNumber; i++) {
-            printf("\33[1A");   // Move the cursor up
+        for(chip=0; chip<Frame->Header.ChipCount; chip++) {
+            for(i=0; i<Frame->Count[chip]; i++) {
+                printf("\33[1A");   // Move the cursor up
+            }
         }
+        ADS1263_MultiBus_Release(Session.MultiBus);
     }
+    Streaming = 0;
+    printf("\r\n END \r\n");
+    Exit();
     printf("TEST SUCCESSFUL!");
     return 0;
 }
@@ -33,6 +33,14 @@
 #define RPI
 #define USE_DEV_LIB
 
+/**
+ * spidev node of each SPI bus
+**/
+static char DEV_SPI_Device[DEV_HARDWARE_SPI_MAX_BUS][32] = {
+	"/dev/spidev0.0",
+	"/dev/spidev1.0",
+};
+
 /**
  * GPIO read and write
 **/
@@ -83,6 +91,33 @@ UBYTE DEV_SPI_ReadByte(void)
 	return DEV_SPI_WriteByte(0x00);
 }
 
+/******************************************************************************
+function:	Select the SPI bus used by the calling thread
+parameter:
+	Bus : 0 .. DEV_HARDWARE_SPI_MAX_BUS-1
+Info:
+	Every DEV_SPI_* call made afterwards by this thread goes to that bus.
+	Threads start on bus 0. Return 0 success, 1 failed
+******************************************************************************/
+UBYTE DEV_SPI_SelectBus(UBYTE Bus)
+{
+	return DEV_HARDWARE_SPI_SelectBus(Bus) < 0 ? 1 : 0;
+}
+
+/******************************************************************************
+function:	Set the spidev node a bus opens
+parameter:
+	Bus : Bus index
+	Device : e.g. "/dev/spidev1.0"
+Info:
+	Takes effect the next time the bus is opened by DEV_Module_Init
+******************************************************************************/
+void DEV_SPI_SetDevice(UBYTE Bus, const char *Device)
+{
+	if(Bus < DEV_HARDWARE_SPI_MAX_BUS)
+		snprintf(DEV_SPI_Device[Bus], sizeof(DEV_SPI_Device[Bus]), "%s", Device);
+}
+
 /**
  * GPIO Mode
 **/
@@ -118,32 +153,34 @@ void DEV_Delay_ms(UDOUBLE xms)
 #endif
 }
 
+/**
+ * Check /etc/issue once per process, later calls return the first result
+**/
 static int DEV_Equipment_Testing(void)
 {
+	static int Result = 1;		// 1 = not tested yet
 	int i;
 	int fd;
-	char value_str[20];
+	ssize_t len;
+	char value_str[64];
+
+	if(Result != 1)
+		return Result;
+	Result = -1;
 	fd = open("/etc/issue", O_RDONLY);
-	printf("%d\n", fd);
-    printf("Current environment: ");
-	while(1) {
-		if (fd < 0) {
-			Debug( "Read failed Pin\n");
-			return -1;
-		}
-		for(i=0;; i++) {
-			if (read(fd, &value_str[i], 1) < 0) {
-				Debug( "failed to read value!\n");
-				return -1;
-			}
-			if(value_str[i] ==32) {
-				printf("\r\n");
-				break;
-			}
-			printf("%c",value_str[i]);
-		}
-		break;
+	if (fd < 0) {
+		Debug( "Read failed Pin\n");
+		return -1;
+	}
+	len = read(fd, value_str, sizeof(value_str) - 1);
+	close(fd);
+	if (len < 0) {
+		Debug( "failed to read value!\n");
+		return -1;
 	}
+	value_str[len] = '\0';
+	i = strcspn(value_str, " \n");
+	printf("Current environment: %.*s\r\n", i, value_str);
 #ifdef RPI
 	if(i<5) {
 		printf("Unrecognizable\r\n");
@@ -157,6 +194,7 @@ static int DEV_Equipment_Testing(void)
 		}
 	}
 #endif
+	Result = 0;
 	return 0;
 }
 
@@ -174,20 +212,35 @@ void DEV_GPIO_Init(UWORD DEV_RST_PIN, UWORD DEV_CS_PIN, UWORD DEV_DRDY_PIN)
 function:	Module Initialize, the library and initialize the pins, SPI protocol
 parameter:
 Info:
+	Opens the spidev node of the calling thread's bus (see DEV_SPI_SelectBus).
+	The environment check, the GPIO chip and each bus are set up by the first
+	call only; later calls just claim the pins of one more ADC. Call from one
+	thread at a time
 ******************************************************************************/
 UBYTE DEV_Module_Init(UWORD DEV_RST_PIN, UWORD DEV_CS_PIN, UWORD DEV_DRDY_PIN)
 {
+	static UBYTE GPIO_Open = 0;
+
     printf("/***********************************/ \r\n");
 	if(DEV_Equipment_Testing() < 0) {
 		return 1;
 	}
 #ifdef RPI
 #ifdef USE_DEV_LIB
-	printf("Write and read /dev/spidev0.0 \r\n");
+	if(!GPIO_Open) {
+		if(SYSFS_GPIO_Init() < 0)
+			return 1;
+		GPIO_Open = 1;
+	}
 	DEV_GPIO_Init(DEV_RST_PIN, DEV_CS_PIN, DEV_DRDY_PIN);
-	DEV_HARDWARE_SPI_begin("/dev/spidev0.0");
-    DEV_HARDWARE_SPI_setSpeed(2000000);
-	DEV_HARDWARE_SPI_Mode(SPI_MODE_1);
+	// The bus is shared by every chip on it, open it only once
+	if(!DEV_HARDWARE_SPI_IsOpen()) {
+		char *Device = DEV_SPI_Device[DEV_HARDWARE_SPI_CurrentBus()];
+		printf("Write and read %s \r\n", Device);
+		DEV_HARDWARE_SPI_begin(Device);
+		DEV_HARDWARE_SPI_setSpeed(2000000);
+		DEV_HARDWARE_SPI_Mode(SPI_MODE_1);
+	}
 #endif
 #endif
     printf("/***********************************/ \r\n");
@@ -64,6 +64,8 @@ UBYTE DEV_Digital_Read(UWORD Pin);
 
 UBYTE DEV_SPI_WriteByte(UBYTE Value);
 UBYTE DEV_SPI_ReadByte(void);
+UBYTE DEV_SPI_SelectBus(UBYTE Bus);
+void DEV_SPI_SetDevice(UBYTE Bus, const char *Device);
 
 UBYTE DEV_Module_Init(UWORD DEV_RST_PIN, UWORD DEV_CS_PIN, UWORD DEV_DRDY_PIN);
 void DEV_Module_Exit(UWORD DEV_RST_PIN, UWORD DEV_CS_PIN);
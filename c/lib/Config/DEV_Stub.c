@@ -0,0 +1,178 @@
+/*****************************************************************************
+* | File        :   DEV_Stub.c
+* | Author      :   Highz team
+* | Function    :   Simulated ADS1263 bus for runs without hardware
+* | Info        :
+*----------------
+* | This version:   V1.0
+* | Date        :   2026-10-19
+* | Info        :
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documnetation files (the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to  whom the Software is
+# furished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included in
+# all copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS OR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+# THE SOFTWARE.
+#
+******************************************************************************/
+#include "DEV_Config.h"
+#include <time.h>
+
+/******************************************************************************
+Simulated bus
+
+Links in place of DEV_Config.c and the SPI/GPIO backends. Every chip select
+answers as an ADS1263 (ID 0x21) with a 32-byte register file: WREG and RREG
+work, a START1/START2 restarts the conversion timer, and DRDY reads HIGH
+until DEV_STUB_CONVERSION_NS has passed. Data reads (direct, RDATA1 and
+RDATA2) return a constant code with a valid status byte and checksum.
+State is per thread, like a bus owned by one MultiBus thread. Used by
+"make alloccheck"; good enough to run the scan, MultiBus and every consumer
+with realistic timing, not to test register logic.
+******************************************************************************/
+#define DEV_STUB_CONVERSION_NS  200000
+#define DEV_STUB_ID             0x21
+#define DEV_STUB_CODE           0x12345678
+
+typedef enum
+{
+    STUB_IDLE = 0,
+    STUB_WREG_COUNT,
+    STUB_WREG_DATA,
+    STUB_RREG_COUNT,
+    STUB_RREG_DATA,
+    STUB_DATA,
+    STUB_OTHER,
+} STUB_STATE;
+
+static __thread UBYTE Stub_Reg[32] = {DEV_STUB_ID};
+static __thread STUB_STATE Stub_State;
+static __thread UBYTE Stub_Addr, Stub_Left;
+static __thread uint64_t Stub_Start_ns;
+static __thread UBYTE Stub_Bus;
+static __thread UBYTE Stub_Packet[6], Stub_Pos;
+
+static uint64_t Stub_Now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+/* status, data bytes and checksum of one conversion result */
+static void Stub_Data(UBYTE Adc2)
+{
+    UDOUBLE code = Adc2 ? DEV_STUB_CODE >> 8 : DEV_STUB_CODE;
+    UBYTE sum = 0x9b, i, n = Adc2 ? 3 : 4;
+
+    Stub_Packet[0] = Adc2 ? 0xC0 : 0x40;    // ADC2 / ADC1 new data
+    for(i = 0; i < n; i++) {
+        Stub_Packet[1 + i] = (code >> (8 * (n - 1 - i))) & 0xff;
+        sum += Stub_Packet[1 + i];
+    }
+    if(Adc2)
+        Stub_Packet[4] = 0;                 // Pad byte
+    Stub_Packet[5] = sum;
+    Stub_Pos = 0;
+    Stub_State = STUB_DATA;
+}
+
+void DEV_Digital_Write(UWORD Pin, UBYTE Value)
+{
+    // Any chip select edge ends the command
+    Stub_State = STUB_IDLE;
+}
+
+UBYTE DEV_Digital_Read(UWORD Pin)
+{
+    return Stub_Now() < Stub_Start_ns + DEV_STUB_CONVERSION_NS;
+}
+
+UBYTE DEV_SPI_WriteByte(UBYTE Value)
+{
+    switch(Stub_State) {
+    case STUB_IDLE:
+        if((Value & 0xE0) == 0x40) {            // WREG
+            Stub_Addr = Value & 0x1f;
+            Stub_State = STUB_WREG_COUNT;
+        } else if((Value & 0xE0) == 0x20) {     // RREG
+            Stub_Addr = Value & 0x1f;
+            Stub_State = STUB_RREG_COUNT;
+        } else if((Value & 0xFE) == 0x08 || (Value & 0xFE) == 0x0C) {  // START1, START2
+            Stub_Start_ns = Stub_Now();
+        } else if((Value & 0xFE) == 0x12 || (Value & 0xFE) == 0x14) {  // RDATA1, RDATA2
+            Stub_Data(Value & 0x04);
+        } else {
+            Stub_State = STUB_OTHER;
+        }
+        break;
+    case STUB_WREG_COUNT:
+        Stub_Left = Value + 1;
+        Stub_State = STUB_WREG_DATA;
+        break;
+    case STUB_WREG_DATA:
+        if(Stub_Left > 0) {
+            Stub_Left--;
+            Stub_Reg[Stub_Addr++ & 31] = Value;
+        }
+        break;
+    case STUB_RREG_COUNT:
+        Stub_State = STUB_RREG_DATA;
+        break;
+    default:
+        break;
+    }
+    return 0;
+}
+
+UBYTE DEV_SPI_ReadByte(void)
+{
+    if(Stub_State == STUB_RREG_DATA)
+        return Stub_Reg[Stub_Addr++ & 31];
+    // Reading without a command: ADC1 data in direct mode
+    if(Stub_State != STUB_DATA)
+        Stub_Data(0);
+    return Stub_Packet[Stub_Pos++ % sizeof(Stub_Packet)];
+}
+
+UBYTE DEV_SPI_SelectBus(UBYTE Bus)
+{
+    if(Bus >= DEV_HARDWARE_SPI_MAX_BUS)
+        return 1;
+    Stub_Bus = Bus;
+    return 0;
+}
+
+void DEV_SPI_SetDevice(UBYTE Bus, const char *Device)
+{
+}
+
+uint8_t DEV_HARDWARE_SPI_CurrentBus(void)
+{
+    return Stub_Bus;
+}
+
+UBYTE DEV_Module_Init(UWORD DEV_RST_PIN, UWORD DEV_CS_PIN, UWORD DEV_DRDY_PIN)
+{
+    return 0;
+}
+
+void DEV_Module_Exit(UWORD DEV_RST_PIN, UWORD DEV_CS_PIN)
+{
+}
+
+void DEV_Delay_ms(UDOUBLE xms)
+{
+}
@@ -51,6 +51,7 @@
 //keep track of line handles in a global array
 static struct gpiod_chip *chip = NULL;
 static struct gpiod_line *lines[64] = {NULL};
+static signed char line_dir[64];    // direction each line was requested with
 
 //REWRITE USING LIBGPIOD
 
@@ -130,7 +131,14 @@ int SYSFS_GPIO_Release()
 
 int SYSFS_GPIO_Direction(int Pin, int Dir)
 {
-    if (!chip) return -1;
+    if (!chip || Pin < 0 || Pin >= 64) return -1;
+    
+    // Pins shared by several chips (RST) are requested once
+    if (lines[Pin]) {
+        if (line_dir[Pin] == Dir)
+            return 0;
+        gpiod_line_release(lines[Pin]);
+    }
     
     lines[Pin] = gpiod_chip_get_line(chip, Pin);
     if (!lines[Pin]) {
@@ -153,8 +161,10 @@ int SYSFS_GPIO_Direction(int Pin, int Dir)
     
     if (ret < 0) {
         printf("Request %s failed for pin %d\n", Dir == 0 ? "input" : "output", Pin);
+        lines[Pin] = NULL;
         return -1;
     }
+    line_dir[Pin] = Dir;
     printf("SUCCESSFULLY SET DIRECTION\n");
     
     return 0;
@@ -44,8 +44,6 @@
 #include <linux/types.h> 
 #include <linux/spi/spidev.h> 
 
-HARDWARE_SPI hardware_SPI;
-
 static uint8_t bits = 8; 
 
 #define SPI_CS_HIGH_1     0x04                //Chip select high  
@@ -55,7 +53,49 @@ static uint8_t bits = 8;
 #define SPI_NO_CS_1       0x40                //A single device occupies one SPI bus, so there is no chip select 
 #define SPI_READY_1       0x80                //Slave pull low to stop data transmission  
 
-struct spi_ioc_transfer tr;
+/**
+ * One instance per SPI bus. Each thread works on the bus it selected with
+ * DEV_HARDWARE_SPI_SelectBus (bus 0 by default), so bus workers can run
+ * concurrently without sharing a transfer descriptor.
+**/
+typedef struct {
+    HARDWARE_SPI spi;
+    struct spi_ioc_transfer tr;
+} SPI_BUS;
+
+// fd -1 = closed: a daemon that closed stdin may get fd 0 for a bus
+static SPI_BUS SPI_Bus[DEV_HARDWARE_SPI_MAX_BUS] = {[0 ... DEV_HARDWARE_SPI_MAX_BUS - 1] = {.spi = {.fd = -1}}};
+static __thread uint8_t SPI_Current = 0;
+
+/******************************************************************************
+function:   Select the SPI bus used by the calling thread
+parameter:
+    Bus :   Bus index, 0 .. DEV_HARDWARE_SPI_MAX_BUS-1
+Info:   Return 1 success
+        Return -1 failed
+******************************************************************************/
+int DEV_HARDWARE_SPI_SelectBus(uint8_t Bus)
+{
+    if(Bus >= DEV_HARDWARE_SPI_MAX_BUS)
+        return -1;
+    SPI_Current = Bus;
+    return 1;
+}
+
+uint8_t DEV_HARDWARE_SPI_CurrentBus(void)
+{
+    return SPI_Current;
+}
+
+/******************************************************************************
+function:   Whether the calling thread's bus has been opened
+parameter:
+Info:   Return 1 open, 0 closed
+******************************************************************************/
+int DEV_HARDWARE_SPI_IsOpen(void)
+{
+    return SPI_Bus[SPI_Current].spi.fd >= 0;
+}
 
 
 /******************************************************************************
@@ -68,27 +108,28 @@ Info:
 ******************************************************************************/
 void DEV_HARDWARE_SPI_begin(char *SPI_device)
 {
+    SPI_BUS *bus = &SPI_Bus[SPI_Current];
     //device
     int ret = 0; 
-    if((hardware_SPI.fd = open(SPI_device, O_RDWR )) < 0)  {
+    if((bus->spi.fd = open(SPI_device, O_RDWR )) < 0)  {
         perror("Failed to open SPI device.\n");  
         DEV_HARDWARE_SPI_Debug("Failed to open SPI device\r\n");
         exit(1); 
     } else {
         DEV_HARDWARE_SPI_Debug("open : %s\r\n", SPI_device);
     }
-    hardware_SPI.mode = 0;
+    bus->spi.mode = 0;
     
-    ret = ioctl(hardware_SPI.fd, SPI_IOC_WR_BITS_PER_WORD, &bits);
+    ret = ioctl(bus->spi.fd, SPI_IOC_WR_BITS_PER_WORD, &bits);
     if (ret == -1) {
         DEV_HARDWARE_SPI_Debug("can't set bits per word\r\n"); 
     }
  
-    ret = ioctl(hardware_SPI.fd, SPI_IOC_RD_BITS_PER_WORD, &bits);
+    ret = ioctl(bus->spi.fd, SPI_IOC_RD_BITS_PER_WORD, &bits);
     if (ret == -1) {
         DEV_HARDWARE_SPI_Debug("can't get bits per word\r\n"); 
     }
-    tr.bits_per_word = bits;
+    bus->tr.bits_per_word = bits;
     
     DEV_HARDWARE_SPI_Mode(SPI_MODE_0);
     DEV_HARDWARE_SPI_ChipSelect(SPI_CS_Mode_LOW);
@@ -99,21 +140,22 @@ void DEV_HARDWARE_SPI_begin(char *SPI_device)
 
 void DEV_HARDWARE_SPI_beginSet(char *SPI_device, SPIMode mode, uint32_t speed)
 {
+    SPI_BUS *bus = &SPI_Bus[SPI_Current];
     //device
     int ret = 0; 
-    hardware_SPI.mode = 0;
-    if((hardware_SPI.fd = open(SPI_device, O_RDWR )) < 0)  {
+    bus->spi.mode = 0;
+    if((bus->spi.fd = open(SPI_device, O_RDWR )) < 0)  {
         perror("Failed to open SPI device.\n");  
         exit(1); 
     } else {
         DEV_HARDWARE_SPI_Debug("open : %s\r\n", SPI_device);
     }
     
-    ret = ioctl(hardware_SPI.fd, SPI_IOC_WR_BITS_PER_WORD, &bits);
+    ret = ioctl(bus->spi.fd, SPI_IOC_WR_BITS_PER_WORD, &bits);
     if (ret == -1) 
         DEV_HARDWARE_SPI_Debug("can't set bits per word\r\n"); 
  
-    ret = ioctl(hardware_SPI.fd, SPI_IOC_RD_BITS_PER_WORD, &bits);
+    ret = ioctl(bus->spi.fd, SPI_IOC_RD_BITS_PER_WORD, &bits);
     if (ret == -1) 
         DEV_HARDWARE_SPI_Debug("can't get bits per word\r\n"); 
 
@@ -131,11 +173,13 @@ Info:
 ******************************************************************************/
 void DEV_HARDWARE_SPI_end(void)
 {
-    hardware_SPI.mode = 0;
-    if (close(hardware_SPI.fd) != 0){
+    SPI_BUS *bus = &SPI_Bus[SPI_Current];
+    bus->spi.mode = 0;
+    if (close(bus->spi.fd) != 0){
         DEV_HARDWARE_SPI_Debug("Failed to close SPI device\r\n");
         perror("Failed to close SPI device.\n");  
     }
+    bus->spi.fd = -1;
 }
 
 /******************************************************************************
@@ -146,25 +190,26 @@ Info:   Return 1 success
 ******************************************************************************/
 int DEV_HARDWARE_SPI_setSpeed(uint32_t speed)
 {
-    uint32_t speed1 = hardware_SPI.speed;
+    SPI_BUS *bus = &SPI_Bus[SPI_Current];
+    uint32_t speed1 = bus->spi.speed;
     
-    hardware_SPI.speed = speed;
+    bus->spi.speed = speed;
 
     //Write speed
-    if (ioctl(hardware_SPI.fd, SPI_IOC_WR_MAX_SPEED_HZ, &speed) == -1) {
+    if (ioctl(bus->spi.fd, SPI_IOC_WR_MAX_SPEED_HZ, &speed) == -1) {
         DEV_HARDWARE_SPI_Debug("can't set max speed hz\r\n"); 
-        hardware_SPI.speed = speed1;//Setting failure rate unchanged
+        bus->spi.speed = speed1;//Setting failure rate unchanged
         return -1;
     }
     
     //Read the speed of just writing
-    if (ioctl(hardware_SPI.fd, SPI_IOC_RD_MAX_SPEED_HZ, &speed) == -1) {
+    if (ioctl(bus->spi.fd, SPI_IOC_RD_MAX_SPEED_HZ, &speed) == -1) {
         DEV_HARDWARE_SPI_Debug("can't get max speed hz\r\n"); 
-        hardware_SPI.speed = speed1;//Setting failure rate unchanged
+        bus->spi.speed = speed1;//Setting failure rate unchanged
         return -1;
     }
-    hardware_SPI.speed = speed;
-    tr.speed_hz = hardware_SPI.speed;
+    bus->spi.speed = speed;
+    bus->tr.speed_hz = bus->spi.speed;
     return 1;
 }
 
@@ -183,11 +228,12 @@ Info:
 ******************************************************************************/
 int DEV_HARDWARE_SPI_Mode(SPIMode mode)
 {
-    hardware_SPI.mode &= 0xfC;//Clear low 2 digits
-    hardware_SPI.mode |= mode;//Setting mode
+    SPI_BUS *bus = &SPI_Bus[SPI_Current];
+    bus->spi.mode &= 0xfC;//Clear low 2 digits
+    bus->spi.mode |= mode;//Setting mode
     
     //Write device
-    if (ioctl(hardware_SPI.fd, SPI_IOC_WR_MODE, &hardware_SPI.mode) == -1) {
+    if (ioctl(bus->spi.fd, SPI_IOC_WR_MODE, &bus->spi.mode) == -1) {
         DEV_HARDWARE_SPI_Debug("can't set spi mode\r\n"); 
         return -1;
     }
@@ -207,13 +253,14 @@ Info:
 ******************************************************************************/
 int DEV_HARDWARE_SPI_CSEN(SPICSEN EN)
 {
+    SPI_BUS *bus = &SPI_Bus[SPI_Current];
     if(EN == ENABLE){
-        hardware_SPI.mode |= SPI_NO_CS_1;
+        bus->spi.mode |= SPI_NO_CS_1;
     }else {
-        hardware_SPI.mode &= ~SPI_NO_CS_1;
+        bus->spi.mode &= ~SPI_NO_CS_1;
     }
     //Write device
-    if (ioctl(hardware_SPI.fd, SPI_IOC_WR_MODE, &hardware_SPI.mode) == -1) {
+    if (ioctl(bus->spi.fd, SPI_IOC_WR_MODE, &bus->spi.mode) == -1) {
         DEV_HARDWARE_SPI_Debug("can't set spi CS EN\r\n"); 
         return -1;
     }
@@ -234,18 +281,19 @@ Info:
 ******************************************************************************/
 int DEV_HARDWARE_SPI_ChipSelect(SPIChipSelect CS_Mode)
 {
+    SPI_BUS *bus = &SPI_Bus[SPI_Current];
     if(CS_Mode == SPI_CS_Mode_HIGH){
-        hardware_SPI.mode |= SPI_CS_HIGH_1;
-        hardware_SPI.mode &= ~SPI_NO_CS_1;
+        bus->spi.mode |= SPI_CS_HIGH_1;
+        bus->spi.mode &= ~SPI_NO_CS_1;
         DEV_HARDWARE_SPI_Debug("CS HIGH \r\n");
     }else if(CS_Mode == SPI_CS_Mode_LOW){
-        hardware_SPI.mode &= ~SPI_CS_HIGH_1;
-        hardware_SPI.mode &= ~SPI_NO_CS_1;
+        bus->spi.mode &= ~SPI_CS_HIGH_1;
+        bus->spi.mode &= ~SPI_NO_CS_1;
     }else if(CS_Mode == SPI_CS_Mode_NONE){
-        hardware_SPI.mode |= SPI_NO_CS_1;
+        bus->spi.mode |= SPI_NO_CS_1;
     }
     
-    if (ioctl(hardware_SPI.fd, SPI_IOC_WR_MODE, &hardware_SPI.mode) == -1) {
+    if (ioctl(bus->spi.fd, SPI_IOC_WR_MODE, &bus->spi.mode) == -1) {
         DEV_HARDWARE_SPI_Debug("can't set spi mode\r\n"); 
         return -1;
     }
@@ -265,16 +313,17 @@ Info:
 ******************************************************************************/
 int DEV_HARDWARE_SPI_SetBitOrder(SPIBitOrder Order)
 {
+    SPI_BUS *bus = &SPI_Bus[SPI_Current];
     if(Order == SPI_BIT_ORDER_LSBFIRST){
-        hardware_SPI.mode |= SPI_LSB_FIRST_1;
+        bus->spi.mode |= SPI_LSB_FIRST_1;
         DEV_HARDWARE_SPI_Debug("SPI_LSB_FIRST\r\n");
     }else if(Order == SPI_BIT_ORDER_MSBFIRST){
-        hardware_SPI.mode &= ~SPI_LSB_FIRST_1;
+        bus->spi.mode &= ~SPI_LSB_FIRST_1;
         DEV_HARDWARE_SPI_Debug("SPI_MSB_FIRST\r\n");
     }
     
-    // DEV_HARDWARE_SPI_Debug("hardware_SPI.mode = 0x%02x\r\n", hardware_SPI.mode);
-    int fd = ioctl(hardware_SPI.fd, SPI_IOC_WR_MODE, &hardware_SPI.mode);
+    // DEV_HARDWARE_SPI_Debug("bus->spi.mode = 0x%02x\r\n", bus->spi.mode);
+    int fd = ioctl(bus->spi.fd, SPI_IOC_WR_MODE, &bus->spi.mode);
     DEV_HARDWARE_SPI_Debug("fd = %d\r\n",fd);
     if (fd == -1) {
         DEV_HARDWARE_SPI_Debug("can't set spi SPI_LSB_FIRST\r\n"); 
@@ -296,12 +345,13 @@ Info:
 ******************************************************************************/
 int DEV_HARDWARE_SPI_SetBusMode(BusMode mode)
 {
+    SPI_BUS *bus = &SPI_Bus[SPI_Current];
     if(mode == SPI_3WIRE_Mode){
-        hardware_SPI.mode |= SPI_3WIRE_1;
+        bus->spi.mode |= SPI_3WIRE_1;
     }else if(mode == SPI_4WIRE_Mode){
-        hardware_SPI.mode &= ~SPI_3WIRE_1;
+        bus->spi.mode &= ~SPI_3WIRE_1;
     }
-    if (ioctl(hardware_SPI.fd, SPI_IOC_WR_MODE, &hardware_SPI.mode) == -1) {
+    if (ioctl(bus->spi.fd, SPI_IOC_WR_MODE, &bus->spi.mode) == -1) {
         DEV_HARDWARE_SPI_Debug("can't set spi mode\r\n"); 
         return -1;
     }
@@ -317,8 +367,9 @@ Info:
 ******************************************************************************/
 void DEV_HARDWARE_SPI_SetDataInterval(uint16_t us)
 {
-    hardware_SPI.delay = us;
-    tr.delay_usecs  = hardware_SPI.delay;
+    SPI_BUS *bus = &SPI_Bus[SPI_Current];
+    bus->spi.delay = us;
+    bus->tr.delay_usecs  = bus->spi.delay;
 }
 
 /******************************************************************************
@@ -329,13 +380,14 @@ Info:
 ******************************************************************************/
 uint8_t DEV_HARDWARE_SPI_TransferByte(uint8_t buf)
 {
+    SPI_BUS *bus = &SPI_Bus[SPI_Current];
     uint8_t rbuf[1];
-    tr.len = 1;
-    tr.tx_buf =  (unsigned long)&buf;
-    tr.rx_buf =  (unsigned long)rbuf;
+    bus->tr.len = 1;
+    bus->tr.tx_buf =  (unsigned long)&buf;
+    bus->tr.rx_buf =  (unsigned long)rbuf;
     
     //ioctl Operation, transmission of data
-    if ( ioctl(hardware_SPI.fd, SPI_IOC_MESSAGE(1), &tr) < 1 )  
+    if ( ioctl(bus->spi.fd, SPI_IOC_MESSAGE(1), &bus->tr) < 1 )  
         DEV_HARDWARE_SPI_Debug("can't send spi message\r\n"); 
     return rbuf[0];
 }
@@ -347,12 +399,13 @@ Info: Return read data
 ******************************************************************************/
 int DEV_HARDWARE_SPI_Transfer(uint8_t *buf, uint32_t len)
 {
-    tr.len = len;
-    tr.tx_buf =  (unsigned long)buf;
-    tr.rx_buf =  (unsigned long)buf;
+    SPI_BUS *bus = &SPI_Bus[SPI_Current];
+    bus->tr.len = len;
+    bus->tr.tx_buf =  (unsigned long)buf;
+    bus->tr.rx_buf =  (unsigned long)buf;
     
     //ioctl Operation, transmission of data
-    if (ioctl(hardware_SPI.fd, SPI_IOC_MESSAGE(1), &tr)  < 1 ){  
+    if (ioctl(bus->spi.fd, SPI_IOC_MESSAGE(1), &bus->tr)  < 1 ){  
         DEV_HARDWARE_SPI_Debug("can't send spi message\r\n"); 
         return -1;
     }
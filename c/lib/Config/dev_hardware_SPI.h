@@ -100,6 +100,12 @@ typedef struct SPIStruct {
 
 
 
+#define DEV_HARDWARE_SPI_MAX_BUS    2   // spidev0.x and spidev1.x
+
+int DEV_HARDWARE_SPI_SelectBus(uint8_t Bus);
+uint8_t DEV_HARDWARE_SPI_CurrentBus(void);
+int DEV_HARDWARE_SPI_IsOpen(void);
+
 void DEV_HARDWARE_SPI_begin(char *SPI_device);
 void DEV_HARDWARE_SPI_beginSet(char *SPI_device, SPIMode mode, uint32_t speed);
 void DEV_HARDWARE_SPI_end(void);
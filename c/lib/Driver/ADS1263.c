@@ -29,7 +29,9 @@
 ******************************************************************************/
 #include <stdio.h>
 #include <stdlib.h>
+#include <errno.h>
 #include "ADS1263.h"
+#include "ADS1263_Timing.h"
 #include <time.h>
 
 /******************************************************************************
@@ -40,6 +42,28 @@ Info:
 ******************************************************************************/
 UBYTE ScanMode = 0;
 
+/******************************************************************************
+DRDY pins registered from the channel map, indexed by CS pin (0 = unset)
+******************************************************************************/
+#define ADS1263_MAX_PIN 64
+static UWORD DrdyPin[ADS1263_MAX_PIN] = {0};
+
+/******************************************************************************
+Data packets whose checksum did not match, counted by the bus threads
+******************************************************************************/
+static uint64_t CrcErrors = 0;
+
+uint64_t ADS1263_CrcErrors(void)
+{
+    return __atomic_load_n(&CrcErrors, __ATOMIC_RELAXED);
+}
+
+void ADS1263_SetDRDYPIN(UWORD DEV_CS_PIN, UWORD DEV_DRDY_PIN)
+{
+    if(DEV_CS_PIN < ADS1263_MAX_PIN)
+        DrdyPin[DEV_CS_PIN] = DEV_DRDY_PIN;
+}
+
 
 /******************************************************************************
 function:   Get DRDY pin for a given CS pin
@@ -53,9 +77,13 @@ Info:
     
     This mapping is specific to the Highz hardware modification where
     each stacked ADC has unique CS and DRDY pins for individual addressing.
+    Pairs registered with ADS1263_SetDRDYPIN (from the channel map) win.
 ******************************************************************************/
 int get_DRDYPIN(UWORD DEV_CS_PIN){
     UWORD drdyPin = 0;
+    if (DEV_CS_PIN < ADS1263_MAX_PIN && DrdyPin[DEV_CS_PIN] != 0){
+        return DrdyPin[DEV_CS_PIN];
+    }
     if (DEV_CS_PIN == 12){
         drdyPin = 16;        // ADC #1 (Top)
     }
@@ -87,71 +115,58 @@ Info:
     bit4=0: States 0-7 based on bit1, bit2, bit3 combinations
     bit4=1: State 9 if all bits are high, Error if any other combination
     
-    Returns: String buffer containing state number ('0'-'9'), or NULL on error
-    Note: Caller must free() the returned buffer
+    Truth table for 3-bit encoding (bit4=0):
+    bit1 | bit2 | bit3 | State
+    -----|------|------|------
+      0  |   0  |   0  |   0
+      0  |   0  |   1  |   4
+      0  |   1  |   0  |   2
+      0  |   1  |   1  |   6
+      1  |   0  |   0  |   1
+      1  |   0  |   1  |   5
+      1  |   1  |   0  |   3
+      1  |   1  |   1  |   7
+    
+    Returns: State number 0-9, or ADS1263_STATE_INVALID on error
 ******************************************************************************/
-char *READ_CALIBRATION_STATE(void)
+UBYTE ADS1263_ReadState(void)
 {
-    char *buf = malloc(64);
-    if (!buf) return NULL;
-    
     // Read the 4 state bits from GPIO pins
     int bit1 = DEV_Digital_Read(21);
     int bit2 = DEV_Digital_Read(20);
     int bit3 = DEV_Digital_Read(16);
     int bit4 = DEV_Digital_Read(12);
     
-    // Decode the state based on bit combinations
     // bit4 indicates special state or normal operation
     if (bit4) {
         // Special state: All bits high = State 9
-        if (bit1 && bit2 && bit3){
-            buf[0] = '9';
-            buf[1] = '\0';
-            return buf;
-        } else {
-            // Error: bit4 high but other bits don't match expected pattern
-            printf("Error: invalid state.\n");
-        }
-    } else {
-        // Normal states (0-7): Decode based on bit1, bit2, bit3
-        // Truth table for 3-bit encoding:
-        // bit1 | bit2 | bit3 | State
-        // -----|------|------|------
-        //   0  |   0  |   0  |   0
-        //   0  |   0  |   1  |   4
-        //   0  |   1  |   0  |   2
-        //   0  |   1  |   1  |   6
-        //   1  |   0  |   0  |   1
-        //   1  |   0  |   1  |   5
-        //   1  |   1  |   0  |   3
-        //   1  |   1  |   1  |   7
-        
-        if (bit1) {
-            if (bit2 && bit3) {
-                buf[0] = '7';    // 111 -> State 7
-            } else if (bit3) {
-                buf[0] = '5';    // 101 -> State 5
-            } else if (bit2) {
-                buf[0] = '3';    // 110 -> State 3
-            } else {
-                buf[0] = '1';    // 100 -> State 1
-            }
-        } else if (bit2) {
-            if (bit3) {
-                buf[0] = '6';    // 011 -> State 6
-            } else {
-                buf[0] = '2';    // 010 -> State 2
-            }
-        } else if (bit3) {
-            buf[0] = '4';        // 001 -> State 4
-        } else {
-            buf[0] = '0';        // 000 -> State 0
-        }
+        if (bit1 && bit2 && bit3)
+            return 9;
+        // Error: bit4 high but other bits don't match expected pattern
+        return ADS1263_STATE_INVALID;
     }
     
-    buf[1] = '\0';
-    return buf;
+    // Normal states (0-7): bit1 is the LSB, bit3 the MSB
+    return (bit1 ? 1 : 0) | (bit2 ? 2 : 0) | (bit3 ? 4 : 0);
+}
+
+/******************************************************************************
+function:   Read calibration/device state as a string
+parameter:
+Info:
+    Returns: Constant string with the state number ("0"-"9"), or NULL on error
+    Note: The string is static, do not free() it
+    See ADS1263_ReadState() for the encoding
+******************************************************************************/
+const char *READ_CALIBRATION_STATE(void)
+{
+    static const char StateName[10][2] = {"0", "1", "2", "3", "4", "5", "6", "7", "8", "9"};
+    UBYTE state = ADS1263_ReadState();
+    if (state == ADS1263_STATE_INVALID) {
+        printf("Error: invalid state.\n");
+        return NULL;
+    }
+    return StateName[state];
 }
 
 /******************************************************************************
@@ -184,7 +199,7 @@ Info:
     2. Write command byte
     3. De-assert CS (HIGH) to complete transaction
 ******************************************************************************/
-static void ADS1263_WriteCmd(UBYTE Cmd, UWORD DEV_CS_PIN)
+void ADS1263_WriteCmd(UBYTE Cmd, UWORD DEV_CS_PIN)
 {
     DEV_Digital_Write(DEV_CS_PIN, 0);    // Select ADC
     DEV_SPI_WriteByte(Cmd);
@@ -240,6 +255,51 @@ static UBYTE ADS1263_Read_data(UBYTE Reg, UWORD DEV_CS_PIN)
     return temp;
 }
 
+/******************************************************************************
+function:   Read consecutive registers
+parameter: 
+    Reg : First register address
+    Data: Receives the register values
+    Count: Number of registers
+    DEV_CS_PIN: Chip select pin for target ADC
+Info:
+    Same protocol as ADS1263_Read_data with n-1 = Count-1; the chip
+    auto-increments the address, so a full dump is one CS cycle
+******************************************************************************/
+void ADS1263_ReadRegs(UBYTE Reg, UBYTE *Data, UBYTE Count, UWORD DEV_CS_PIN)
+{
+    UBYTE i;
+    DEV_Digital_Write(DEV_CS_PIN, 0);
+    DEV_SPI_WriteByte(CMD_RREG | Reg);
+    DEV_SPI_WriteByte(Count - 1);
+    for(i = 0; i < Count; i++) {
+        Data[i] = DEV_SPI_ReadByte();
+    }
+    DEV_Digital_Write(DEV_CS_PIN, 1);
+}
+
+/******************************************************************************
+function:   Write consecutive registers
+parameter: 
+    Reg : First register address
+    Data: Register values
+    Count: Number of registers
+    DEV_CS_PIN: Chip select pin for target ADC
+Info:
+    Same protocol as ADS1263_WriteReg with n-1 = Count-1
+******************************************************************************/
+void ADS1263_WriteRegs(UBYTE Reg, const UBYTE *Data, UBYTE Count, UWORD DEV_CS_PIN)
+{
+    UBYTE i;
+    DEV_Digital_Write(DEV_CS_PIN, 0);
+    DEV_SPI_WriteByte(CMD_WREG | Reg);
+    DEV_SPI_WriteByte(Count - 1);
+    for(i = 0; i < Count; i++) {
+        DEV_SPI_WriteByte(Data[i]);
+    }
+    DEV_Digital_Write(DEV_CS_PIN, 1);
+}
+
 /******************************************************************************
 function:   Check data CRC checksum
 parameter: 
@@ -272,34 +332,96 @@ static UBYTE ADS1263_Checksum(UDOUBLE val, UBYTE byt)
 }
 
 /******************************************************************************
-function:   Waiting for a busy end
+function:   Poll DRDY until LOW or a deadline
 parameter: 
     DEV_DRDY_PIN: Data Ready pin for the ADC being polled
+    Timeout_ns: CLOCK_MONOTONIC time to give up at
+    Edge_ns: Receives the time DRDY was first seen LOW
+    First: Set when DRDY was already LOW at the first read
 Info:
-    Timeout indicates that the operation is not working properly.
-    
     DRDY Signal Behavior:
     - Goes LOW when new ADC data is available
     - Remains HIGH during conversion
     
-    This function polls the DRDY pin until it goes LOW, indicating
-    that a conversion is complete and data is ready to be read.
+    Returns 0 when data is ready, 1 on timeout
+******************************************************************************/
+static UBYTE ADS1263_PollDRDY(UWORD DEV_DRDY_PIN, uint64_t Timeout_ns, uint64_t *Edge_ns, UBYTE *First)
+{
+    *First = 1;
+    while(DEV_Digital_Read(DEV_DRDY_PIN) == 1) {
+        *First = 0;
+        if(ADS1263_Clock_ns(CLOCK_MONOTONIC) > Timeout_ns)
+            return 1;
+    }
+    *Edge_ns = ADS1263_Clock_ns(CLOCK_MONOTONIC);
+    return 0;
+}
+
+/******************************************************************************
+function:   Waiting for a busy end
+parameter: 
+    DEV_DRDY_PIN: Data Ready pin for the ADC being polled
+Info:
+    For conversions whose settings are not known (probing, single reads).
+    Timeout indicates that the operation is not working properly:
+    ADS1263_TIMING_MAX_NS covers the slowest rate and filter
     
-    Timeout: 4,000,000 iterations maximum
-    Prevents infinite loop if ADC fails or is misconfigured
+    Returns 0 when data is ready, 1 on timeout
 ******************************************************************************/
-static void ADS1263_WaitDRDY(UWORD DEV_DRDY_PIN)
+static UBYTE ADS1263_WaitDRDY(UWORD DEV_DRDY_PIN)
 {   
-    UDOUBLE i = 0;
+    uint64_t edge;
+    UBYTE first;
     
-    // Poll DRDY pin until LOW (data ready) or timeout
-    while (DEV_Digital_Read(DEV_DRDY_PIN) == 1 && i < 4000000) { 
-        i++; 
+    if(ADS1263_PollDRDY(DEV_DRDY_PIN, ADS1263_Clock_ns(CLOCK_MONOTONIC) + ADS1263_TIMING_MAX_NS, &edge, &first) != 0) {
+        printf("TIMED OUT! DRDY never went LOW for pin %d\n", DEV_DRDY_PIN);
+        return 1;
     }
+    return 0;
+}
+
+/******************************************************************************
+function:   Wait for a scan conversion against its predicted deadline
+parameter: 
+    sc: Scan table chip
+    e: Entry being converted
+    Start_ns: CLOCK_MONOTONIC time of START1
+Info:
+    Sleeps until shortly before the predicted DRDY edge, then polls (see
+    ADS1263_Timing.h). The edge time is fed back into the chip's model
+    Returns ADS1263_SAMPLE_OK, _LATE or _TIMEOUT
+******************************************************************************/
+static UBYTE ADS1263_WaitScan(const ADS1263_SCAN_CHIP *sc, const ADS1263_SCAN_ENTRY *e, uint64_t Start_ns)
+{
+    uint64_t expect = ADS1263_Timing_Predict(sc->CS, e->MODE0, e->MODE1, e->MODE2);
+    uint64_t due = Start_ns + expect, edge, late = 0, wake_late = 0;
+    int64_t error;
+    UBYTE slept = 0, first;
     
-    if (i >= 4000000) {
-        printf("TIMED OUT! DRDY never went LOW for pin %d\n", DEV_DRDY_PIN);
+    if(expect >= ADS1263_TIMING_SLEEP_NS) {
+        uint64_t wake = due - ADS1263_TIMING_GUARD_NS;
+        struct timespec ts = {(time_t)(wake / 1000000000ull), (long)(wake % 1000000000ull)};
+        while(clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) == EINTR)
+            ;
+        slept = 1;
+        // Scheduling latency of the data path
+        edge = ADS1263_Clock_ns(CLOCK_MONOTONIC);
+        wake_late = edge > wake ? edge - wake : 0;
     }
+    if(ADS1263_PollDRDY(sc->DRDY, due + 3 * expect + ADS1263_TIMING_SLACK_NS, &edge, &first) != 0) {
+        // Counted and flagged only: this is the bus thread
+        ADS1263_Timing_Count(slept, wake_late, 0, 1);
+        return ADS1263_SAMPLE_TIMEOUT;
+    }
+    
+    // Seen going LOW: the edge time is exact. Already LOW: it is an upper bound
+    error = (int64_t)(edge - due);
+    if(!first || error < 0)
+        ADS1263_Timing_Observe(sc->CS, e->MODE2, error);
+    if(!first && edge > due + expect / 8)
+        late = edge - due;
+    ADS1263_Timing_Count(slept, wake_late, late, 0);
+    return late ? ADS1263_SAMPLE_LATE : ADS1263_SAMPLE_OK;
 }
 
 /******************************************************************************
@@ -324,6 +446,79 @@ UBYTE ADS1263_ReadChipID(UWORD DEV_CS_PIN)
     return id>>5;
 }
 
+/******************************************************************************
+function:  Probe candidate chips
+parameter: 
+    Candidate: CS/DRDY/RST pins to try
+    Number: Number of candidates
+    Found: Chips that answered
+Info:
+    A candidate counts as present when:
+    1. REG_ID reports device ID 1 (an open MISO line reads 0x00 or 0xFF)
+    2. DRDY goes LOW after START1, which confirms the CS/DRDY pairing
+    
+    Conversions are stopped again before moving on, so a probed chip is
+    left idle for ADS1263_init_ADC1
+******************************************************************************/
+UBYTE ADS1263_Probe(const ADS1263_DEVICE *Candidate, UBYTE Number, ADS1263_DEVICE *Found)
+{
+    UBYTE PerBus[ADS1263_MAX_BUSES] = {0};
+    UBYTE i, n = 0;
+    
+    for(i = 0; i < Number && n < ADS1263_MAX_CHIPS; i++) {
+        ADS1263_DEVICE dev = Candidate[i];
+        
+        if(dev.Bus >= ADS1263_MAX_BUSES || PerBus[dev.Bus] >= ADS1263_MAX_CHIPS_PER_BUS)
+            continue;
+        if(DEV_SPI_SelectBus(dev.Bus) != 0 || DEV_Module_Init(dev.RST, dev.CS, dev.DRDY) != 0)
+            continue;
+        dev.Id = ADS1263_Read_data(REG_ID, dev.CS);
+        if((dev.Id >> 5) != 1) {
+            printf("CS %d: no ADS1263 (ID 0x%02x) \r\n", dev.CS, dev.Id);
+            continue;
+        }
+        
+        ADS1263_WriteCmd(CMD_START1, dev.CS);
+        if(ADS1263_WaitDRDY(dev.DRDY) != 0) {
+            printf("CS %d: ADS1263 answers but DRDY %d never went LOW \r\n", dev.CS, dev.DRDY);
+            ADS1263_WriteCmd(CMD_STOP1, dev.CS);
+            continue;
+        }
+        ADS1263_WriteCmd(CMD_STOP1, dev.CS);
+        
+        printf("Bus %d CS %d / DRDY %d: ADS1263 rev %d \r\n", dev.Bus, dev.CS, dev.DRDY, dev.Id & 0x1f);
+        ADS1263_SetDRDYPIN(dev.CS, dev.DRDY);
+        PerBus[dev.Bus]++;
+        Found[n++] = dev;
+    }
+    return n;
+}
+
+static const double RateHz[16] = {
+    2.5, 5, 10, 16.6, 20, 50, 60, 100, 400, 1200, 2400, 4800, 7200, 14400, 19200, 38400,
+};
+
+static const double DelaySeconds[16] = {
+    0, 8.7e-6, 17e-6, 35e-6, 69e-6, 139e-6, 278e-6, 555e-6, 1.1e-3, 2.2e-3, 4.4e-3, 8.8e-3,
+};
+
+double ADS1263_RateHz(UBYTE Rate)
+{
+    return RateHz[Rate & 0x0f];
+}
+
+double ADS1263_DelaySeconds(UBYTE Delay)
+{
+    return DelaySeconds[Delay & 0x0f];
+}
+
+static const double ADC2_RateHz[4] = {10, 100, 400, 800};
+
+double ADS1263_ADC2_RateHz(UBYTE Rate)
+{
+    return ADC2_RateHz[Rate & 0x03];
+}
+
 /******************************************************************************
 function:  Setting mode
 parameter: 
@@ -357,8 +552,9 @@ parameter:
 Info:
     Register Configuration:
     
-    MODE2 (0x8A):
+    MODE2 (0x80 | gain << 4 | drate):
     - Bit 7=1: PGA bypassed (no gain amplification)
+    - Bits [6:4]: PGA gain, Bits [3:0]: data rate
     - For Highz: Direct voltage measurement, no gain needed
     
     REFMUX (0x24):
@@ -371,8 +567,8 @@ Info:
     - 35µs default for Highz (balances speed vs. accuracy)
     
     MODE1:
-    - Sets digital filter and data rate
-    - Filter options: Sinc1, Sinc2, Sinc3, Sinc4, FIR
+    - Bits [7:5]: digital filter (see ADS1263_FILTER)
+    - Bits [4:0]: sensor bias, left off
     - 0x00 = Sinc1 filter (fastest, used in Highz)
     
     Each register write is verified by reading back
@@ -380,8 +576,9 @@ Info:
 void ADS1263_ConfigADC1(ADS1263_GAIN gain, ADS1263_DRATE drate, ADS1263_DELAY delay, UWORD DEV_CS_PIN)
 {
     // MODE2: PGA Configuration
-    UBYTE MODE2 = 0x8A;    // 0x80=PGA bypassed, 0x00=PGA enabled
+    UBYTE MODE2 = 0x80;    // 0x80=PGA bypassed, 0x00=PGA enabled
                            // Highz uses bypassed mode for direct voltage reading
+    MODE2 |= (gain << 4) | drate;
     ADS1263_WriteReg(REG_MODE2, MODE2, DEV_CS_PIN);
     DEV_Delay_ms(5);    // Set to 5 ms to ensure write completes instead of 1 ms
     if(ADS1263_Read_data(REG_MODE2, DEV_CS_PIN) == MODE2)
@@ -408,10 +605,10 @@ void ADS1263_ConfigADC1(ADS1263_GAIN gain, ADS1263_DRATE drate, ADS1263_DELAY de
     else
         printf("REG_MODE0 unsuccess \r\n");
     
-    // MODE1: Digital Filter and Data Rate
-    UBYTE MODE1 = 0x00 | drate;  // Filter: 0x84=FIR, 0x64=Sinc4, 0x44=Sinc3, 
-                                  //         0x24=Sinc2, 0x04=Sinc1, 0x00=Sinc1
-                                  // Highz uses 0x00 (Sinc1) for fastest response
+    // MODE1: Digital Filter (the data rate lives in MODE2)
+    UBYTE MODE1 = ADS1263_FILTER_SINC1;  // Filter: 0x80=FIR, 0x60=Sinc4, 0x40=Sinc3,
+                                          //         0x20=Sinc2, 0x00=Sinc1
+                                          // Highz uses Sinc1 for fastest response
     ADS1263_WriteReg(REG_MODE1, MODE1, DEV_CS_PIN); 
     DEV_Delay_ms(5);
     if(ADS1263_Read_data(REG_MODE1, DEV_CS_PIN) == MODE1)
@@ -507,7 +704,7 @@ static void ADS1263_SetChannal(UBYTE Channal, UWORD DEV_CS_PIN)
 function:  Read ADC data
 parameter: 
     DEV_CS_PIN: Chip select pin for target ADC
-    DEV_DRDY_PIN: Data ready pin for target ADC (used for retry)
+    Flags: Receives ADS1263_SAMPLE_CRC if the checksum did not match
 Info:
     Data Format (6 bytes total):
     - Byte 0: Status register
@@ -523,18 +720,17 @@ Info:
     6. Verify CRC checksum
     
     Error Handling:
-    - If CRC fails, can retry up to 50 times
-    - Returns 0xFFFFFFFF if all retries fail
-    - Indicates possible SPI communication issue
+    - A CRC mismatch flags the sample and counts it (ADS1263_CrcErrors);
+      the value is returned as read. Runs on the bus threads, so it
+      neither prints nor waits for another conversion
     
     Must wait for DRDY LOW before calling this function
 ******************************************************************************/
-static UDOUBLE ADS1263_Read_ADC1_Data(UWORD DEV_CS_PIN, UWORD DEV_DRDY_PIN)
+static UDOUBLE ADS1263_Read_ADC1_Data(UWORD DEV_CS_PIN, UBYTE *Flags)
 {
     UDOUBLE read = 0;
     UBYTE buf[4] = {0, 0, 0, 0};
     UBYTE Status, CRC;
-    int retry_count = 0;
 
     // Begin SPI transaction
     DEV_Digital_Write(DEV_CS_PIN, 0);
@@ -558,18 +754,10 @@ static UDOUBLE ADS1263_Read_ADC1_Data(UWORD DEV_CS_PIN, UWORD DEV_DRDY_PIN)
 
     // Verify data integrity with CRC
     if (ADS1263_Checksum(read, CRC) != 0) {
-        printf("⚠️  CRC error on ADC read. Retrying...\n");
-
-        retry_count++;
-        if (retry_count < 50) {
-            ADS1263_WaitDRDY(DEV_DRDY_PIN);      // Wait for next conversion
-            // Could recursively retry here, but current code just reports error
-        } else {
-            printf("❌ CRC failed %d times — returning error value\n", retry_count);
-            return 0xFFFFFFFF;       // Error indicator
-        }
+        *Flags |= ADS1263_SAMPLE_CRC;
+        __atomic_fetch_add(&CrcErrors, 1, __ATOMIC_RELAXED);
     }
-    
+
     return read;
     /*
     UDOUBLE read = 0;
@@ -600,62 +788,244 @@ static UDOUBLE ADS1263_Read_ADC1_Data(UWORD DEV_CS_PIN, UWORD DEV_DRDY_PIN)
 }
 
 /******************************************************************************
-function:  Read ADC specified channel data
-parameter: 
+function:  Read ADC specified channel data and its sample status
+parameter:
     Channel : Channel number to read (0-10)
     DEV_CS_PIN : GPIO pin used for SPI chip select (CS)
     DEV_DRDY_PIN: GPIO pin used for Data Ready (DRDY) signal
+    Flags: Receives the ADS1263_SAMPLE_* flags for this reading
 Info:
     Returns raw ADC value from the specified channel
-    
-    - Uses SPI to communicate with the ADC chip
-    - CS pin set LOW to select the ADC chip during SPI communication, HIGH to deselect
-    - DRDY goes LOW when new ADC data is available
-    - Waits for DRDY signal before reading data to ensure conversion is complete
 ******************************************************************************/
-UDOUBLE ADS1263_GetChannalValue(UBYTE Channel, UWORD DEV_CS_PIN, UWORD DEV_DRDY_PIN)
+static UDOUBLE ADS1263_ReadChannel(UBYTE Channel, UWORD DEV_CS_PIN, UWORD DEV_DRDY_PIN, UBYTE *Flags)
 {
     ADS1263_WriteCmd(CMD_STOP1, DEV_CS_PIN);
     UDOUBLE Value = 0;
+    *Flags = ADS1263_SAMPLE_OK;
     if(ScanMode == 0) {// 0  Single-ended input  10 channel1 Differential input  5 channe 
         if(Channel>10) {
             return 0;
         }
         ADS1263_SetChannal(Channel, DEV_CS_PIN);
         ADS1263_WriteCmd(CMD_START1, DEV_CS_PIN);
-        ADS1263_WaitDRDY(DEV_DRDY_PIN);
-        Value = ADS1263_Read_ADC1_Data(DEV_CS_PIN, DEV_DRDY_PIN);
+        if(ADS1263_WaitDRDY(DEV_DRDY_PIN) != 0)
+            *Flags |= ADS1263_SAMPLE_TIMEOUT;
+        Value = ADS1263_Read_ADC1_Data(DEV_CS_PIN, Flags);
     }
     return Value;
+}
 
+/******************************************************************************
+function:  Read ADC specified channel data
+parameter:
+    Channel : Channel number to read (0-10)
+    DEV_CS_PIN : GPIO pin used for SPI chip select (CS)
+    DEV_DRDY_PIN: GPIO pin used for Data Ready (DRDY) signal
+Info:
+    Returns raw ADC value from the specified channel
+    
+    - Uses SPI to communicate with the ADC chip
+    - CS pin set LOW to select the ADC chip during SPI communication, HIGH to deselect
+    - DRDY goes LOW when new ADC data is available
+    - Waits for DRDY signal before reading data to ensure conversion is complete
+******************************************************************************/
+UDOUBLE ADS1263_GetChannalValue(UBYTE Channel, UWORD DEV_CS_PIN, UWORD DEV_DRDY_PIN)
+{
+    UBYTE Flags;
+    return ADS1263_ReadChannel(Channel, DEV_CS_PIN, DEV_DRDY_PIN, &Flags);
 }
 
 /******************************************************************************
-function:  Read data from all channels
-parameter: 
+function:  Read data from all channels into a sweep frame
+parameter:
     List : Array of channel numbers to read
-    Value : Array to store ADC readings (must be pre-allocated)
-    Number : Number of channels to read
+    Number : Number of channels to read (at most ADS1263_FRAME_STRIDE)
+    Chip : Row of the frame this ADC fills
+    Frame : Sweep frame opened with ADS1263_Frame_Begin
     DEV_CS_PIN : Chip select pin for target ADC
     DEV_DRDY_PIN: Data ready pin for target ADC
 Info:
     Reads multiple channels sequentially from the specified ADC
     Used for reading log detectors on each ADC in Highz spectrometer
     
-    Optional voltage conversion code is commented out but available
-    Execution time measurement code is commented out
+    Codes, input numbers and sample flags are written straight into the
+    chip's row of the frame; the row start time goes to ChipTime_ns
 ******************************************************************************/
-void ADS1263_GetAll(UBYTE *List, UDOUBLE *Value, int Number, UWORD DEV_CS_PIN, UWORD DEV_DRDY_PIN)
+void ADS1263_GetAll(UBYTE *List, int Number, UBYTE Chip, ADS1263_FRAME *Frame, UWORD DEV_CS_PIN, UWORD DEV_DRDY_PIN)
 {
+    if(Chip >= ADS1263_MAX_CHIPS) {
+        return;
+    }
+    if(Number > ADS1263_FRAME_STRIDE) {
+        Number = ADS1263_FRAME_STRIDE;
+    }
+    
+    Frame->ChipTime_ns[Chip] = ADS1263_Clock_ns(CLOCK_MONOTONIC);
+    for(int i = 0; i<Number; i++) {
+        Frame->Channel[Chip][i] = List[i];
+        Frame->Code[Chip][i] = ADS1263_ReadChannel(List[i], DEV_CS_PIN, DEV_DRDY_PIN, &Frame->Status[Chip][i]);
+    }
+    Frame->Count[Chip] = Number;
+}
+
+/******************************************************************************
+function:   Service ADC2 once during a chip visit
+parameter:
+    sc: Scan table chip
+    Chip: Frame row
+    Frame: Sweep frame being filled
+Info:
+    Never waits: one RDATA2 read, plus an ADC2MUX write when a result came
+    in and there is more than one aux input. A result overdue by more than
+    four conversion periods is flagged TIMEOUT and ADC2 is set up again
+******************************************************************************/
+static void ADS1263_ScanAux(ADS1263_SCAN_CHIP *sc, UBYTE Chip, ADS1263_FRAME *Frame)
+{
+    ADS1263_SCAN_ENTRY *e;
+    UBYTE slot, i, buf[5], Status;
+    UDOUBLE read;
+    uint64_t now, timeout;
+
+    if(sc->AuxCount == 0)
+        return;
+
+    for(i = 0; i < sc->AuxCount; i++) {
+        slot = sc->Count + i;
+        Frame->Channel[Chip][slot] = sc->Aux[i].Input;
+        Frame->Code[Chip][slot] = sc->Aux[i].Last;
+        Frame->Status[Chip][slot] = sc->Aux[i].LastFlags | ADS1263_SAMPLE_STALE;
+    }
+
+    now = ADS1263_Clock_ns(CLOCK_MONOTONIC);
+    e = &sc->Aux[sc->AuxNext];
+    if(!sc->AuxRun) {
+        // ADC2CFG and ADC2MUX are adjacent
+        UBYTE regs[2] = {sc->ADC2CFG, e->INPMUX};
+        ADS1263_WriteRegs(REG_ADC2CFG, regs, 2, sc->CS);
+        ADS1263_WriteCmd(CMD_START2, sc->CS);
+        sc->AuxRun = 1;
+        sc->AuxTime_ns = now;
+        return;
+    }
+
+    DEV_Digital_Write(sc->CS, 0);
+    DEV_SPI_WriteByte(CMD_RDATA2);
+    Status = DEV_SPI_ReadByte();
+    for(i = 0; i < 5; i++)
+        buf[i] = DEV_SPI_ReadByte();    // 3 data bytes, pad, CRC
+    DEV_Digital_Write(sc->CS, 1);
+
+    if(Status & 0x80) {                 // ADC2 new data
+        read = ((UDOUBLE)buf[0] << 16) | ((UDOUBLE)buf[1] << 8) | buf[2];
+        e->Last = read << 8;            // ADC1 full scale
+        e->LastFlags = ADS1263_SAMPLE_OK;
+        if(ADS1263_Checksum(read, buf[4]) != 0) {
+            e->LastFlags = ADS1263_SAMPLE_CRC;
+            __atomic_fetch_add(&CrcErrors, 1, __ATOMIC_RELAXED);
+        }
+        __atomic_store_n(&e->Samples, e->Samples + 1, __ATOMIC_RELAXED);
+    } else {
+        timeout = (uint64_t)(4e9 / ADS1263_ADC2_RateHz(sc->ADC2CFG >> 6));
+        if(now - sc->AuxTime_ns < timeout)
+            return;
+        e->LastFlags = ADS1263_SAMPLE_TIMEOUT;
+        sc->AuxRun = 0;
+    }
+    slot = sc->Count + sc->AuxNext;
+    Frame->Code[Chip][slot] = e->Last;
+    Frame->Status[Chip][slot] = e->LastFlags;
+
+    // Writing ADC2MUX restarts the ADC2 conversion on the next input
+    sc->AuxNext = (sc->AuxNext + 1) % sc->AuxCount;
+    if(sc->AuxRun && sc->AuxCount > 1) {
+        ADS1263_WriteRegs(REG_ADC2MUX, &sc->Aux[sc->AuxNext].INPMUX, 1, sc->CS);
+        ADS1263_WriteCmd(CMD_START2, sc->CS);
+    }
+    sc->AuxTime_ns = now;
+}
+
+/******************************************************************************
+function:  Run one chip of a scan table
+parameter:
+    Scan : Compiled scan table
+    Chip : Chip index within the table (and frame row)
+    Frame : Sweep frame opened with ADS1263_Frame_Begin
+Info:
+    Per entry: STOP1, only the registers that change, START1, wait, read.
+    INPMUX is not read back here; a bad transfer shows up as a CRC flag
+    on the conversion result instead of costing an extra transaction on
+    every sample.
+******************************************************************************/
+void ADS1263_ScanChip(ADS1263_SCAN *Scan, UBYTE Chip, ADS1263_FRAME *Frame)
+{
+    ADS1263_SCAN_CHIP *sc = &Scan->Chip[Chip];
+    uint64_t start;
+    UBYTE i, aux = 0;
     
-    clock_t start_time, end_time;
-    double cpu_time_used;
-    UWORD REF = 3.27;
+    if(Chip >= ADS1263_MAX_CHIPS) {
+        return;
+    }
     
-    start_time = clock();
-    for(int i = 0; i<Number; i++) {Value[i] = ADS1263_GetChannalValue(List[i], DEV_CS_PIN, DEV_DRDY_PIN);}
-    end_time = clock();
+    DEV_SPI_SelectBus(sc->Bus);
+    Frame->ChipTime_ns[Chip] = ADS1263_Clock_ns(CLOCK_MONOTONIC);
+    for(i = 0; i < sc->Count; i++) {
+        ADS1263_SCAN_ENTRY *e = &sc->Entry[i];
+        UBYTE *Flags = &Frame->Status[Chip][i];
+        UBYTE first;
+        
+        Frame->Channel[Chip][i] = e->Input;
+        if(e->Divider > 1 && ((Frame->Header.Sequence + e->Phase) & (e->Divider - 1)) != 0) {
+            Frame->Code[Chip][i] = e->Last;
+            *Flags = e->LastFlags | ADS1263_SAMPLE_STALE;
+            continue;
+        }
+        
+        // MODE0..INPMUX burst starting at the first register that changes
+        if(e->MODE0 != sc->CurMODE0)
+            first = REG_MODE0;
+        else if(e->MODE1 != sc->CurMODE1)
+            first = REG_MODE1;
+        else if(e->MODE2 != sc->CurMODE2)
+            first = REG_MODE2;
+        else
+            first = REG_INPMUX;
         
-    cpu_time_used = ((double) (end_time-start_time)) / CLOCKS_PER_SEC;
-    //printf("Execution time: %f seconds\n", cpu_time_used);
+        ADS1263_WriteCmd(CMD_STOP1, sc->CS);
+        ADS1263_WriteRegs(first, &e->MODE0 + (first - REG_MODE0), REG_INPMUX - first + 1, sc->CS);
+        sc->CurMODE0 = e->MODE0;
+        sc->CurMODE1 = e->MODE1;
+        sc->CurMODE2 = e->MODE2;
+        ADS1263_WriteCmd(CMD_START1, sc->CS);
+        start = ADS1263_Clock_ns(CLOCK_MONOTONIC);
+        if(!aux) {
+            // ADC2 is serviced while ADC1 converts
+            ADS1263_ScanAux(sc, Chip, Frame);
+            aux = 1;
+        }
+        
+        *Flags = ADS1263_WaitScan(sc, e, start);
+        Frame->Code[Chip][i] = ADS1263_Read_ADC1_Data(sc->CS, Flags);
+        e->Last = Frame->Code[Chip][i];
+        e->LastFlags = *Flags;
+        __atomic_store_n(&e->Samples, e->Samples + 1, __ATOMIC_RELAXED);
+    }
+    if(!aux)
+        ADS1263_ScanAux(sc, Chip, Frame);
+    Frame->Count[Chip] = sc->Count + sc->AuxCount;
+}
+
+/******************************************************************************
+function:  Run one sweep of a scan table
+parameter:
+    Scan : Compiled scan table
+    Frame : Sweep frame opened with ADS1263_Frame_Begin
+Info:
+******************************************************************************/
+void ADS1263_Scan(ADS1263_SCAN *Scan, ADS1263_FRAME *Frame)
+{
+    UBYTE chip;
+    Frame->Header.Epoch = Scan->Epoch;
+    for(chip = 0; chip < Scan->ChipCount; chip++) {
+        ADS1263_ScanChip(Scan, chip, Frame);
+    }
 }
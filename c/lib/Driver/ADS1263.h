@@ -30,7 +30,11 @@
 #ifndef _ADS1263_H_
 #define _ADS1263_H_
 
+#include <stddef.h>
 #include "DEV_Config.h"
+#include "ADS1263_Frame.h"
+#include "ADS1263_Convert.h"
+#include "ADS1263_Detector.h"
 
 /******************************************************************************
 Highz Spectrometer Hardware Configuration
@@ -59,10 +63,13 @@ ADC #3 (Bottom):
 
 Summary: 21 log detectors + 3 state signals + 1 power monitor = 25 total
 
+The pins and channel allocation above are declared in examples/channels.map
+and compiled into a scan table at startup (see ADS1263_Map.h).
+
 Code Modifications from Original Waveshare Library:
 - Added pin parameters to all functions for multi-ADC addressing
-- Removed ADC2, DAC, and RTD functionality (not needed for this application)
-- Simplified code to focus on ADC1 voltage readings only
+- Removed DAC and RTD functionality (not needed for this application)
+- ADC2 runs only as the housekeeping converter of a scan table (see below)
 ******************************************************************************/
 
 #define Positive_A6 1
@@ -119,6 +126,16 @@ typedef enum
     ADS1263_DELAY_8d8ms,
 }ADS1263_DELAY;
 
+/* digital filter, MODE1 bits [7:5] */
+typedef enum
+{
+    ADS1263_FILTER_SINC1    = 0x00,
+    ADS1263_FILTER_SINC2    = 0x20,
+    ADS1263_FILTER_SINC3    = 0x40,
+    ADS1263_FILTER_SINC4    = 0x60,
+    ADS1263_FILTER_FIR      = 0x80,
+}ADS1263_FILTER;
+
 typedef enum
 {
     ADS1263_ADC2_10SPS  =   0,
@@ -194,6 +211,8 @@ typedef enum
     REG_ADC2FSC1,   // 40h
 }ADS1263_REG;
 
+#define ADS1263_REG_COUNT   (REG_ADC2FSC1 + 1)  // Registers 00h-1Ah
+
 typedef enum
 {
     CMD_RESET   = 0x06, // Reset the ADC, 0000 011x (06h or 07h)
@@ -215,6 +234,103 @@ typedef enum
     CMD_WREG2   = 0x00, // number of registers to write minus 1, 000n nnnn
 }ADS1263_CMD;
 
+/******************************************************************************
+Device Table
+
+Chips are found at startup by probing candidate CS/DRDY pairs: a candidate is
+kept when REG_ID reports an ADS1263 and its DRDY line goes LOW after START1.
+Each chip sits on one SPI bus; up to ADS1263_MAX_CHIPS_PER_BUS per bus.
+******************************************************************************/
+typedef struct
+{
+    UBYTE Bus;          // SPI bus index (0 = spidev0.x)
+    UWORD CS;           // Chip select pin
+    UWORD DRDY;         // Data ready pin
+    UWORD RST;          // Reset pin
+    UBYTE Id;           // REG_ID as read (device id << 5 | revision), 0 = absent
+} ADS1263_DEVICE;
+
+/******************************************************************************
+Scan Table
+
+A scan table is the compiled form of a channel map (see ADS1263_Map.h): for
+each chip, the exact inputs to convert in order, with the register values
+each conversion needs. Every entry carries its own settle delay (MODE0),
+filter (MODE1) and data rate (MODE2), so fast state lines, log detectors
+and a heavily filtered monitor can share one chip.
+
+ADS1263_Scan replays the table with the fewest SPI bytes possible. MODE0,
+MODE1, MODE2 and INPMUX are consecutive registers; between two entries
+only the span from the first register that differs from what the chip
+holds through INPMUX is written, in one WREG burst. Entries with equal
+settings cost a single 3-byte INPMUX write, and unused inputs are never
+touched. OFCAL/FSCAL stay those of the chip's own rate.
+
+Entries with a Divider above 1 are only converted in the sweeps where
+(Sequence + Phase) is a multiple of Divider; in the other sweeps their slot
+repeats the last code with ADS1263_SAMPLE_STALE set (see ADS1263_Sched.h).
+
+Aux entries are converted by ADC2, which runs on its own next to ADC1 for
+slow housekeeping inputs (supply monitor, internal temperature). Once per
+chip visit, while ADC1 is busy converting, one RDATA2 read checks for a new
+ADC2 result; when there is one it is stored and ADC2MUX moves on to the
+next aux input. Housekeeping therefore costs no ADC1 conversion time. Aux
+slots follow the ADC1 slots in the frame row; the slot whose conversion
+finished during the visit is fresh, the others repeat their last code with
+ADS1263_SAMPLE_STALE. ADC2 codes are 24-bit and are stored shifted to
+ADC1's 32-bit full scale, so both convert to volts the same way.
+
+Inputs 0-10 are AIN0-AIN10 against AINCOM; ADS1263_INPUT_TEMP, _AVDD and
+_DVDD select the internal temperature sensor (122.4 mV at 25 C, +420 uV/C)
+and the analog/digital supply monitors (supply / 4).
+******************************************************************************/
+#define ADS1263_INPUT_TEMP      11
+#define ADS1263_INPUT_AVDD      12
+#define ADS1263_INPUT_DVDD      13
+typedef struct
+{
+    UBYTE Input;        // AINx number or ADS1263_INPUT_*, stored in Frame->Channel
+    UBYTE MODE0;        // Conversion delay
+    UBYTE MODE1;        // Digital filter
+    UBYTE MODE2;        // PGA bypass and data rate
+    UBYTE INPMUX;       // Input multiplexer value (ADC2MUX for aux entries)
+    UBYTE Divider;      // Converted in one sweep out of Divider (power of two)
+    UBYTE Phase;        // Sweep offset within the divider
+    float Target;       // Requested samples per second, 0 = every sweep
+    UDOUBLE Last;       // Last code, repeated in sweeps the entry sits out
+    UBYTE LastFlags;
+    UDOUBLE Samples;    // Conversions done, for ADS1263_Sched_Update
+} ADS1263_SCAN_ENTRY;
+
+_Static_assert(offsetof(ADS1263_SCAN_ENTRY, INPMUX) - offsetof(ADS1263_SCAN_ENTRY, MODE0) == 3,
+               "scan entry registers must mirror MODE0..INPMUX");
+
+typedef struct
+{
+    UBYTE Bus;          // SPI bus the chip is on
+    UWORD CS;           // Chip select pin
+    UWORD DRDY;         // Data ready pin
+    UBYTE Rate;         // ADS1263_DRATE the chip runs at
+    UBYTE Count;        // Entries in use
+    UBYTE CurMODE0;     // Register values last written, 0xFF = unknown
+    UBYTE CurMODE1;
+    UBYTE CurMODE2;
+    ADS1263_SCAN_ENTRY Entry[ADS1263_FRAME_STRIDE];
+    UBYTE AuxCount;     // ADC2 entries, Count + AuxCount <= ADS1263_FRAME_STRIDE
+    UBYTE AuxNext;      // Aux entry ADC2 is converting
+    UBYTE AuxRun;       // ADC2 configured and started
+    UBYTE ADC2CFG;      // ADC2 rate, reference and gain
+    uint64_t AuxTime_ns;    // Last ADC2 start or result
+    ADS1263_SCAN_ENTRY Aux[ADS1263_FRAME_STRIDE];
+} ADS1263_SCAN_CHIP;
+
+typedef struct
+{
+    UBYTE ChipCount;
+    UDOUBLE Epoch;      // Configuration epoch, stamped into every frame
+    ADS1263_SCAN_CHIP Chip[ADS1263_MAX_CHIPS];
+} ADS1263_SCAN;
+
 /******************************************************************************
 Function Prototypes - Modified for Multi-ADC Support
 
@@ -231,6 +347,58 @@ Info:
 ******************************************************************************/
 int get_DRDYPIN(UWORD DEV_CS_PIN);
 
+/******************************************************************************
+function:   Register the DRDY pin that belongs to a CS pin
+parameter:
+    DEV_CS_PIN: Chip select pin of the ADC
+    DEV_DRDY_PIN: Its data ready pin
+Info:
+    Registered pairs take precedence over the built-in Highz mapping
+    in get_DRDYPIN. Called by ADS1263_Map_Compile for every mapped chip
+******************************************************************************/
+void ADS1263_SetDRDYPIN(UWORD DEV_CS_PIN, UWORD DEV_DRDY_PIN);
+
+/******************************************************************************
+function:   Read the device ID of a specific ADC
+parameter:
+    DEV_CS_PIN: Chip select pin for target ADC
+Info:
+    Returns the 3-bit device ID (1 for ADS1263)
+******************************************************************************/
+UBYTE ADS1263_ReadChipID(UWORD DEV_CS_PIN);
+
+/******************************************************************************
+function:   Nominal data rate and settle delay of register settings
+parameter:
+    Rate: ADS1263_DRATE (MODE2 bits [3:0])
+    Delay: ADS1263_DELAY (MODE0 bits [3:0])
+Info:
+    Returns samples per second / seconds
+******************************************************************************/
+double ADS1263_RateHz(UBYTE Rate);
+double ADS1263_DelaySeconds(UBYTE Delay);
+
+/******************************************************************************
+function:   Nominal data rate of ADC2
+parameter:
+    Rate: ADS1263_ADC2_DRATE (ADC2CFG bits [7:6])
+Info:
+    Returns samples per second
+******************************************************************************/
+double ADS1263_ADC2_RateHz(UBYTE Rate);
+
+/******************************************************************************
+function:   Probe candidate chips and keep those that answer
+parameter:
+    Candidate: CS/DRDY/RST pins to try, in order
+    Number: Number of candidates (at most ADS1263_MAX_CHIPS are kept)
+    Found: Receives the chips that answered, with Id filled in
+Info:
+    Sets up GPIO/SPI for each candidate on its bus and registers the CS/DRDY
+    pair of every chip found. Returns the number of chips found
+******************************************************************************/
+UBYTE ADS1263_Probe(const ADS1263_DEVICE *Candidate, UBYTE Number, ADS1263_DEVICE *Found);
+
 /******************************************************************************
 function:   Initialize ADC1 on a specific ADS1263 chip
 parameter:
@@ -238,10 +406,41 @@ parameter:
     DEV_CS_PIN: Chip select pin for target ADC
 Info:
     Returns 0 on success, 1 on failure
-    Only ADC1 is used in Highz configuration. ADC2 functions removed.
+    ADC2 is configured by the scan, see ADS1263_SCAN_CHIP.Aux
 ******************************************************************************/
 UBYTE ADS1263_init_ADC1(ADS1263_DRATE rate, UWORD DEV_CS_PIN);
 
+/******************************************************************************
+function:   Send a command byte to a specific ADC
+parameter:
+    Cmd: Command (see ADS1263_CMD enum)
+    DEV_CS_PIN: Chip select pin for target ADC
+Info:
+******************************************************************************/
+void ADS1263_WriteCmd(UBYTE Cmd, UWORD DEV_CS_PIN);
+
+/******************************************************************************
+function:   Read consecutive registers in one transaction
+parameter:
+    Reg: First register (see ADS1263_REG enum)
+    Data: Receives Count bytes
+    Count: Number of registers, 1 .. ADS1263_REG_COUNT - Reg
+    DEV_CS_PIN: Chip select pin for target ADC
+Info:
+******************************************************************************/
+void ADS1263_ReadRegs(UBYTE Reg, UBYTE *Data, UBYTE Count, UWORD DEV_CS_PIN);
+
+/******************************************************************************
+function:   Write consecutive registers in one transaction
+parameter:
+    Reg: First register (see ADS1263_REG enum)
+    Data: Count bytes to write
+    Count: Number of registers, 1 .. ADS1263_REG_COUNT - Reg
+    DEV_CS_PIN: Chip select pin for target ADC
+Info:
+******************************************************************************/
+void ADS1263_WriteRegs(UBYTE Reg, const UBYTE *Data, UBYTE Count, UWORD DEV_CS_PIN);
+
 /******************************************************************************
 function:   Set ADC operating mode
 parameter:
@@ -262,17 +461,61 @@ Info:
 UDOUBLE ADS1263_GetChannalValue(UBYTE Channel, UWORD DEV_CS_PIN, UWORD DEV_DRDY_PIN);
 
 /******************************************************************************
-function:   Read multiple channels from specified ADC
+function:   Read multiple channels from specified ADC into a sweep frame
 parameter:
     List: Array of channel numbers to read
-    Value: Array to store readings (must be pre-allocated)
-    Number: Number of channels to read
+    Number: Number of channels to read (at most ADS1263_FRAME_STRIDE)
+    Chip: Frame row for this ADC (0 = ADC #1)
+    Frame: Sweep frame opened with ADS1263_Frame_Begin
     DEV_CS_PIN: Chip select pin for target ADC
     DEV_DRDY_PIN: Data ready pin for target ADC
 Info:
     Used for sequential reading of log detectors on each ADC
+    Fills Code, Channel, Status, Count and ChipTime_ns for the row
+******************************************************************************/
+void ADS1263_GetAll(UBYTE *List, int Number, UBYTE Chip, ADS1263_FRAME *Frame, UWORD DEV_CS_PIN, UWORD DEV_DRDY_PIN);
+
+/******************************************************************************
+function:   Run one sweep of a scan table
+parameter:
+    Scan: Compiled scan table
+    Frame: Sweep frame opened with ADS1263_Frame_Begin
+Info:
+    Chip rows are filled in table order; row N of the frame is chip N.
+    Chips on different buses are scanned one after the other; use
+    ADS1263_MultiBus to scan the buses in parallel
+******************************************************************************/
+void ADS1263_Scan(ADS1263_SCAN *Scan, ADS1263_FRAME *Frame);
+
+/******************************************************************************
+function:   Run one chip of a scan table
+parameter:
+    Scan: Compiled scan table
+    Chip: Chip index within the table (and frame row)
+    Frame: Sweep frame opened with ADS1263_Frame_Begin
+Info:
+    Selects the chip's SPI bus for the calling thread. Also services the
+    chip's ADC2 aux inputs
+******************************************************************************/
+void ADS1263_ScanChip(ADS1263_SCAN *Scan, UBYTE Chip, ADS1263_FRAME *Frame);
+
+/******************************************************************************
+function:   Decode the calibration/device state lines
+parameter:
+Info:
+    Returns the state number 0-9, or ADS1263_STATE_INVALID
+    Stored in every frame header by ADS1263_Frame_End
+******************************************************************************/
+UBYTE ADS1263_ReadState(void);
+
+/******************************************************************************
+function:   Data packets that failed their checksum
+parameter:
+Info:
+    Counted over every chip since the start, ADC1 and ADC2. The samples
+    themselves carry ADS1263_SAMPLE_CRC
 ******************************************************************************/
-void ADS1263_GetAll(UBYTE *List, UDOUBLE *Value, int Number, UWORD DEV_CS_PIN, UWORD DEV_DRDY_PIN);
+uint64_t ADS1263_CrcErrors(void);
 
 /******************************************************************************
 function:   Reset a specific ADC via hardware reset pin
@@ -0,0 +1,82 @@
+/*****************************************************************************
+* | File        :   ADS1263_Arena.c
+* | Author      :   Highz team
+* | Function    :   Fixed-size arena for acquisition buffers
+* | Info        :
+*----------------
+* | This version:   V1.0
+* | Date        :   2026-10-19
+* | Info        :
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documnetation files (the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to  whom the Software is
+# furished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included in
+# all copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS OR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+# THE SOFTWARE.
+#
+******************************************************************************/
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include "ADS1263_Arena.h"
+
+UBYTE ADS1263_Arena_Init(ADS1263_ARENA *Arena, size_t Size, UBYTE Huge)
+{
+    size_t page = (size_t)sysconf(_SC_PAGESIZE);
+    void *p = MAP_FAILED;
+
+    memset(Arena, 0, sizeof(*Arena));
+#ifdef MAP_HUGETLB
+    if(Huge) {
+        Arena->Size = (Size + ADS1263_ARENA_HUGE_PAGE - 1) & ~(size_t)(ADS1263_ARENA_HUGE_PAGE - 1);
+        p = mmap(NULL, Arena->Size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        Arena->Huge = (p != MAP_FAILED);
+    }
+#endif
+    if(p == MAP_FAILED) {
+        Arena->Size = (Size + page - 1) & ~(page - 1);
+        p = mmap(NULL, Arena->Size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if(p == MAP_FAILED) {
+            printf("Arena of %zu bytes failed \r\n", Arena->Size);
+            Arena->Size = 0;
+            return 1;
+        }
+#ifdef MADV_HUGEPAGE
+        if(Huge)
+            madvise(p, Arena->Size, MADV_HUGEPAGE);
+#endif
+    }
+    Arena->Base = (UBYTE *)p;
+    return 0;
+}
+
+void *ADS1263_Arena_Alloc(ADS1263_ARENA *Arena, size_t Size)
+{
+    size_t at = (Arena->Used + ADS1263_ARENA_ALIGN - 1) & ~(size_t)(ADS1263_ARENA_ALIGN - 1);
+
+    if(Arena->Base == NULL || at > Arena->Size || Size > Arena->Size - at) {
+        printf("Arena full: %zu of %zu bytes used, %zu more asked \r\n", Arena->Used, Arena->Size, Size);
+        return NULL;
+    }
+    Arena->Used = at + Size;
+    return Arena->Base + at;    // Anonymous mappings start zeroed
+}
+
+void ADS1263_Arena_Free(ADS1263_ARENA *Arena)
+{
+    if(Arena->Base != NULL)
+        munmap(Arena->Base, Arena->Size);
+    memset(Arena, 0, sizeof(*Arena));
+}
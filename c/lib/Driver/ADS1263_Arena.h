@@ -0,0 +1,89 @@
+/*****************************************************************************
+* | File        :   ADS1263_Arena.h
+* | Author      :   Highz team
+* | Function    :   Fixed-size arena for acquisition buffers
+* | Info        :
+*----------------
+* | This version:   V1.0
+* | Date        :   2026-10-19
+* | Info        :
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documnetation files (the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to  whom the Software is
+# furished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included in
+# all copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS OR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+# THE SOFTWARE.
+#
+******************************************************************************/
+#ifndef _ADS1263_ARENA_H_
+#define _ADS1263_ARENA_H_
+
+#include <stddef.h>
+#include "DEV_Config.h"
+
+/******************************************************************************
+Arena
+
+One anonymous mapping, sized up front and handed out front to back. There
+is no free: everything lives as long as the arena. With Huge set the
+mapping is asked for in 2 MB huge pages (MAP_HUGETLB, needs
+vm.nr_hugepages); if none are reserved it falls back to normal pages with
+transparent huge pages requested (MADV_HUGEPAGE).
+
+Blocks are aligned to ADS1263_ARENA_ALIGN so frames and rows keep their
+cache line alignment.
+******************************************************************************/
+#define ADS1263_ARENA_ALIGN     64
+#define ADS1263_ARENA_HUGE_PAGE (2u * 1024 * 1024)
+
+typedef struct
+{
+    UBYTE  *Base;
+    size_t Size;            // Mapped bytes
+    size_t Used;            // Bytes handed out
+    UBYTE  Huge;            // Backed by MAP_HUGETLB pages
+} ADS1263_ARENA;
+
+/******************************************************************************
+function:   Map an arena
+parameter:
+    Arena: Arena to set up
+    Size: Bytes needed (rounded up to whole pages)
+    Huge: Try 2 MB huge pages first
+Info:
+    Memory is zeroed. Returns 0 on success, 1 on failure
+******************************************************************************/
+UBYTE ADS1263_Arena_Init(ADS1263_ARENA *Arena, size_t Size, UBYTE Huge);
+
+/******************************************************************************
+function:   Take a block from an arena
+parameter:
+    Arena: Mapped arena
+    Size: Bytes
+Info:
+    Returns a zeroed, ADS1263_ARENA_ALIGN aligned block, or NULL when the
+    arena is full
+******************************************************************************/
+void *ADS1263_Arena_Alloc(ADS1263_ARENA *Arena, size_t Size);
+
+/******************************************************************************
+function:   Unmap an arena
+parameter:
+    Arena: Arena to release; every block taken from it becomes invalid
+Info:
+******************************************************************************/
+void ADS1263_Arena_Free(ADS1263_ARENA *Arena);
+
+#endif
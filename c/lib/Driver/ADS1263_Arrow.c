@@ -0,0 +1,501 @@
+/*****************************************************************************
+* | File        :   ADS1263_Arrow.c
+* | Author      :   Highz team
+* | Function    :   Apache Arrow IPC stream output
+* | Info        :
+*----------------
+* | This version:   V1.0
+* | Date        :   2026-10-19
+* | Info        :
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documnetation files (the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to  whom the Software is
+# furished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included in
+# all copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS OR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+# THE SOFTWARE.
+#
+******************************************************************************/
+#include <string.h>
+#include "ADS1263_Arrow.h"
+
+// Samples that carry no new reading become nulls
+#define SKIP_FLAGS  (ADS1263_SAMPLE_STALE | ADS1263_SAMPLE_TIMEOUT | ADS1263_SAMPLE_CRC)
+
+// Arrow format constants (Schema.fbs, Message.fbs)
+#define ARROW_CONTINUATION  0xFFFFFFFFu
+#define ARROW_V5            4
+#define ARROW_SCHEMA        1       // MessageHeader
+#define ARROW_RECORD_BATCH  3
+#define ARROW_TYPE_INT      2       // Type union
+#define ARROW_TYPE_FLOAT    3
+#define ARROW_TYPE_TIMESTAMP 10
+#define ARROW_SINGLE        1       // Precision
+#define ARROW_NANOSECOND    3       // TimeUnit
+
+/******************************************************************************
+Flatbuffer builder
+
+Just enough of the flatbuffer wire format for the two Arrow messages: the
+buffer is built back to front in a fixed block, so children are written
+before the tables that point at them, and a position is its distance from
+the end. Any overflow sets Fail and the message is not used.
+******************************************************************************/
+typedef struct
+{
+    UBYTE   *Buf;
+    size_t   Size;
+    size_t   Head;          // Bytes used, from the end
+    UBYTE    Fail;
+    UBYTE    Fields;        // Of the table being built
+    size_t   TableEnd;
+    UBYTE    Slot[8];
+    size_t   Pos[8];
+} FB;
+
+static void Fb_Put(FB *b, const void *Data, size_t Size)
+{
+    if(b->Fail || b->Head + Size > b->Size) {
+        b->Fail = 1;
+        return;
+    }
+    b->Head += Size;
+    memcpy(b->Buf + b->Size - b->Head, Data, Size);
+}
+
+/* pad so that after Size more bytes the head is a multiple of Align */
+static void Fb_Align(FB *b, size_t Size, size_t Align)
+{
+    static const UBYTE zero[8];
+    Fb_Put(b, zero, (Align - (b->Head + Size) % Align) % Align);
+}
+
+static void Fb_Start(FB *b)
+{
+    b->Fields = 0;
+    b->TableEnd = b->Head;
+}
+
+static void Fb_Scalar(FB *b, UBYTE Slot, const void *Data, size_t Size)
+{
+    Fb_Align(b, Size, Size);
+    Fb_Put(b, Data, Size);
+    b->Slot[b->Fields] = Slot;
+    b->Pos[b->Fields++] = b->Head;
+}
+
+static void Fb_Ref(FB *b, UBYTE Slot, uint32_t Ref)
+{
+    uint32_t v;
+    Fb_Align(b, 4, 4);
+    v = (uint32_t)(b->Head + 4 - Ref);
+    Fb_Put(b, &v, 4);
+    b->Slot[b->Fields] = Slot;
+    b->Pos[b->Fields++] = b->Head;
+}
+
+/* close the table: inline fields, then its vtable in front of it */
+static uint32_t Fb_End(FB *b)
+{
+    UWORD vt[2 + 8] = {0};
+    int32_t soff = 0;
+    size_t table;
+    UBYTE i, n = 0;
+
+    Fb_Align(b, 4, 4);
+    Fb_Put(b, &soff, 4);
+    table = b->Head;
+    for(i = 0; i < b->Fields; i++) {
+        vt[2 + b->Slot[i]] = (UWORD)(table - b->Pos[i]);
+        if(b->Slot[i] + 1 > n)
+            n = b->Slot[i] + 1;
+    }
+    vt[0] = (UWORD)(4 + 2 * n);
+    vt[1] = (UWORD)(table - b->TableEnd);
+    Fb_Put(b, vt, vt[0]);
+    if(b->Fail)
+        return 0;
+    soff = (int32_t)(b->Head - table);
+    memcpy(b->Buf + b->Size - table, &soff, 4);
+    return (uint32_t)table;
+}
+
+static uint32_t Fb_String(FB *b, const char *Text)
+{
+    uint32_t n = (uint32_t)strlen(Text);
+    Fb_Align(b, n + 1, 4);
+    Fb_Put(b, "", 1);
+    Fb_Put(b, Text, n);
+    Fb_Put(b, &n, 4);
+    return (uint32_t)b->Head;
+}
+
+static uint32_t Fb_Refs(FB *b, const uint32_t *Ref, UWORD Count)
+{
+    uint32_t n = Count, v;
+    Fb_Align(b, 4 * (size_t)Count, 4);
+    while(Count-- > 0) {
+        v = (uint32_t)(b->Head + 4 - Ref[Count]);
+        Fb_Put(b, &v, 4);
+    }
+    Fb_Put(b, &n, 4);
+    return (uint32_t)b->Head;
+}
+
+/* vector of 16-byte structs (FieldNode, Buffer): pairs of int64 */
+static uint32_t Fb_Pairs(FB *b, const int64_t *Pair, UWORD Count)
+{
+    uint32_t n = Count;
+    Fb_Align(b, 16 * (size_t)Count, 8);
+    Fb_Put(b, Pair, 16 * (size_t)Count);
+    Fb_Put(b, &n, 4);
+    return (uint32_t)b->Head;
+}
+
+/* Message table around a header, then the root offset; returns the size */
+static size_t Fb_Message(FB *b, UBYTE Type, uint32_t Header, int64_t Body)
+{
+    uint32_t root, v;
+    UWORD version = ARROW_V5;
+
+    Fb_Start(b);
+    Fb_Scalar(b, 3, &Body, 8);
+    Fb_Ref(b, 2, Header);
+    Fb_Scalar(b, 0, &version, 2);
+    Fb_Scalar(b, 1, &Type, 1);
+    root = Fb_End(b);
+    Fb_Align(b, 4, 8);
+    v = (uint32_t)(b->Head + 4 - root);
+    Fb_Put(b, &v, 4);
+    return b->Fail ? 0 : b->Head;
+}
+
+/******************************************************************************
+Message layout
+******************************************************************************/
+static void Arrow_Names(const ADS1263_MAP *Map, char (*Name)[2 * ADS1263_MAP_NAME], UWORD *Columns)
+{
+    UBYTE chip, slot;
+
+    *Columns = 0;
+    for(chip = 0; chip < Map->ChipCount; chip++) {
+        for(slot = 0; slot < ADS1263_FRAME_STRIDE; slot++) {
+            const char *channel = ADS1263_Map_Name(Map, chip, slot);
+            if(channel[0] == '\0')
+                break;
+            if(Name != NULL)
+                snprintf(Name[*Columns], sizeof(Name[0]), "%s.%s", Map->Chip[chip].Name, channel);
+            (*Columns)++;
+        }
+    }
+}
+
+static UDOUBLE Arrow_Rows(const ADS1263_ARROW_CONFIG *Config)
+{
+    return Config->BatchRows == 0 ? 64 : (Config->BatchRows + 63) / 64 * 64;
+}
+
+/* body bytes at full batch spacing: fixed columns, bitmaps, values */
+static size_t Arrow_Body(UDOUBLE Rows, UWORD Columns)
+{
+    return (size_t)21 * Rows + (size_t)Columns * (Rows / 8 + 4 * (size_t)Rows);
+}
+
+/* flatbuffer scratch: generous for either message */
+static size_t Arrow_MetaMax(UWORD Columns)
+{
+    return 512 + (size_t)(Columns + ADS1263_ARROW_FIXED) * 160;
+}
+
+static size_t Arrow_Schema(ADS1263_ARROW *a)
+{
+    FB b = {a->Meta, a->MetaSize, 0, 0, 0, 0, {0}, {0}};
+    uint32_t field[ADS1263_MAX_CHIPS * ADS1263_FRAME_STRIDE + ADS1263_ARROW_FIXED];
+    static const char *fixed[ADS1263_ARROW_FIXED] = {"time", "sequence", "flags", "state"};
+    static const int32_t bits[ADS1263_ARROW_FIXED] = {64, 64, 32, 8};
+    uint32_t utc, type, name, none, fields, schema;
+    UWORD i, n = a->Columns + ADS1263_ARROW_FIXED;
+    UWORD little = 0, unit = ARROW_NANOSECOND, single = ARROW_SINGLE;
+    UBYTE kind, nullable;
+
+    utc = Fb_String(&b, "UTC");
+    for(i = 0; i < n; i++) {
+        const char *label = i < ADS1263_ARROW_FIXED ? fixed[i] : a->Name[i - ADS1263_ARROW_FIXED];
+        name = Fb_String(&b, label);
+        none = Fb_Refs(&b, NULL, 0);
+        Fb_Start(&b);
+        if(i == 0) {
+            kind = ARROW_TYPE_TIMESTAMP;
+            Fb_Ref(&b, 1, utc);
+            Fb_Scalar(&b, 0, &unit, 2);
+        } else if(i >= ADS1263_ARROW_FIXED && a->Config.Values != ADS1263_ARROW_CODE) {
+            kind = ARROW_TYPE_FLOAT;
+            Fb_Scalar(&b, 0, &single, 2);
+        } else {
+            int32_t width = i < ADS1263_ARROW_FIXED ? bits[i] : 32;
+            UBYTE sign = i >= ADS1263_ARROW_FIXED;
+            kind = ARROW_TYPE_INT;
+            Fb_Scalar(&b, 0, &width, 4);
+            Fb_Scalar(&b, 1, &sign, 1);
+        }
+        type = Fb_End(&b);
+        nullable = i >= ADS1263_ARROW_FIXED;
+        Fb_Start(&b);
+        Fb_Ref(&b, 0, name);
+        Fb_Ref(&b, 3, type);
+        Fb_Ref(&b, 5, none);
+        Fb_Scalar(&b, 1, &nullable, 1);
+        Fb_Scalar(&b, 2, &kind, 1);
+        field[i] = Fb_End(&b);
+    }
+    fields = Fb_Refs(&b, field, n);
+    Fb_Start(&b);
+    Fb_Ref(&b, 1, fields);
+    Fb_Scalar(&b, 0, &little, 2);
+    schema = Fb_End(&b);
+    return Fb_Message(&b, ARROW_SCHEMA, schema, 0);
+}
+
+/* RecordBatch metadata for the first Rows rows; sets *Body */
+static size_t Arrow_RecordBatch(ADS1263_ARROW *a, UDOUBLE Rows, int64_t *Body)
+{
+    FB b = {a->Meta, a->MetaSize, 0, 0, 0, 0, {0}, {0}};
+    int64_t pair[2 * 2 * (ADS1263_MAX_CHIPS * ADS1263_FRAME_STRIDE + ADS1263_ARROW_FIXED)];
+    const int64_t R = Arrow_Rows(&a->Config), n = Rows;
+    const int64_t fixed[ADS1263_ARROW_FIXED][2] = {{0, 8 * n}, {8 * R, 8 * n}, {16 * R, 4 * n}, {20 * R, n}};
+    const int64_t valid = 21 * R, value = valid + (int64_t)a->Columns * (R / 8);
+    UWORD i, count = a->Columns + ADS1263_ARROW_FIXED;
+    uint32_t nodes, buffers, batch;
+
+    // FieldNode: length, null count
+    for(i = 0; i < count; i++) {
+        pair[2 * i] = n;
+        pair[2 * i + 1] = i < ADS1263_ARROW_FIXED ? 0 : a->Nulls[i - ADS1263_ARROW_FIXED];
+    }
+    nodes = Fb_Pairs(&b, pair, count);
+    // Buffer: offset, length; validity then values for every field
+    for(i = 0; i < count; i++) {
+        int64_t *p = pair + 4 * i;
+        if(i < ADS1263_ARROW_FIXED) {
+            p[0] = p[1] = 0;
+            p[2] = fixed[i][0];
+            p[3] = fixed[i][1];
+        } else {
+            UWORD c = i - ADS1263_ARROW_FIXED;
+            p[0] = valid + (int64_t)c * (R / 8);
+            p[1] = a->Nulls[c] ? (n + 7) / 8 : 0;
+            p[2] = value + (int64_t)c * 4 * R;
+            p[3] = 4 * n;
+        }
+    }
+    buffers = Fb_Pairs(&b, pair, 2 * count);
+    *Body = (pair[4 * count - 2] + pair[4 * count - 1] + 7) / 8 * 8;
+
+    Fb_Start(&b);
+    Fb_Scalar(&b, 0, &n, 8);
+    Fb_Ref(&b, 1, nodes);
+    Fb_Ref(&b, 2, buffers);
+    batch = Fb_End(&b);
+    return Fb_Message(&b, ARROW_RECORD_BATCH, batch, *Body);
+}
+
+/* continuation marker, metadata length, metadata */
+static void Arrow_Frame(UBYTE *Out, const ADS1263_ARROW *a, size_t Meta)
+{
+    uint32_t prefix[2] = {ARROW_CONTINUATION, (uint32_t)Meta};
+    memcpy(Out, prefix, 8);
+    memcpy(Out + 8, a->Meta + a->MetaSize - Meta, Meta);
+}
+
+/******************************************************************************
+Producer
+******************************************************************************/
+void ADS1263_Arrow_Defaults(ADS1263_ARROW_CONFIG *Config)
+{
+    ADS1263_Writer_Defaults(&Config->Writer);
+    Config->Writer.Buffers = 4;
+    Config->Writer.BufferSize = 1024 * 1024;
+    Config->Writer.Threads = 1;
+    Config->BatchRows = 1024;
+    Config->Values = ADS1263_ARROW_VOLT;
+}
+
+size_t ADS1263_Arrow_Reserve(const ADS1263_ARROW_CONFIG *Config, const ADS1263_MAP *Map)
+{
+    UWORD columns;
+    Arrow_Names(Map, NULL, &columns);
+    return ADS1263_Writer_Reserve(&Config->Writer)
+         + (size_t)columns * (2 * ADS1263_MAP_NAME + sizeof(int16_t) + sizeof(UDOUBLE)) + 3 * ADS1263_ARENA_ALIGN
+         + 2 * Arrow_MetaMax(columns) + Arrow_Body(Arrow_Rows(Config), columns) + 2 * ADS1263_ARENA_ALIGN;
+}
+
+UBYTE ADS1263_Arrow_Open(ADS1263_ARROW *a, ADS1263_SESSION *Session, const char *Path,
+                         const ADS1263_MAP *Map, const ADS1263_ARROW_CONFIG *Config)
+{
+    UDOUBLE R = Arrow_Rows(Config);
+    int64_t body;
+    size_t meta;
+    UBYTE *schema;
+
+    memset(a, 0, sizeof(*a));
+    a->Config = *Config;
+    a->Config.BatchRows = R;
+    a->Map = Map;
+    Arrow_Names(Map, NULL, &a->Columns);
+    a->Name = ADS1263_Session_Alloc(Session, (size_t)a->Columns * sizeof(a->Name[0]));
+    a->Source = ADS1263_Session_Alloc(Session, (size_t)a->Columns * sizeof(int16_t));
+    a->Nulls = ADS1263_Session_Alloc(Session, (size_t)a->Columns * sizeof(UDOUBLE));
+    a->MetaSize = Arrow_MetaMax(a->Columns);
+    a->Meta = ADS1263_Session_Alloc(Session, a->MetaSize);
+    if((a->Columns > 0 && (a->Name == NULL || a->Source == NULL || a->Nulls == NULL)) || a->Meta == NULL)
+        return 1;
+    Arrow_Names(Map, a->Name, &a->Columns);
+
+    // Every batch has the same metadata size, so the body can be placed for good
+    meta = Arrow_RecordBatch(a, R, &body);
+    if(meta == 0)
+        return 1;
+    a->Prefix = 8 + meta;
+    if(a->Prefix + Arrow_Body(R, a->Columns) > Config->Writer.BufferSize) {
+        printf("Arrow: a %lu-row batch does not fit a writer buffer \r\n", (unsigned long)R);
+        return 1;
+    }
+    a->Batch = ADS1263_Session_Alloc(Session, a->Prefix + Arrow_Body(R, a->Columns));
+    if(a->Batch == NULL)
+        return 1;
+    a->Time = (int64_t *)(a->Batch + a->Prefix);
+    a->Sequence = (uint64_t *)(a->Batch + a->Prefix + 8 * (size_t)R);
+    a->Flags = (UDOUBLE *)(a->Batch + a->Prefix + 16 * (size_t)R);
+    a->State = a->Batch + a->Prefix + 20 * (size_t)R;
+    a->Valid = a->Batch + a->Prefix + 21 * (size_t)R;
+    a->Value = a->Valid + (size_t)a->Columns * (R / 8);
+
+    if(ADS1263_Writer_Open(&a->Writer, Session, Path, &Config->Writer) != 0)
+        return 1;
+    meta = Arrow_Schema(a);
+    if(meta == 0) {
+        printf("Arrow: schema does not fit \r\n");
+        return 1;
+    }
+    // The batch buffer is free until the first sweep: stage the schema in it
+    schema = a->Batch;
+    Arrow_Frame(schema, a, meta);
+    return ADS1263_Writer_WriteWait(&a->Writer, schema, 8 + meta);
+}
+
+/* frame slot of every column, by name, for the configuration epoch of Frame */
+static void Arrow_Map(ADS1263_ARROW *a, const ADS1263_FRAME *Frame)
+{
+    char name[2 * ADS1263_MAP_NAME];
+    UBYTE chip, slot;
+    UWORD c, used = 0, total = 0;
+
+    for(c = 0; c < a->Columns; c++)
+        a->Source[c] = -1;
+    for(chip = 0; chip < Frame->Header.ChipCount && chip < a->Map->ChipCount; chip++) {
+        for(slot = 0; slot < Frame->Count[chip]; slot++) {
+            snprintf(name, sizeof(name), "%s.%s", a->Map->Chip[chip].Name, ADS1263_Map_Name(a->Map, chip, slot));
+            total++;
+            for(c = 0; c < a->Columns; c++) {
+                if(a->Source[c] < 0 && strcmp(a->Name[c], name) == 0) {
+                    a->Source[c] = chip * ADS1263_FRAME_STRIDE + slot;
+                    used++;
+                    break;
+                }
+            }
+        }
+    }
+    for(; chip < Frame->Header.ChipCount; chip++)
+        total += Frame->Count[chip];
+    a->Extra = total - used;
+    a->Epoch = Frame->Header.Epoch;
+    a->Mapped = 1;
+}
+
+static UBYTE Arrow_Flush(ADS1263_ARROW *a, UBYTE Wait)
+{
+    int64_t body;
+    size_t meta;
+    UBYTE ret;
+
+    if(a->Rows == 0)
+        return 0;
+    meta = Arrow_RecordBatch(a, a->Rows, &body);
+    if(meta == 0 || 8 + meta != a->Prefix)
+        return 1;
+    Arrow_Frame(a->Batch, a, meta);
+    ret = Wait ? ADS1263_Writer_WriteWait(&a->Writer, a->Batch, a->Prefix + body)
+               : ADS1263_Writer_Write(&a->Writer, a->Batch, a->Prefix + body);
+    if(ret != 0)
+        a->Stats.Dropped++;
+    else
+        a->Stats.Batches++;
+    a->Rows = 0;
+    memset(a->Valid, 0, (size_t)a->Columns * (a->Config.BatchRows / 8));
+    memset(a->Nulls, 0, (size_t)a->Columns * sizeof(UDOUBLE));
+    return ret;
+}
+
+UBYTE ADS1263_Arrow_Append(ADS1263_ARROW *a, const ADS1263_FRAME *Frame)
+{
+    const UDOUBLE R = a->Config.BatchRows, r = a->Rows;
+    const UBYTE *row = a->Config.Values == ADS1263_ARROW_CODE ? (const UBYTE *)Frame->Code :
+                       a->Config.Values == ADS1263_ARROW_POWER ? (const UBYTE *)Frame->Power : (const UBYTE *)Frame->Volt;
+    const UBYTE *status = &Frame->Status[0][0];
+    UBYTE *valid = a->Valid + r / 8;
+    UBYTE *value = a->Value + 4 * (size_t)r;
+    UWORD c;
+
+    if(!a->Mapped || a->Epoch != Frame->Header.Epoch)
+        Arrow_Map(a, Frame);
+    a->Time[r] = (int64_t)Frame->Header.Time_ns;
+    a->Sequence[r] = Frame->Header.Sequence;
+    a->Flags[r] = Frame->Header.Flags;
+    a->State[r] = Frame->Header.CalState;
+    // One 4-byte store per channel into its column; nulls leave zeros behind
+    for(c = 0; c < a->Columns; c++, valid += R / 8, value += 4 * (size_t)R) {
+        int s = a->Source[c];
+        if(s < 0 || (status[s] & SKIP_FLAGS)) {
+            memset(value, 0, 4);
+            a->Nulls[c]++;
+            continue;
+        }
+        memcpy(value, row + 4 * (size_t)s, 4);
+        *valid |= (UBYTE)(1u << (r % 8));
+    }
+    a->Stats.Rows++;
+    a->Stats.Unmapped += a->Extra;
+    if(++a->Rows == R)
+        return Arrow_Flush(a, 0);
+    return 0;
+}
+
+UBYTE ADS1263_Arrow_Close(ADS1263_ARROW *a)
+{
+    static const uint32_t eos[2] = {ARROW_CONTINUATION, 0};
+    UBYTE ret;
+
+    ret = Arrow_Flush(a, 1);
+    ret |= ADS1263_Writer_WriteWait(&a->Writer, eos, sizeof(eos));
+    ret |= ADS1263_Writer_Close(&a->Writer);
+    ADS1263_Writer_GetStats(&a->Writer, &a->Stats.Disk);
+    return ret;
+}
+
+void ADS1263_Arrow_GetStats(const ADS1263_ARROW *a, ADS1263_ARROW_STATS *Stats)
+{
+    *Stats = a->Stats;
+    if(a->Writer.Fd >= 0)
+        ADS1263_Writer_GetStats(&a->Writer, &Stats->Disk);
+}
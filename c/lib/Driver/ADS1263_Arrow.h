@@ -0,0 +1,184 @@
+/*****************************************************************************
+* | File        :   ADS1263_Arrow.h
+* | Author      :   Highz team
+* | Function    :   Apache Arrow IPC stream output
+* | Info        :
+*----------------
+* | This version:   V1.0
+* | Date        :   2026-10-19
+* | Info        :
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documnetation files (the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to  whom the Software is
+# furished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included in
+# all copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS OR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+# THE SOFTWARE.
+#
+******************************************************************************/
+#ifndef _ADS1263_ARROW_H_
+#define _ADS1263_ARROW_H_
+
+#include "ADS1263.h"
+#include "ADS1263_Map.h"
+#include "ADS1263_Writer.h"
+
+/******************************************************************************
+Arrow IPC Stream
+
+Sweeps are written as an Apache Arrow IPC stream (the ".arrows" format that
+pyarrow.ipc.open_stream, Polars and DuckDB read), without linking Arrow:
+the few flatbuffer messages the format needs are encoded here.
+
+    Schema message              time, sequence, flags, state, one column
+                                per channel named "chip.channel"
+    RecordBatch message         BatchRows sweeps
+    RecordBatch message
+    ...
+    End-of-stream marker        written by ADS1263_Arrow_Close
+
+Column types:
+
+    time        timestamp[ns, UTC]  Header.Time_ns
+    sequence    uint64              Header.Sequence
+    flags       uint32              Header.Flags
+    state       uint8               Header.CalState (255 = invalid lines)
+    chip.ch     float32 volts or dBm, or int32 codes (Config.Values);
+                null where the sample is STALE, TIMEOUT or CRC, or the
+                channel is not in the sweep
+
+A batch is assembled in place in one arena buffer that is laid out as the
+finished message: prefix and metadata, then each column's validity bitmap
+and values at BatchRows spacing in the body. A sweep stores each value once
+into its column; a full batch only gets its metadata written in front and
+goes to the ADS1263_WRITER as a single block, so there is no serialisation
+pass and a batch is either written whole or dropped whole. A short last
+batch keeps the full-size spacing; Arrow allows gaps between body buffers.
+
+Messages only ever get appended, so readers can follow a live file; a
+file cut short by a power loss ends at the last whole batch.
+******************************************************************************/
+#define ADS1263_ARROW_FIXED     4   // time, sequence, flags, state
+
+typedef enum
+{
+    ADS1263_ARROW_VOLT = 0,     // float32 from Frame->Volt
+    ADS1263_ARROW_POWER,        // float32 from Frame->Power
+    ADS1263_ARROW_CODE,         // int32 from Frame->Code
+}ADS1263_ARROW_VALUES;
+
+typedef struct
+{
+    ADS1263_WRITER_CONFIG Writer;
+    UDOUBLE  BatchRows;     // Sweeps per record batch, rounded up to 64
+    UBYTE    Values;        // ADS1263_ARROW_VALUES of the channel columns
+} ADS1263_ARROW_CONFIG;
+
+typedef struct
+{
+    uint64_t Rows;          // Sweeps appended
+    uint64_t Batches;       // Record batches handed to the writer
+    uint64_t Dropped;       // Record batches the writer refused
+    uint64_t Unmapped;      // Frame slots whose channel is not a column
+    ADS1263_WRITER_STATS Disk;
+} ADS1263_ARROW_STATS;
+
+typedef struct
+{
+    ADS1263_WRITER Writer;
+    ADS1263_ARROW_CONFIG Config;
+    const ADS1263_MAP *Map;
+    UWORD    Columns;               // Channel columns
+    UDOUBLE  Epoch;                 // Epoch the slot mapping was built for
+    UBYTE    Mapped;
+    UWORD    Extra;                 // Frame slots left out by the mapping
+    int16_t *Source;                // [column] chip * ADS1263_FRAME_STRIDE + slot, -1 = none
+    char   (*Name)[2 * ADS1263_MAP_NAME];
+    // The batch being filled, a finished message apart from its metadata
+    UBYTE   *Batch;
+    size_t   Prefix;                // Continuation, length and metadata bytes
+    UDOUBLE  Rows;
+    int64_t *Time;
+    uint64_t *Sequence;
+    UDOUBLE *Flags;
+    UBYTE   *State;
+    UBYTE   *Valid;                 // [column][BatchRows / 8]
+    UBYTE   *Value;                 // [column][BatchRows] 32-bit values
+    UDOUBLE *Nulls;                 // [column]
+    UBYTE   *Meta;                  // Flatbuffer scratch
+    size_t   MetaSize;
+    ADS1263_ARROW_STATS Stats;
+} ADS1263_ARROW;
+
+/******************************************************************************
+function:   Default configuration
+parameter:
+    Config: Receives 1024-row batches of volts, four 1 MB writer buffers
+Info:
+******************************************************************************/
+void ADS1263_Arrow_Defaults(ADS1263_ARROW_CONFIG *Config);
+
+/******************************************************************************
+function:   Arena bytes an Arrow stream needs
+parameter:
+    Config: Stream configuration
+    Map: Channel map, for the number of columns
+Info:
+    Add to the Reserve given to ADS1263_Session_Open
+******************************************************************************/
+size_t ADS1263_Arrow_Reserve(const ADS1263_ARROW_CONFIG *Config, const ADS1263_MAP *Map);
+
+/******************************************************************************
+function:   Create a stream file and write its schema
+parameter:
+    Arrow: Stream state, usually static
+    Session: Open session the buffers are taken from
+    Path: File to create
+    Map: Channel map; one column per channel
+    Config: Stream configuration
+Info:
+    Returns 0 on success, 1 on failure
+******************************************************************************/
+UBYTE ADS1263_Arrow_Open(ADS1263_ARROW *Arrow, ADS1263_SESSION *Session, const char *Path,
+                         const ADS1263_MAP *Map, const ADS1263_ARROW_CONFIG *Config);
+
+/******************************************************************************
+function:   Add one sweep as a row
+parameter:
+    Arrow: Open stream
+    Frame: Finished frame, converted if volts or dBm are written
+Info:
+    Never blocks. Returns 0, or 1 if a full batch was dropped
+******************************************************************************/
+UBYTE ADS1263_Arrow_Append(ADS1263_ARROW *Arrow, const ADS1263_FRAME *Frame);
+
+/******************************************************************************
+function:   Write the last batch and the end-of-stream marker, close
+parameter:
+    Arrow: Open stream
+Info:
+    Returns 0 if everything reached the disk
+******************************************************************************/
+UBYTE ADS1263_Arrow_Close(ADS1263_ARROW *Arrow);
+
+/******************************************************************************
+function:   Read the stream counters
+parameter:
+    Arrow: Open or closed stream
+    Stats: Receives the counters
+Info:
+******************************************************************************/
+void ADS1263_Arrow_GetStats(const ADS1263_ARROW *Arrow, ADS1263_ARROW_STATS *Stats);
+
+#endif
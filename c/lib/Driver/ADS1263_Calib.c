@@ -0,0 +1,275 @@
+/*****************************************************************************
+* | File        :   ADS1263_Calib.c
+* | Author      :   Highz team
+* | Function    :   Offset/gain calibration manager
+* | Info        :
+*----------------
+* | This version:   V1.0
+* | Date        :   2026-10-19
+* | Info        :
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documnetation files (the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to  whom the Software is
+# furished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included in
+# all copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS OR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+# THE SOFTWARE.
+#
+******************************************************************************/
+#include <pthread.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "ADS1263_Calib.h"
+
+typedef struct
+{
+    UBYTE Bus;
+    UWORD CS;
+    UWORD Valid;                    // Bit per ADS1263_DRATE
+    UBYTE Coeff[ADS1263_CALIB_RATES][ADS1263_CALIB_BYTES];
+} CALIB_CHIP;
+
+static CALIB_CHIP Table[ADS1263_MAX_CHIPS];
+static UBYTE TableCount = 0;
+static pthread_mutex_t TableLock = PTHREAD_MUTEX_INITIALIZER;
+static uint64_t Interval_ns = 0;
+
+/* 16 averaged conversions plus filter settling, with a wide margin */
+static uint64_t Calib_Timeout_ns(ADS1263_DRATE Rate)
+{
+    return (uint64_t)(100.0 / ADS1263_RateHz(Rate) * 1e9) + 100000000ull;
+}
+
+static UBYTE Calib_Wait(UWORD DRDY, ADS1263_DRATE Rate)
+{
+    uint64_t deadline = ADS1263_Clock_ns(CLOCK_MONOTONIC) + Calib_Timeout_ns(Rate);
+
+    while(DEV_Digital_Read(DRDY) == 1) {
+        if(ADS1263_Clock_ns(CLOCK_MONOTONIC) > deadline) {
+            printf("Calibration timed out on DRDY %d \r\n", DRDY);
+            return 1;
+        }
+        usleep(100);
+    }
+    return 0;
+}
+
+/* caller holds TableLock */
+static CALIB_CHIP *Calib_Find(UBYTE Bus, UWORD CS, UBYTE Create)
+{
+    UBYTE i;
+    for(i = 0; i < TableCount; i++) {
+        if(Table[i].Bus == Bus && Table[i].CS == CS)
+            return &Table[i];
+    }
+    if(!Create || TableCount >= ADS1263_MAX_CHIPS)
+        return NULL;
+    memset(&Table[TableCount], 0, sizeof(Table[0]));
+    Table[TableCount].Bus = Bus;
+    Table[TableCount].CS = CS;
+    return &Table[TableCount++];
+}
+
+UBYTE ADS1263_Calib_Get(UBYTE Bus, UWORD CS, ADS1263_DRATE Rate, UBYTE *Coeff)
+{
+    CALIB_CHIP *chip;
+    UBYTE ret = 1;
+
+    pthread_mutex_lock(&TableLock);
+    chip = Calib_Find(Bus, CS, 0);
+    if(chip != NULL && (chip->Valid & (1 << (Rate & 0x0f)))) {
+        memcpy(Coeff, chip->Coeff[Rate & 0x0f], ADS1263_CALIB_BYTES);
+        ret = 0;
+    }
+    pthread_mutex_unlock(&TableLock);
+    return ret;
+}
+
+void ADS1263_Calib_Put(UBYTE Bus, UWORD CS, ADS1263_DRATE Rate, const UBYTE *Coeff)
+{
+    CALIB_CHIP *chip;
+
+    pthread_mutex_lock(&TableLock);
+    chip = Calib_Find(Bus, CS, 1);
+    if(chip != NULL) {
+        memcpy(chip->Coeff[Rate & 0x0f], Coeff, ADS1263_CALIB_BYTES);
+        chip->Valid |= 1 << (Rate & 0x0f);
+    }
+    pthread_mutex_unlock(&TableLock);
+}
+
+UBYTE ADS1263_Calib_Load(const char *Path)
+{
+    char line[128];
+    unsigned int bus, cs, rate, c[ADS1263_CALIB_BYTES];
+    UBYTE coeff[ADS1263_CALIB_BYTES];
+    UBYTE i;
+    FILE *fp = fopen(Path, "r");
+
+    if(fp == NULL)
+        return 1;
+    while(fgets(line, sizeof(line), fp) != NULL) {
+        if(line[0] == '#')
+            continue;
+        if(sscanf(line, "%u %u %u %2x%2x%2x %2x%2x%2x", &bus, &cs, &rate,
+                  &c[0], &c[1], &c[2], &c[3], &c[4], &c[5]) != 9 ||
+           bus >= ADS1263_MAX_BUSES || rate >= ADS1263_CALIB_RATES) {
+            printf("Bad calibration line: %s", line);
+            continue;
+        }
+        for(i = 0; i < ADS1263_CALIB_BYTES; i++)
+            coeff[i] = c[i];
+        ADS1263_Calib_Put(bus, cs, rate, coeff);
+    }
+    fclose(fp);
+    return 0;
+}
+
+UBYTE ADS1263_Calib_Save(const char *Path)
+{
+    char tmp[256];
+    UBYTE i, r;
+    FILE *fp;
+
+    snprintf(tmp, sizeof(tmp), "%s.tmp", Path);
+    if((fp = fopen(tmp, "w")) == NULL) {
+        printf("Write %s failed \r\n", tmp);
+        return 1;
+    }
+    fprintf(fp, "# bus cs rate OFCAL0-2 FSCAL0-2\n");
+    pthread_mutex_lock(&TableLock);
+    for(i = 0; i < TableCount; i++) {
+        for(r = 0; r < ADS1263_CALIB_RATES; r++) {
+            const UBYTE *c = Table[i].Coeff[r];
+            if(!(Table[i].Valid & (1 << r)))
+                continue;
+            fprintf(fp, "%d %d %d %02x%02x%02x %02x%02x%02x\n", Table[i].Bus, Table[i].CS, r,
+                    c[0], c[1], c[2], c[3], c[4], c[5]);
+        }
+    }
+    pthread_mutex_unlock(&TableLock);
+    if(fclose(fp) != 0 || rename(tmp, Path) != 0) {
+        printf("Write %s failed \r\n", Path);
+        return 1;
+    }
+    return 0;
+}
+
+UBYTE ADS1263_Calib_Run(UBYTE Bus, UWORD CS, UWORD DRDY, ADS1263_DRATE Rate,
+                        ADS1263_CALIB_KIND Kind, UBYTE INPMUX)
+{
+    UBYTE saved[2];                 // MODE2, INPMUX
+    UBYTE coeff[ADS1263_CALIB_BYTES];
+    UBYTE mode2, ret;
+
+    DEV_SPI_SelectBus(Bus);
+    ADS1263_WriteCmd(CMD_STOP1, CS);
+    ADS1263_ReadRegs(REG_MODE2, saved, 2, CS);
+    mode2 = (saved[0] & 0xf0) | (Rate & 0x0f);
+    ADS1263_WriteRegs(REG_MODE2, &mode2, 1, CS);
+    if(Kind != ADS1263_CALIB_SELF_OFFSET)
+        ADS1263_WriteRegs(REG_INPMUX, &INPMUX, 1, CS);
+
+    ADS1263_WriteCmd(CMD_START1, CS);
+    ADS1263_WriteCmd(Kind, CS);
+    ret = Calib_Wait(DRDY, Rate);
+    ADS1263_WriteCmd(CMD_STOP1, CS);
+    if(ret == 0) {
+        ADS1263_ReadRegs(REG_OFCAL0, coeff, ADS1263_CALIB_BYTES, CS);
+        ADS1263_Calib_Put(Bus, CS, Rate, coeff);
+    }
+    ADS1263_WriteRegs(REG_MODE2, saved, 2, CS);
+    return ret;
+}
+
+UBYTE ADS1263_Calib_Missing(const ADS1263_SCAN *Scan)
+{
+    UBYTE coeff[ADS1263_CALIB_BYTES];
+    UBYTE Bus = DEV_HARDWARE_SPI_CurrentBus();
+    UBYTE c, n = 0;
+
+    for(c = 0; c < Scan->ChipCount; c++) {
+        const ADS1263_SCAN_CHIP *sc = &Scan->Chip[c];
+        if(ADS1263_Calib_Get(sc->Bus, sc->CS, sc->Rate, coeff) == 0)
+            continue;
+        printf("Self-calibrating bus %d CS %d \r\n", sc->Bus, sc->CS);
+        if(ADS1263_Calib_Run(sc->Bus, sc->CS, sc->DRDY, sc->Rate, ADS1263_CALIB_SELF_OFFSET, 0) == 0)
+            n++;
+    }
+    DEV_SPI_SelectBus(Bus);
+    return n;
+}
+
+void ADS1263_Calib_SetInterval(double Seconds)
+{
+    Interval_ns = Seconds > 0 ? (uint64_t)(Seconds * 1e9) : 0;
+}
+
+void ADS1263_Calib_Before(ADS1263_CALIB_SCHED *Sched, const ADS1263_SCAN *Scan, UBYTE Chip)
+{
+    const ADS1263_SCAN_CHIP *sc = &Scan->Chip[Chip];
+    UBYTE coeff[ADS1263_CALIB_BYTES];
+
+    if(Sched->Busy != Chip + 1)
+        return;
+    Sched->Busy = 0;
+    if(Calib_Wait(sc->DRDY, sc->Rate) != 0) {
+        ADS1263_WriteCmd(CMD_STOP1, sc->CS);
+        return;
+    }
+    ADS1263_ReadRegs(REG_OFCAL0, coeff, ADS1263_CALIB_BYTES, sc->CS);
+    ADS1263_Calib_Put(sc->Bus, sc->CS, sc->Rate, coeff);
+}
+
+void ADS1263_Calib_After(ADS1263_CALIB_SCHED *Sched, ADS1263_SCAN *Scan, UBYTE Chip)
+{
+    ADS1263_SCAN_CHIP *sc = &Scan->Chip[Chip];
+    UBYTE mode2 = 0x80 | (ADS1263_GAIN_1 << 4) | sc->Rate;
+    UBYTE c, pos = 0, count = 0;
+    uint64_t now;
+
+    if(Interval_ns == 0 || Sched->Busy != 0)
+        return;
+    now = ADS1263_Clock_ns(CLOCK_MONOTONIC);
+    if(Sched->Next_ns == 0)
+        Sched->Next_ns = now + Interval_ns;
+    if(now < Sched->Next_ns)
+        return;
+
+    // Position of this chip among the chips of its bus
+    for(c = 0; c < Scan->ChipCount; c++) {
+        if(Scan->Chip[c].Bus != sc->Bus)
+            continue;
+        if(c == Chip)
+            pos = count;
+        count++;
+    }
+    if(pos != Sched->Next % count)
+        return;
+
+    // The chip stays busy until its next turn in the sweep. Its entries
+    // may run at other rates; the coefficients belong to the chip's own
+    ADS1263_WriteCmd(CMD_STOP1, sc->CS);
+    if(sc->CurMODE2 != mode2) {
+        ADS1263_WriteRegs(REG_MODE2, &mode2, 1, sc->CS);
+        sc->CurMODE2 = mode2;
+    }
+    ADS1263_WriteCmd(CMD_START1, sc->CS);
+    ADS1263_WriteCmd(ADS1263_CALIB_SELF_OFFSET, sc->CS);
+    Sched->Busy = Chip + 1;
+    Sched->Next++;
+    Sched->Next_ns = now + Interval_ns;
+}
@@ -0,0 +1,146 @@
+/*****************************************************************************
+* | File        :   ADS1263_Calib.h
+* | Author      :   Highz team
+* | Function    :   Offset/gain calibration manager
+* | Info        :
+*----------------
+* | This version:   V1.0
+* | Date        :   2026-10-19
+* | Info        :
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documnetation files (the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to  whom the Software is
+# furished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included in
+# all copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS OR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+# THE SOFTWARE.
+#
+******************************************************************************/
+#ifndef _ADS1263_CALIB_H_
+#define _ADS1263_CALIB_H_
+
+#include "ADS1263.h"
+
+/******************************************************************************
+Calibration Manager
+
+ADC1 corrects every conversion with OFCAL (offset, registers 07h-09h) and
+FSCAL (gain, 0Ah-0Ch). The chip can measure them itself:
+
+    SFOCAL1  self offset: inputs shorted internally
+    SYOCAL1  system offset: the selected inputs must be at zero
+    SYGCAL1  system gain: the selected inputs must be at full scale
+
+A calibration averages 16 conversions, which at low data rates takes
+seconds, and the result depends on the data rate and filter. So the six
+coefficient bytes are kept per chip and per data rate in a table, saved to
+a text file and restored at startup in the same WREG burst as MODE0-MODE2
+(ADS1263_Startup), so a normal boot runs no calibration at all.
+
+Offset drift is corrected while running without losing samples: every
+ADS1263_Calib_SetInterval seconds, one chip per bus is sent SFOCAL1 right
+after its scan (ADS1263_Calib_After). The calibration runs while the other
+chips of the bus are scanned, and the new OFCAL is collected just before
+the chip's next scan (ADS1263_Calib_Before). Only a bus with a single chip
+has to wait for it.
+
+Coefficient file, one line per chip and rate:
+    <bus> <cs> <rate> <OFCAL0-2 hex> <FSCAL0-2 hex>
+******************************************************************************/
+#define ADS1263_CALIB_BYTES     6       // OFCAL0-2, FSCAL0-2
+#define ADS1263_CALIB_RATES     16      // ADS1263_DRATE values
+
+typedef enum
+{
+    ADS1263_CALIB_SELF_OFFSET   = CMD_SFOCAL1,
+    ADS1263_CALIB_SYS_OFFSET    = CMD_SYOCAL1,
+    ADS1263_CALIB_SYS_GAIN      = CMD_SYGCAL1,
+}ADS1263_CALIB_KIND;
+
+/* per-bus recalibration state, owned by the thread scanning the bus */
+typedef struct
+{
+    uint64_t Next_ns;       // When the next recalibration is due
+    UBYTE    Next;          // Round-robin position among the bus's chips
+    UBYTE    Busy;          // 1 + chip calibrating now, 0 = none
+} ADS1263_CALIB_SCHED;
+
+/******************************************************************************
+function:   Load / save the coefficient table
+parameter:
+    Path: Coefficient file
+Info:
+    Load merges into the table. Returns 0 on success, 1 on failure
+******************************************************************************/
+UBYTE ADS1263_Calib_Load(const char *Path);
+UBYTE ADS1263_Calib_Save(const char *Path);
+
+/******************************************************************************
+function:   Look up / store the coefficients of a chip at a data rate
+parameter:
+    Bus, CS: Chip
+    Rate: Data rate the coefficients were measured at
+    Coeff: ADS1263_CALIB_BYTES bytes, OFCAL0 first
+Info:
+    Get returns 0 when found, 1 otherwise. Thread safe
+******************************************************************************/
+UBYTE ADS1263_Calib_Get(UBYTE Bus, UWORD CS, ADS1263_DRATE Rate, UBYTE *Coeff);
+void ADS1263_Calib_Put(UBYTE Bus, UWORD CS, ADS1263_DRATE Rate, const UBYTE *Coeff);
+
+/******************************************************************************
+function:   Run one calibration and store the result
+parameter:
+    Bus, CS, DRDY: Chip
+    Rate: Data rate to calibrate at
+    Kind: ADS1263_CALIB_*
+    INPMUX: Input to calibrate on for system calibrations (ignored for self)
+Info:
+    Blocks until the chip finishes. The chip's MODE2 and INPMUX are restored
+    Returns 0 on success, 1 on timeout
+******************************************************************************/
+UBYTE ADS1263_Calib_Run(UBYTE Bus, UWORD CS, UWORD DRDY, ADS1263_DRATE Rate,
+                        ADS1263_CALIB_KIND Kind, UBYTE INPMUX);
+
+/******************************************************************************
+function:   Self-calibrate every chip that has no coefficients at its rate
+parameter:
+    Scan: Compiled scan table
+Info:
+    For the first boot, or after a rate change. Returns the number of chips
+    calibrated
+******************************************************************************/
+UBYTE ADS1263_Calib_Missing(const ADS1263_SCAN *Scan);
+
+/******************************************************************************
+function:   Set the background recalibration interval
+parameter:
+    Seconds: Time between two recalibrations on a bus, 0 = off (default)
+Info:
+******************************************************************************/
+void ADS1263_Calib_SetInterval(double Seconds);
+
+/******************************************************************************
+function:   Recalibration hooks around ADS1263_ScanChip
+parameter:
+    Sched: State of the bus being scanned (zero it before the first sweep)
+    Scan: Scan table
+    Chip: Chip about to be / just scanned
+Info:
+    Before collects a finished calibration, After starts a due one.
+    Call from the thread that scans the bus
+******************************************************************************/
+void ADS1263_Calib_Before(ADS1263_CALIB_SCHED *Sched, const ADS1263_SCAN *Scan, UBYTE Chip);
+void ADS1263_Calib_After(ADS1263_CALIB_SCHED *Sched, ADS1263_SCAN *Scan, UBYTE Chip);
+
+#endif
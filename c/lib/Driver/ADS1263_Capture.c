@@ -0,0 +1,350 @@
+/*****************************************************************************
+* | File        :   ADS1263_Capture.c
+* | Author      :   Highz team
+* | Function    :   Chunked, indexed capture file
+* | Info        :
+*----------------
+* | This version:   V1.0
+* | Date        :   2026-10-19
+* | Info        :
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documnetation files (the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to  whom the Software is
+# furished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included in
+# all copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS OR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+# THE SOFTWARE.
+#
+******************************************************************************/
+#include <string.h>
+#include <time.h>
+#include "ADS1263_Capture.h"
+#include "ADS1263_Convert.h"
+
+void ADS1263_Capture_Defaults(ADS1263_CAPTURE_CONFIG *Config)
+{
+    ADS1263_Writer_Defaults(&Config->Writer);
+    Config->ChunkFrames = 1024;
+    Config->MaxChunks = 65536;
+    Config->Codec = ADS1263_CODEC_DELTA;
+    Config->PushFrames = 0;
+}
+
+static size_t Capture_ChunkMax(const ADS1263_CAPTURE_CONFIG *Config)
+{
+    ADS1263_CAPTURE_LAYOUT l;
+    ADS1263_Capture_Layout(ADS1263_MAX_CHIPS, ADS1263_MAX_CHIPS * ADS1263_FRAME_STRIDE, Config->ChunkFrames, &l);
+    return l.End;
+}
+
+static size_t Capture_EncodedMax(const ADS1263_CAPTURE_CONFIG *Config)
+{
+    const UWORD slots = ADS1263_MAX_CHIPS * ADS1263_FRAME_STRIDE;
+    const UDOUBLE n = Config->ChunkFrames;
+    ADS1263_CAPTURE_LAYOUT l;
+
+    ADS1263_Capture_Layout(ADS1263_MAX_CHIPS, slots, 0, &l);
+    return l.Record + ADS1263_CAPTURE_STREAMS(ADS1263_MAX_CHIPS, slots) * sizeof(UDOUBLE)
+         + (ADS1263_CAPTURE_RECORD_STREAMS - 1 + ADS1263_MAX_CHIPS) * ADS1263_Codec_Bound(n, 8) + ADS1263_Codec_Bound(n, 4)
+         + slots * (ADS1263_Codec_Bound(n, 4) + ADS1263_Codec_Bound(n, 1)) + 8;
+}
+
+size_t ADS1263_Capture_Reserve(const ADS1263_CAPTURE_CONFIG *Config)
+{
+    size_t coded = 0;
+    if(Config->Codec == ADS1263_CODEC_DELTA)
+        coded = Capture_EncodedMax(Config) + (size_t)Config->ChunkFrames * sizeof(uint64_t) + 2 * ADS1263_ARENA_ALIGN;
+    return ADS1263_Writer_Reserve(&Config->Writer) + Capture_ChunkMax(Config) + coded
+         + (size_t)(Config->MaxChunks + 1) * sizeof(ADS1263_CAPTURE_INDEX) + 2 * ADS1263_ARENA_ALIGN;
+}
+
+UBYTE ADS1263_Capture_Open(ADS1263_CAPTURE *c, ADS1263_SESSION *Session, const char *Path,
+                           const ADS1263_MAP *Map, const ADS1263_CAPTURE_CONFIG *Config)
+{
+    ADS1263_CAPTURE_FILE file;
+
+    memset(c, 0, sizeof(*c));
+    c->Config = *Config;
+    c->Map = Map;
+    c->Scan = Session->Scan;
+    c->Lost = UINT64_MAX;
+    c->ChunkMax = Capture_ChunkMax(Config);
+    if(Config->ChunkFrames == 0 || c->ChunkMax > Config->Writer.BufferSize ||
+       (Config->Codec == ADS1263_CODEC_DELTA && Capture_EncodedMax(Config) > Config->Writer.BufferSize)) {
+        printf("Capture: %lu-frame chunks do not fit a %zu KB writer buffer \r\n",
+               (unsigned long)Config->ChunkFrames, Config->Writer.BufferSize / 1024);
+        return 1;
+    }
+    c->Chunk = ADS1263_Session_Alloc(Session, c->ChunkMax);
+    c->Index = ADS1263_Session_Alloc(Session, (size_t)(Config->MaxChunks + 1) * sizeof(ADS1263_CAPTURE_INDEX));
+    if(c->Chunk == NULL || c->Index == NULL)
+        return 1;
+    if(Config->Codec == ADS1263_CODEC_DELTA) {
+        c->Encoded = ADS1263_Session_Alloc(Session, Capture_EncodedMax(Config));
+        c->Column = ADS1263_Session_Alloc(Session, (size_t)Config->ChunkFrames * sizeof(uint64_t));
+        if(c->Encoded == NULL || c->Column == NULL)
+            return 1;
+    }
+    if(ADS1263_Writer_Open(&c->Writer, Session, Path, &Config->Writer) != 0)
+        return 1;
+
+    memset(&file, 0, sizeof(file));
+    file.Magic = ADS1263_CAPTURE_MAGIC;
+    file.Version = ADS1263_CAPTURE_VERSION;
+    file.HeaderSize = sizeof(file);
+    file.ChunkFrames = Config->ChunkFrames;
+    file.Created_ns = ADS1263_Clock_ns(CLOCK_REALTIME);
+    return ADS1263_Writer_Write(&c->Writer, &file, sizeof(file));
+}
+
+/* start a chunk from the layout of its first frame */
+static void Capture_Begin(ADS1263_CAPTURE *c, const ADS1263_FRAME *Frame)
+{
+    ADS1263_CAPTURE_CHUNK *h = (ADS1263_CAPTURE_CHUNK *)c->Chunk;
+    ADS1263_CAPTURE_CHIP *chip = (ADS1263_CAPTURE_CHIP *)(h + 1);
+    UBYTE n, i;
+
+    memset(h, 0, sizeof(*h) + Frame->Header.ChipCount * sizeof(*chip));
+    h->Magic = ADS1263_CAPTURE_CHUNK_MAGIC;
+    h->Version = ADS1263_CAPTURE_VERSION;
+    h->ChipCount = Frame->Header.ChipCount;
+    h->CalState = Frame->Header.CalState;
+    h->Epoch = Frame->Header.Epoch;
+    h->Codec = ADS1263_CODEC_RAW;
+    h->FirstSequence = Frame->Header.Sequence;
+    h->FirstTime_ns = Frame->Header.Time_ns;
+
+    for(n = 0; n < h->ChipCount; n++, chip++) {
+        strncpy(chip->Name, c->Map->Chip[n].Name, ADS1263_MAP_NAME - 1);
+        chip->Ref = ADS1263_GetRef(n);
+        chip->Slots = Frame->Count[n];
+        chip->Bus = c->Map->Chip[n].Bus;
+        chip->CS = c->Map->Chip[n].CS;
+        for(i = 0; i < chip->Slots; i++) {
+            chip->Input[i] = Frame->Channel[n][i];
+            chip->Adc[i] = i < c->Scan->Chip[n].Count ? 1 : 2;
+            strncpy(chip->Channel[i], ADS1263_Map_Name(c->Map, n, i), ADS1263_MAP_NAME - 1);
+        }
+        h->Slots += chip->Slots;
+    }
+}
+
+/* code the sections after the chip map; returns the size of the coded chunk */
+static size_t Capture_Encode(ADS1263_CAPTURE *c, const ADS1263_CAPTURE_LAYOUT *l)
+{
+    const ADS1263_CAPTURE_CHUNK *h = (const ADS1263_CAPTURE_CHUNK *)c->Chunk;
+    const ADS1263_CAPTURE_RECORD *r = (const ADS1263_CAPTURE_RECORD *)(c->Chunk + l->Record);
+    const uint64_t *chiptime = (const uint64_t *)(c->Chunk + l->ChipTime);
+    const UDOUBLE n = h->Frames;
+    UDOUBLE *table = (UDOUBLE *)(c->Encoded + l->Record);
+    UDOUBLE *flags = (UDOUBLE *)c->Column;
+    UDOUBLE f, k = 0;
+    size_t p;
+    UWORD s;
+    UBYTE chip;
+
+    memcpy(c->Encoded, c->Chunk, l->Record);
+    p = ADS1263_CAPTURE_STREAMS(h->ChipCount, h->Slots) * sizeof(UDOUBLE);
+#define STREAM(expr)    do { table[k++] = (UDOUBLE)p; p += (expr); } while(0)
+    for(f = 0; f < n; f++) c->Column[f] = r[f].Sequence;
+    STREAM(ADS1263_Codec_Encode64(c->Column, n, (UBYTE *)table + p));
+    for(f = 0; f < n; f++) c->Column[f] = r[f].Time_ns;
+    STREAM(ADS1263_Codec_Encode64(c->Column, n, (UBYTE *)table + p));
+    for(f = 0; f < n; f++) c->Column[f] = r[f].Start_ns;
+    STREAM(ADS1263_Codec_Encode64(c->Column, n, (UBYTE *)table + p));
+    for(f = 0; f < n; f++) c->Column[f] = r[f].End_ns;
+    STREAM(ADS1263_Codec_Encode64(c->Column, n, (UBYTE *)table + p));
+    for(f = 0; f < n; f++) flags[f] = r[f].Flags;
+    STREAM(ADS1263_Codec_Encode32(flags, n, (UBYTE *)table + p, 0));
+    for(chip = 0; chip < h->ChipCount; chip++) {
+        for(f = 0; f < n; f++) c->Column[f] = chiptime[(size_t)f * h->ChipCount + chip];
+        STREAM(ADS1263_Codec_Encode64(c->Column, n, (UBYTE *)table + p));
+    }
+    for(s = 0; s < h->Slots; s++)
+        STREAM(ADS1263_Codec_Encode32((const UDOUBLE *)(c->Chunk + l->Code) + (size_t)s * n, n, (UBYTE *)table + p, 1));
+    for(s = 0; s < h->Slots; s++)
+        STREAM(ADS1263_Codec_Encode8(c->Chunk + l->Status + (size_t)s * n, n, (UBYTE *)table + p));
+#undef STREAM
+    while(p % 8 != 0)
+        ((UBYTE *)table)[p++] = 0;
+    ((ADS1263_CAPTURE_CHUNK *)c->Encoded)->Codec = ADS1263_CODEC_DELTA;
+    ((ADS1263_CAPTURE_CHUNK *)c->Encoded)->Payload = (UDOUBLE)p;
+    ((ADS1263_CAPTURE_CHUNK *)c->Encoded)->Size = (UDOUBLE)(l->Record + p);
+    return l->Record + p;
+}
+
+/* remember where a chunk ends in the file and the sweep after it */
+static void Capture_Pending(ADS1263_CAPTURE *c, uint64_t End, uint64_t Next)
+{
+    // Full: fold into the newest entry, which only makes Saved lag a little more
+    if(c->PendHead - c->PendTail == ADS1263_CAPTURE_PENDING)
+        c->PendHead--;
+    c->PendEnd[c->PendHead % ADS1263_CAPTURE_PENDING] = End;
+    c->PendNext[c->PendHead % ADS1263_CAPTURE_PENDING] = Next;
+    c->PendHead++;
+}
+
+/* close the chunk in the buffer and hand it to the writer */
+static UBYTE Capture_Flush(ADS1263_CAPTURE *c)
+{
+    ADS1263_CAPTURE_CHUNK *h = (ADS1263_CAPTURE_CHUNK *)c->Chunk;
+    ADS1263_CAPTURE_LAYOUT full, used;
+    ADS1263_CAPTURE_INDEX *x;
+    uint64_t offset;
+    UWORD s;
+
+    if(c->Frames == 0)
+        return 0;
+    // Sections were filled at full-chunk spacing; close the gaps of a short chunk
+    ADS1263_Capture_Layout(h->ChipCount, h->Slots, c->Config.ChunkFrames, &full);
+    ADS1263_Capture_Layout(h->ChipCount, h->Slots, c->Frames, &used);
+    if(c->Frames < c->Config.ChunkFrames) {
+        memmove(c->Chunk + used.ChipTime, c->Chunk + full.ChipTime, (size_t)c->Frames * h->ChipCount * sizeof(uint64_t));
+        for(s = 0; s < h->Slots; s++)
+            memmove(c->Chunk + used.Code + (size_t)s * c->Frames * sizeof(UDOUBLE),
+                    c->Chunk + full.Code + (size_t)s * c->Config.ChunkFrames * sizeof(UDOUBLE), (size_t)c->Frames * sizeof(UDOUBLE));
+        for(s = 0; s < h->Slots; s++)
+            memmove(c->Chunk + used.Status + (size_t)s * c->Frames,
+                    c->Chunk + full.Status + (size_t)s * c->Config.ChunkFrames, c->Frames);
+    }
+    memset(c->Chunk + used.Status + (size_t)c->Frames * h->Slots, 0, used.End - used.Status - (size_t)c->Frames * h->Slots);
+    h->Frames = c->Frames;
+    h->Size = (UDOUBLE)used.End;
+    h->Payload = (UDOUBLE)(used.End - used.Record);
+    h->LastTime_ns = ((ADS1263_CAPTURE_RECORD *)(c->Chunk + used.Record))[c->Frames - 1].Time_ns;
+    c->Frames = 0;
+    if(c->Config.Codec == ADS1263_CODEC_DELTA) {
+        Capture_Encode(c, &used);
+        h = (ADS1263_CAPTURE_CHUNK *)c->Encoded;
+    }
+
+    offset = ADS1263_Writer_Offset(&c->Writer);
+    if(ADS1263_Writer_Write(&c->Writer, h, h->Size) != 0) {
+        // Not in the file: Saved must stop short of it from now on
+        if(c->Lost == UINT64_MAX)
+            c->Lost = h->FirstSequence;
+        c->Stats.Dropped++;
+        return 1;
+    }
+    Capture_Pending(c, offset + h->Size, h->FirstSequence + h->Frames);
+    c->Unpushed += h->Frames;
+    if(c->Config.PushFrames > 0 && c->Unpushed >= c->Config.PushFrames) {
+        ADS1263_Writer_Push(&c->Writer);
+        c->Unpushed = 0;
+    }
+    c->Stats.Chunks++;
+    if(c->Count >= c->Config.MaxChunks) {
+        c->Stats.Unindexed++;
+        return 0;
+    }
+    x = &c->Index[c->Count++];
+    memset(x, 0, sizeof(*x));
+    x->Offset = offset;
+    x->FirstTime_ns = h->FirstTime_ns;
+    x->LastTime_ns = h->LastTime_ns;
+    x->FirstSequence = h->FirstSequence;
+    x->Frames = h->Frames;
+    x->Epoch = h->Epoch;
+    x->CalState = h->CalState;
+    x->Codec = h->Codec;
+    x->Slots = h->Slots;
+    x->Size = h->Size;
+    c->Indexed += h->Frames;
+    return 0;
+}
+
+UBYTE ADS1263_Capture_Append(ADS1263_CAPTURE *c, const ADS1263_FRAME *Frame)
+{
+    ADS1263_CAPTURE_CHUNK *h = (ADS1263_CAPTURE_CHUNK *)c->Chunk;
+    const ADS1263_CAPTURE_CHIP *chip = (const ADS1263_CAPTURE_CHIP *)(h + 1);
+    ADS1263_CAPTURE_RECORD *r;
+    ADS1263_CAPTURE_LAYOUT l;
+    UDOUBLE f;
+    UBYTE ret = 0, n, i;
+    UWORD s;
+
+    // A chunk never mixes epochs, calibration states or channel layouts
+    if(c->Frames > 0) {
+        UBYTE same = Frame->Header.Epoch == h->Epoch && Frame->Header.CalState == h->CalState &&
+                     Frame->Header.ChipCount == h->ChipCount;
+        for(n = 0; same && n < h->ChipCount; n++)
+            same = Frame->Count[n] == chip[n].Slots;
+        if(!same)
+            ret = Capture_Flush(c);
+    }
+    if(c->Frames == 0)
+        Capture_Begin(c, Frame);
+    if(c->Stats.Frames == 0)
+        c->Saved = Frame->Header.Sequence;
+
+    f = c->Frames;
+    ADS1263_Capture_Layout(h->ChipCount, h->Slots, c->Config.ChunkFrames, &l);
+    r = (ADS1263_CAPTURE_RECORD *)(c->Chunk + l.Record) + f;
+    r->Sequence = Frame->Header.Sequence;
+    r->Time_ns  = Frame->Header.Time_ns;
+    r->Start_ns = Frame->Header.Start_ns;
+    r->End_ns   = Frame->Header.End_ns;
+    r->Flags    = Frame->Header.Flags;
+    r->Reserved = 0;
+    h->Flags |= Frame->Header.Flags;
+    memcpy(c->Chunk + l.ChipTime + (size_t)f * h->ChipCount * sizeof(uint64_t), Frame->ChipTime_ns, h->ChipCount * sizeof(uint64_t));
+
+    s = 0;
+    for(n = 0; n < h->ChipCount; n++) {
+        for(i = 0; i < chip[n].Slots; i++, s++) {
+            ((UDOUBLE *)(c->Chunk + l.Code))[(size_t)s * c->Config.ChunkFrames + f] = Frame->Code[n][i];
+            c->Chunk[l.Status + (size_t)s * c->Config.ChunkFrames + f] = Frame->Status[n][i];
+        }
+    }
+    c->Stats.Frames++;
+    if(++c->Frames == c->Config.ChunkFrames)
+        ret |= Capture_Flush(c);
+    return ret;
+}
+
+UBYTE ADS1263_Capture_Close(ADS1263_CAPTURE *c)
+{
+    ADS1263_CAPTURE_TRAILER t;
+    UBYTE ret;
+
+    Capture_Flush(c);
+    memset(&t, 0, sizeof(t));
+    t.Magic = ADS1263_CAPTURE_INDEX_MAGIC;
+    t.Count = c->Count;
+    t.Offset = ADS1263_Writer_Offset(&c->Writer);
+    t.Frames = c->Indexed;
+    ret = ADS1263_Writer_WriteWait(&c->Writer, c->Index, (size_t)c->Count * sizeof(ADS1263_CAPTURE_INDEX));
+    ret |= ADS1263_Writer_WriteWait(&c->Writer, &t, sizeof(t));
+    ret |= ADS1263_Writer_Close(&c->Writer);
+    ADS1263_Writer_GetStats(&c->Writer, &c->Stats.Disk);
+    return ret;
+}
+
+uint64_t ADS1263_Capture_Saved(ADS1263_CAPTURE *c)
+{
+    uint64_t durable = ADS1263_Writer_Durable(&c->Writer);
+
+    while(c->PendTail != c->PendHead && c->PendEnd[c->PendTail % ADS1263_CAPTURE_PENDING] <= durable) {
+        c->Saved = c->PendNext[c->PendTail % ADS1263_CAPTURE_PENDING];
+        c->PendTail++;
+    }
+    return c->Saved < c->Lost ? c->Saved : c->Lost;
+}
+
+void ADS1263_Capture_GetStats(const ADS1263_CAPTURE *c, ADS1263_CAPTURE_STATS *Stats)
+{
+    *Stats = c->Stats;
+    if(c->Writer.Fd >= 0)
+        ADS1263_Writer_GetStats(&c->Writer, &Stats->Disk);
+}
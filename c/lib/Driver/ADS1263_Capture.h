@@ -0,0 +1,435 @@
+/*****************************************************************************
+* | File        :   ADS1263_Capture.h
+* | Author      :   Highz team
+* | Function    :   Chunked, indexed capture file
+* | Info        :
+*----------------
+* | This version:   V1.0
+* | Date        :   2026-10-19
+* | Info        :
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documnetation files (the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to  whom the Software is
+# furished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included in
+# all copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS OR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+# THE SOFTWARE.
+#
+******************************************************************************/
+#ifndef _ADS1263_CAPTURE_H_
+#define _ADS1263_CAPTURE_H_
+
+#include "ADS1263.h"
+#include "ADS1263_Map.h"
+#include "ADS1263_Writer.h"
+#include "ADS1263_Codec.h"
+
+/******************************************************************************
+Capture File
+
+A capture is a sequence of self-describing chunks followed by an index, so
+a reader can mmap a multi-day file and go straight to a time range or a
+channel without parsing anything before it:
+
+    +----------------------------+  offset 0
+    | File header (64 bytes)     |  magic, version, chunk size
+    +----------------------------+
+    | Chunk 0                    |  ADS1263_CAPTURE_CHUNK, see below
+    | Chunk 1                    |
+    | ...                        |
+    +----------------------------+
+    | Index[Count]               |  ADS1263_CAPTURE_INDEX per chunk
+    | Trailer (32 bytes)         |  magic, Count, offset of the index
+    +----------------------------+  end of file
+
+A chunk holds up to ChunkFrames consecutive sweeps taken under one
+configuration epoch and one calibration state; a change of either starts
+a new chunk. It carries everything needed to interpret it:
+
+    Chunk header (64 bytes)     frames, epoch, state, time span, sizes
+    Chip[ChipCount]             names, reference, inputs and channel names
+    Record[Frames]              per-sweep sequence, timestamps, flags
+    ChipTime[Frames][ChipCount] scan start of each chip
+    Code[Slots][Frames]         one column of raw codes per channel
+    Status[Slots][Frames]       one column of ADS1263_SAMPLE_* flags
+
+Columns are stored channel by channel, so one channel of a chunk is one
+contiguous run; volts follow from Code and Chip.Ref (ADS1263_CodeToVolt).
+
+With ADS1263_CODEC_DELTA (the default) everything after the chip map is
+coded with ADS1263_Codec instead, as independent streams behind a table of
+their offsets, so a single channel can still be decoded on its own:
+
+    Offset[Streams]             UDOUBLE, from the start of the table
+    Sequence, Time_ns, Start_ns, End_ns   64-bit streams of the records
+    Flags                       32-bit stream, no delta
+    ChipTime per chip           64-bit streams
+    Code per column             32-bit delta streams
+    Status per column           8-bit streams
+
+Readers see the same sections either way: ADS1263_Capture_View decodes a
+coded chunk into the view's own buffer.
+Chunks are listed in time order, so ADS1263_Capture_Seek is a binary
+search over the index and ADS1263_Capture_FrameAt one over a chunk's
+records. A file whose index was never written (power loss) is still
+readable: the chunks are walked once when it is opened.
+
+The producer side runs in the acquisition loop: frames are appended into
+an arena buffer and each finished chunk goes to an ADS1263_WRITER. A chunk
+the writer has to drop is left out of the index, which stays consistent.
+ADS1263_Capture_Saved tells which sweeps have reached the file, so a
+producer that keeps sweeps elsewhere (the shared-memory ring) knows which
+ones a restart would still have to write. It never moves past a dropped
+chunk or a failed write.
+******************************************************************************/
+#define ADS1263_CAPTURE_MAGIC       0x46435A48  // "HZCF"
+#define ADS1263_CAPTURE_CHUNK_MAGIC 0x4B435A48  // "HZCK"
+#define ADS1263_CAPTURE_INDEX_MAGIC 0x58495A48  // "HZIX"
+#define ADS1263_CAPTURE_VERSION     1
+#define ADS1263_CAPTURE_PENDING     64          // Chunks tracked on their way to the disk
+
+// Streams of a coded chunk: Sequence, Time_ns, Start_ns, End_ns, Flags,
+// one chip time per chip, then a code and a status stream per column
+#define ADS1263_CAPTURE_RECORD_STREAMS  5
+#define ADS1263_CAPTURE_STREAMS(ChipCount, Slots)   (ADS1263_CAPTURE_RECORD_STREAMS + (ChipCount) + 2u * (Slots))
+
+typedef enum
+{
+    ADS1263_CODEC_RAW = 0,      // Sections stored as laid out above
+    ADS1263_CODEC_DELTA,        // Sections as ADS1263_Codec streams
+}ADS1263_CODEC;
+
+typedef struct
+{
+    UDOUBLE  Magic;         // ADS1263_CAPTURE_MAGIC
+    UWORD    Version;       // ADS1263_CAPTURE_VERSION
+    UWORD    HeaderSize;    // sizeof(ADS1263_CAPTURE_FILE)
+    UDOUBLE  ChunkFrames;   // Most frames per chunk
+    UDOUBLE  Reserved0;
+    uint64_t Created_ns;    // CLOCK_REALTIME when the file was opened
+    UDOUBLE  Reserved[10];
+} ADS1263_CAPTURE_FILE;
+
+typedef struct
+{
+    UDOUBLE  Magic;         // ADS1263_CAPTURE_CHUNK_MAGIC
+    UWORD    Version;
+    UBYTE    ChipCount;
+    UBYTE    CalState;      // Calibration state of every frame in the chunk
+    UDOUBLE  Size;          // Bytes from this header to the next chunk
+    UDOUBLE  Frames;
+    UDOUBLE  Epoch;         // Configuration epoch of every frame in the chunk
+    UDOUBLE  Flags;         // OR of the frame flags
+    UWORD    Slots;         // Columns, the sum of Chip[].Slots
+    UBYTE    Codec;         // ADS1263_CODEC of the columns
+    UBYTE    Reserved0;
+    UDOUBLE  Payload;       // Bytes after the chip map as stored
+    uint64_t FirstSequence;
+    uint64_t FirstTime_ns;  // CLOCK_REALTIME of the first and last sweep
+    uint64_t LastTime_ns;
+    UDOUBLE  Reserved[2];
+} ADS1263_CAPTURE_CHUNK;
+
+typedef struct
+{
+    char     Name[ADS1263_MAP_NAME];
+    double   Ref;           // Reference voltage for code to volt conversion
+    UBYTE    Slots;         // Channels of this chip
+    UBYTE    Bus;
+    UWORD    CS;
+    UDOUBLE  Reserved;
+    UBYTE    Input[ADS1263_FRAME_STRIDE];   // AINx or ADS1263_INPUT_* per slot
+    UBYTE    Adc[ADS1263_FRAME_STRIDE];     // Converter per slot, 1 or 2
+    char     Channel[ADS1263_FRAME_STRIDE][ADS1263_MAP_NAME];
+} ADS1263_CAPTURE_CHIP;
+
+typedef struct
+{
+    uint64_t Sequence;
+    uint64_t Time_ns;       // Header fields of the sweep frame
+    uint64_t Start_ns;
+    uint64_t End_ns;
+    UDOUBLE  Flags;
+    UDOUBLE  Reserved;
+} ADS1263_CAPTURE_RECORD;
+
+typedef struct
+{
+    uint64_t Offset;        // File offset of the chunk header
+    uint64_t FirstTime_ns;
+    uint64_t LastTime_ns;
+    uint64_t FirstSequence;
+    UDOUBLE  Frames;
+    UDOUBLE  Epoch;
+    UBYTE    CalState;
+    UBYTE    Codec;
+    UWORD    Slots;
+    UDOUBLE  Size;
+} ADS1263_CAPTURE_INDEX;
+
+typedef struct
+{
+    UDOUBLE  Magic;         // ADS1263_CAPTURE_INDEX_MAGIC
+    UDOUBLE  Count;         // Index entries
+    uint64_t Offset;        // File offset of Index[0]
+    uint64_t Frames;        // Frames in all indexed chunks
+    uint64_t Reserved;
+} ADS1263_CAPTURE_TRAILER;
+
+_Static_assert(sizeof(ADS1263_CAPTURE_FILE) == 64, "capture file header is 64 bytes");
+_Static_assert(sizeof(ADS1263_CAPTURE_CHUNK) == 64, "capture chunk header is 64 bytes");
+_Static_assert(sizeof(ADS1263_CAPTURE_INDEX) == 48, "capture index entry is 48 bytes");
+_Static_assert(sizeof(ADS1263_CAPTURE_TRAILER) == 32, "capture trailer is 32 bytes");
+
+/* section offsets of an uncoded chunk, from its header */
+typedef struct
+{
+    size_t Record, ChipTime, Code, Status, End;
+} ADS1263_CAPTURE_LAYOUT;
+
+typedef struct
+{
+    ADS1263_WRITER_CONFIG Writer;
+    UDOUBLE  ChunkFrames;   // Frames per full chunk
+    UDOUBLE  MaxChunks;     // Index entries kept; later chunks are found by walking
+    ADS1263_CODEC Codec;    // How chunks are stored
+    UDOUBLE  PushFrames;    // Queue the writer buffer once it holds this many
+                            // frames instead of waiting for it to fill; 0 = off
+} ADS1263_CAPTURE_CONFIG;
+
+typedef struct
+{
+    uint64_t Frames;        // Appended
+    uint64_t Chunks;        // Handed to the writer
+    uint64_t Dropped;       // Chunks the writer refused
+    uint64_t Unindexed;     // Chunks written past MaxChunks
+    ADS1263_WRITER_STATS Disk;
+} ADS1263_CAPTURE_STATS;
+
+typedef struct
+{
+    ADS1263_WRITER Writer;
+    ADS1263_CAPTURE_CONFIG Config;
+    const ADS1263_MAP *Map;         // Channel names
+    const ADS1263_SCAN *Scan;       // Converter of each slot
+    UBYTE   *Chunk;                 // Chunk being assembled
+    size_t   ChunkMax;
+    UBYTE   *Encoded;               // Coded copy of Chunk
+    uint64_t *Column;               // One record field, gathered for coding
+    UDOUBLE  Frames;                // Frames in Chunk
+    ADS1263_CAPTURE_INDEX *Index;
+    UDOUBLE  Count;                 // Index entries in use
+    uint64_t Indexed;               // Frames in indexed chunks
+    UDOUBLE  Unpushed;              // Frames in the writer buffer being filled
+    // Chunks handed to the writer and not known to be written yet
+    uint64_t PendEnd[ADS1263_CAPTURE_PENDING];     // File offset the chunk ends at
+    uint64_t PendNext[ADS1263_CAPTURE_PENDING];    // Sequence after its last frame
+    UDOUBLE  PendHead, PendTail;
+    uint64_t Saved;                 // See ADS1263_Capture_Saved
+    uint64_t Lost;                  // First sweep of the oldest dropped chunk, UINT64_MAX if none
+    ADS1263_CAPTURE_STATS Stats;
+} ADS1263_CAPTURE;
+
+typedef struct
+{
+    int      Fd;
+    const UBYTE *Base;              // Whole file, mapped read-only
+    size_t   Size;
+    const ADS1263_CAPTURE_INDEX *Index;
+    UDOUBLE  Count;                 // Chunks
+    UBYTE    Complete;              // Index came from the trailer
+    ADS1263_CAPTURE_INDEX *Built;   // Index rebuilt by walking, if not
+} ADS1263_CAPTURE_READER;
+
+typedef struct
+{
+    const ADS1263_CAPTURE_CHUNK *Header;
+    const ADS1263_CAPTURE_CHIP *Chip;
+    const ADS1263_CAPTURE_RECORD *Record;
+    const uint64_t *ChipTime;       // [frame * ChipCount + chip]
+    const UDOUBLE *Code;            // [column * Frames + frame]
+    const UBYTE *Status;            // [column * Frames + frame]
+    UWORD    First[ADS1263_MAX_CHIPS];  // Column of each chip's slot 0
+    UBYTE   *Scratch;               // Decoded chunk, grown as needed
+    size_t   ScratchSize;
+} ADS1263_CAPTURE_VIEW;
+
+/******************************************************************************
+function:   Default configuration
+parameter:
+    Config: Receives 1024-frame delta-coded chunks, 65536 index entries
+            and the writer defaults
+Info:
+******************************************************************************/
+void ADS1263_Capture_Defaults(ADS1263_CAPTURE_CONFIG *Config);
+
+/******************************************************************************
+function:   Arena bytes a capture needs
+parameter:
+    Config: Capture configuration
+Info:
+    Add to the Reserve given to ADS1263_Session_Open
+******************************************************************************/
+size_t ADS1263_Capture_Reserve(const ADS1263_CAPTURE_CONFIG *Config);
+
+/******************************************************************************
+function:   Create a capture file
+parameter:
+    Capture: Capture state, usually static
+    Session: Open session; buffers come from its arena, slots from its scan table
+    Path: File to create
+    Map: Map the scan table was compiled from, for the channel names
+    Config: Capture configuration
+Info:
+    Returns 0 on success, 1 on failure
+******************************************************************************/
+UBYTE ADS1263_Capture_Open(ADS1263_CAPTURE *Capture, ADS1263_SESSION *Session, const char *Path,
+                           const ADS1263_MAP *Map, const ADS1263_CAPTURE_CONFIG *Config);
+
+/******************************************************************************
+function:   Append one sweep
+parameter:
+    Capture: Open capture
+    Frame: Finished frame
+Info:
+    Never blocks. Returns 0, or 1 if a finished chunk was dropped
+******************************************************************************/
+UBYTE ADS1263_Capture_Append(ADS1263_CAPTURE *Capture, const ADS1263_FRAME *Frame);
+
+/******************************************************************************
+function:   Write the last chunk and the index, close the file
+parameter:
+    Capture: Open capture
+Info:
+    Returns 0 if everything reached the disk
+******************************************************************************/
+UBYTE ADS1263_Capture_Close(ADS1263_CAPTURE *Capture);
+
+/******************************************************************************
+function:   Sweeps that have reached the file
+parameter:
+    Capture: Open capture
+Info:
+    Returns the sequence number of the first sweep not yet written: every
+    earlier sweep is in the file. A dropped chunk or a failed write holds
+    it there for the rest of the capture. Cheap enough to call after every
+    append
+******************************************************************************/
+uint64_t ADS1263_Capture_Saved(ADS1263_CAPTURE *Capture);
+
+/******************************************************************************
+function:   Read the capture counters
+parameter:
+    Capture: Open or closed capture
+    Stats: Receives the counters
+Info:
+******************************************************************************/
+void ADS1263_Capture_GetStats(const ADS1263_CAPTURE *Capture, ADS1263_CAPTURE_STATS *Stats);
+
+/******************************************************************************
+function:   Section offsets of a chunk
+parameter:
+    ChipCount, Slots, Frames: From the chunk header
+    Layout: Receives the offsets as stored by ADS1263_CODEC_RAW
+Info:
+    End is rounded up to 8 bytes, like every chunk size. The reader side
+    (ADS1263_CaptureRead.c) only needs ADS1263_Codec and links without
+    the hardware layer, for offline tools
+******************************************************************************/
+void ADS1263_Capture_Layout(UBYTE ChipCount, UWORD Slots, UDOUBLE Frames, ADS1263_CAPTURE_LAYOUT *Layout);
+
+/******************************************************************************
+function:   Map a capture file for reading
+parameter:
+    Reader: Reader state
+    Path: Capture file
+Info:
+    Uses the trailing index, or walks the chunks once if there is none
+    Returns 0 on success, 1 if the file is not a capture
+******************************************************************************/
+UBYTE ADS1263_Capture_OpenRead(ADS1263_CAPTURE_READER *Reader, const char *Path);
+
+/******************************************************************************
+function:   Find the chunk holding a point in time
+parameter:
+    Reader: Open reader
+    Time_ns: CLOCK_REALTIME in ns
+Info:
+    Returns the first chunk ending at or after Time_ns, Count if none does
+******************************************************************************/
+UDOUBLE ADS1263_Capture_Seek(const ADS1263_CAPTURE_READER *Reader, uint64_t Time_ns);
+
+/******************************************************************************
+function:   Locate the sections of one chunk
+parameter:
+    Reader: Open reader
+    Chunk: Chunk number, 0 .. Count-1
+    View: Receives pointers into the mapping or into View->Scratch
+Info:
+    Zero the view before its first use and release it with
+    ADS1263_Capture_ViewFree; one view can be reused for many chunks
+    Returns 0 on success, 1 if the chunk is damaged or its codec unknown
+******************************************************************************/
+UBYTE ADS1263_Capture_View(const ADS1263_CAPTURE_READER *Reader, UDOUBLE Chunk, ADS1263_CAPTURE_VIEW *View);
+
+/******************************************************************************
+function:   Release the decode buffer of a view
+parameter:
+    View: View used with ADS1263_Capture_View
+Info:
+******************************************************************************/
+void ADS1263_Capture_ViewFree(ADS1263_CAPTURE_VIEW *View);
+
+/******************************************************************************
+function:   Read one code column of a chunk
+parameter:
+    Reader: Open reader
+    Chunk: Chunk number
+    Column: Column, see ADS1263_Capture_Column
+    Code: Receives Index[Chunk].Frames codes
+Info:
+    Decodes only that column of a coded chunk
+    Returns 0 on success, 1 if the chunk is damaged
+******************************************************************************/
+UBYTE ADS1263_Capture_ReadColumn(const ADS1263_CAPTURE_READER *Reader, UDOUBLE Chunk, UWORD Column, UDOUBLE *Code);
+
+/******************************************************************************
+function:   Column of a named channel
+parameter:
+    View: Chunk view
+    Name: Channel name from the map, or "<chip>.<channel>"
+Info:
+    Returns the column, or -1 if no channel has that name
+******************************************************************************/
+int ADS1263_Capture_Column(const ADS1263_CAPTURE_VIEW *View, const char *Name);
+
+/******************************************************************************
+function:   First frame of a chunk at or after a point in time
+parameter:
+    View: Chunk view
+    Time_ns: CLOCK_REALTIME in ns
+Info:
+    Returns Frames if every frame is earlier
+******************************************************************************/
+UDOUBLE ADS1263_Capture_FrameAt(const ADS1263_CAPTURE_VIEW *View, uint64_t Time_ns);
+
+/******************************************************************************
+function:   Unmap a capture file
+parameter:
+    Reader: Open reader
+Info:
+******************************************************************************/
+void ADS1263_Capture_CloseRead(ADS1263_CAPTURE_READER *Reader);
+
+#endif
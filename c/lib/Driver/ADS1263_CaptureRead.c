@@ -0,0 +1,340 @@
+/*****************************************************************************
+* | File        :   ADS1263_CaptureRead.c
+* | Author      :   Highz team
+* | Function    :   Capture file reader
+* | Info        :
+*----------------
+* | This version:   V1.0
+* | Date        :   2026-10-19
+* | Info        :
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documnetation files (the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to  whom the Software is
+# furished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included in
+# all copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS OR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+# THE SOFTWARE.
+#
+******************************************************************************/
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "ADS1263_Capture.h"
+
+void ADS1263_Capture_Layout(UBYTE ChipCount, UWORD Slots, UDOUBLE Frames, ADS1263_CAPTURE_LAYOUT *L)
+{
+    L->Record   = sizeof(ADS1263_CAPTURE_CHUNK) + (size_t)ChipCount * sizeof(ADS1263_CAPTURE_CHIP);
+    L->ChipTime = L->Record + (size_t)Frames * sizeof(ADS1263_CAPTURE_RECORD);
+    L->Code     = L->ChipTime + (size_t)Frames * ChipCount * sizeof(uint64_t);
+    L->Status   = L->Code + (size_t)Frames * Slots * sizeof(UDOUBLE);
+    L->End      = L->Status + (size_t)Frames * Slots;
+    L->End      = (L->End + 7) & ~(size_t)7;    // Keep the next chunk 8-byte aligned
+}
+
+static UBYTE Capture_ChunkOk(const ADS1263_CAPTURE_READER *r, uint64_t Offset)
+{
+    const ADS1263_CAPTURE_CHUNK *h = (const ADS1263_CAPTURE_CHUNK *)(r->Base + Offset);
+    ADS1263_CAPTURE_LAYOUT l;
+
+    if(Offset % 8 != 0 || Offset + sizeof(*h) > r->Size || h->Magic != ADS1263_CAPTURE_CHUNK_MAGIC)
+        return 1;
+    if(h->ChipCount > ADS1263_MAX_CHIPS || h->Frames == 0 || Offset + h->Size > r->Size)
+        return 1;
+    ADS1263_Capture_Layout(h->ChipCount, h->Slots, h->Frames, &l);
+    if(h->Codec == ADS1263_CODEC_DELTA)
+        return h->Payload < ADS1263_CAPTURE_STREAMS(h->ChipCount, h->Slots) * sizeof(UDOUBLE) || h->Size < l.Record + h->Payload;
+    return h->Size < l.End;
+}
+
+/* locate stream k of a coded chunk */
+static const UBYTE *Capture_Stream(const ADS1263_CAPTURE_CHUNK *h, const ADS1263_CAPTURE_LAYOUT *l, UDOUBLE k, size_t *Size)
+{
+    const UBYTE *table = (const UBYTE *)h + l->Record;
+    const UDOUBLE *offset = (const UDOUBLE *)table;
+    UDOUBLE streams = ADS1263_CAPTURE_STREAMS(h->ChipCount, h->Slots);
+    UDOUBLE end = k + 1 < streams ? offset[k + 1] : h->Payload;
+
+    if(offset[k] > end || end > h->Payload)
+        return NULL;
+    *Size = end - offset[k];
+    return table + offset[k];
+}
+
+/* decode a coded chunk into the raw layout in View->Scratch */
+static UBYTE Capture_Decode(const ADS1263_CAPTURE_CHUNK *h, ADS1263_CAPTURE_VIEW *v)
+{
+    ADS1263_CAPTURE_LAYOUT l, coded;
+    ADS1263_CAPTURE_RECORD *r;
+    const UBYTE *in;
+    uint64_t *column;
+    UDOUBLE f, k = 0;
+    size_t size;
+    UWORD s;
+    UBYTE field, chip, bad = 0;
+
+    ADS1263_Capture_Layout(h->ChipCount, h->Slots, h->Frames, &l);
+    ADS1263_Capture_Layout(h->ChipCount, h->Slots, 0, &coded);
+    // Room for the chunk plus one 64-bit column to gather records through
+    if(v->ScratchSize < l.End + (size_t)h->Frames * sizeof(uint64_t)) {
+        UBYTE *grown = realloc(v->Scratch, l.End + (size_t)h->Frames * sizeof(uint64_t));
+        if(grown == NULL)
+            return 1;
+        v->Scratch = grown;
+        v->ScratchSize = l.End + (size_t)h->Frames * sizeof(uint64_t);
+    }
+    memcpy(v->Scratch, h, l.Record);
+    r = (ADS1263_CAPTURE_RECORD *)(v->Scratch + l.Record);
+    column = (uint64_t *)(v->Scratch + l.End);
+
+#define NEXT()  ((in = Capture_Stream(h, &coded, k++, &size)) == NULL)
+    for(field = 0; !bad && field < ADS1263_CAPTURE_RECORD_STREAMS - 1; field++) {
+        if(NEXT() || ADS1263_Codec_Decode64(in, size, column, h->Frames) == 0)
+            bad = 1;
+        for(f = 0; !bad && f < h->Frames; f++) {
+            uint64_t *dst = field == 0 ? &r[f].Sequence : field == 1 ? &r[f].Time_ns :
+                            field == 2 ? &r[f].Start_ns : &r[f].End_ns;
+            *dst = column[f];
+        }
+    }
+    if(!bad && (NEXT() || ADS1263_Codec_Decode32(in, size, (UDOUBLE *)column, h->Frames, 0) == 0))
+        bad = 1;
+    for(f = 0; !bad && f < h->Frames; f++) {
+        r[f].Flags = ((UDOUBLE *)column)[f];
+        r[f].Reserved = 0;
+    }
+    for(chip = 0; !bad && chip < h->ChipCount; chip++) {
+        if(NEXT() || ADS1263_Codec_Decode64(in, size, column, h->Frames) == 0)
+            bad = 1;
+        for(f = 0; !bad && f < h->Frames; f++)
+            ((uint64_t *)(v->Scratch + l.ChipTime))[(size_t)f * h->ChipCount + chip] = column[f];
+    }
+    for(s = 0; !bad && s < h->Slots; s++) {
+        if(NEXT() || ADS1263_Codec_Decode32(in, size, (UDOUBLE *)(v->Scratch + l.Code) + (size_t)s * h->Frames, h->Frames, 1) == 0)
+            bad = 1;
+    }
+    for(s = 0; !bad && s < h->Slots; s++) {
+        if(NEXT() || ADS1263_Codec_Decode8(in, size, v->Scratch + l.Status + (size_t)s * h->Frames, h->Frames) == 0)
+            bad = 1;
+    }
+#undef NEXT
+    return bad;
+}
+
+/* build the index by following the chunk sizes from Offset */
+static void Capture_Walk(ADS1263_CAPTURE_READER *r, uint64_t Offset, uint64_t End)
+{
+    UDOUBLE room = r->Count + 1024;
+    ADS1263_CAPTURE_INDEX *x = malloc(room * sizeof(*x));
+
+    if(x == NULL)
+        return;
+    if(r->Count > 0)
+        memcpy(x, r->Index, r->Count * sizeof(*x));
+    while(Offset < End && Capture_ChunkOk(r, Offset) == 0) {
+        const ADS1263_CAPTURE_CHUNK *h = (const ADS1263_CAPTURE_CHUNK *)(r->Base + Offset);
+        if(r->Count == room) {
+            ADS1263_CAPTURE_INDEX *grown = realloc(x, (room *= 2) * sizeof(*x));
+            if(grown == NULL)
+                break;
+            x = grown;
+        }
+        memset(&x[r->Count], 0, sizeof(*x));
+        x[r->Count].Offset = Offset;
+        x[r->Count].FirstTime_ns = h->FirstTime_ns;
+        x[r->Count].LastTime_ns = h->LastTime_ns;
+        x[r->Count].FirstSequence = h->FirstSequence;
+        x[r->Count].Frames = h->Frames;
+        x[r->Count].Epoch = h->Epoch;
+        x[r->Count].CalState = h->CalState;
+        x[r->Count].Codec = h->Codec;
+        x[r->Count].Slots = h->Slots;
+        x[r->Count].Size = h->Size;
+        r->Count++;
+        Offset += h->Size;
+    }
+    r->Built = x;
+    r->Index = x;
+}
+
+UBYTE ADS1263_Capture_OpenRead(ADS1263_CAPTURE_READER *r, const char *Path)
+{
+    const ADS1263_CAPTURE_FILE *file;
+    const ADS1263_CAPTURE_TRAILER *t;
+    struct stat st;
+    uint64_t end;
+
+    memset(r, 0, sizeof(*r));
+    r->Fd = open(Path, O_RDONLY);
+    if(r->Fd < 0 || fstat(r->Fd, &st) != 0 || (size_t)st.st_size < sizeof(*file)) {
+        printf("Capture: cannot read %s \r\n", Path);
+        goto fail;
+    }
+    r->Size = (size_t)st.st_size;
+    r->Base = mmap(NULL, r->Size, PROT_READ, MAP_SHARED, r->Fd, 0);
+    if(r->Base == MAP_FAILED) {
+        r->Base = NULL;
+        goto fail;
+    }
+    file = (const ADS1263_CAPTURE_FILE *)r->Base;
+    if(file->Magic != ADS1263_CAPTURE_MAGIC || file->Version > ADS1263_CAPTURE_VERSION) {
+        printf("Capture: %s is not a capture file \r\n", Path);
+        goto fail;
+    }
+
+    end = r->Size;
+    t = (const ADS1263_CAPTURE_TRAILER *)(r->Base + r->Size - sizeof(*t));
+    if(r->Size >= file->HeaderSize + sizeof(*t) && t->Magic == ADS1263_CAPTURE_INDEX_MAGIC &&
+       t->Offset + (uint64_t)t->Count * sizeof(ADS1263_CAPTURE_INDEX) + sizeof(*t) == r->Size) {
+        r->Index = (const ADS1263_CAPTURE_INDEX *)(r->Base + t->Offset);
+        r->Count = t->Count;
+        end = t->Offset;
+        r->Complete = 1;
+    }
+    // Chunks past the index (MaxChunks reached) or no index at all: walk them
+    if(r->Count == 0)
+        Capture_Walk(r, file->HeaderSize, end);
+    else if(r->Index[r->Count - 1].Offset + r->Index[r->Count - 1].Size < end) {
+        r->Complete = 0;
+        Capture_Walk(r, r->Index[r->Count - 1].Offset + r->Index[r->Count - 1].Size, end);
+    }
+    return 0;
+fail:
+    ADS1263_Capture_CloseRead(r);
+    return 1;
+}
+
+UDOUBLE ADS1263_Capture_Seek(const ADS1263_CAPTURE_READER *r, uint64_t Time_ns)
+{
+    UDOUBLE lo = 0, hi = r->Count;
+
+    while(lo < hi) {
+        UDOUBLE mid = lo + (hi - lo) / 2;
+        if(r->Index[mid].LastTime_ns < Time_ns)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    return lo;
+}
+
+UBYTE ADS1263_Capture_View(const ADS1263_CAPTURE_READER *r, UDOUBLE Chunk, ADS1263_CAPTURE_VIEW *v)
+{
+    const UBYTE *base;
+    ADS1263_CAPTURE_LAYOUT l;
+    UWORD s = 0;
+    UBYTE n;
+
+    if(Chunk >= r->Count || Capture_ChunkOk(r, r->Index[Chunk].Offset) != 0)
+        return 1;
+    base = r->Base + r->Index[Chunk].Offset;
+    v->Header = (const ADS1263_CAPTURE_CHUNK *)base;
+    if(v->Header->Codec == ADS1263_CODEC_DELTA) {
+        if(Capture_Decode(v->Header, v) != 0)
+            return 1;
+        base = v->Scratch;
+        v->Header = (const ADS1263_CAPTURE_CHUNK *)base;
+    } else if(v->Header->Codec != ADS1263_CODEC_RAW) {
+        return 1;
+    }
+    ADS1263_Capture_Layout(v->Header->ChipCount, v->Header->Slots, v->Header->Frames, &l);
+    v->Chip = (const ADS1263_CAPTURE_CHIP *)(v->Header + 1);
+    v->Record = (const ADS1263_CAPTURE_RECORD *)(base + l.Record);
+    v->ChipTime = (const uint64_t *)(base + l.ChipTime);
+    v->Code = (const UDOUBLE *)(base + l.Code);
+    v->Status = base + l.Status;
+    for(n = 0; n < v->Header->ChipCount; n++) {
+        v->First[n] = s;
+        s += v->Chip[n].Slots;
+    }
+    return s != v->Header->Slots;
+}
+
+int ADS1263_Capture_Column(const ADS1263_CAPTURE_VIEW *v, const char *Name)
+{
+    const char *dot = strchr(Name, '.');
+    size_t len = dot ? (size_t)(dot - Name) : 0;
+    UBYTE n, i;
+
+    for(n = 0; n < v->Header->ChipCount; n++) {
+        const char *channel = Name;
+        if(dot) {
+            if(strncmp(v->Chip[n].Name, Name, len) != 0 || v->Chip[n].Name[len] != '\0')
+                continue;
+            channel = dot + 1;
+        }
+        for(i = 0; i < v->Chip[n].Slots; i++) {
+            if(strncmp(v->Chip[n].Channel[i], channel, ADS1263_MAP_NAME) == 0)
+                return v->First[n] + i;
+        }
+    }
+    return -1;
+}
+
+UDOUBLE ADS1263_Capture_FrameAt(const ADS1263_CAPTURE_VIEW *v, uint64_t Time_ns)
+{
+    UDOUBLE lo = 0, hi = v->Header->Frames;
+
+    while(lo < hi) {
+        UDOUBLE mid = lo + (hi - lo) / 2;
+        if(v->Record[mid].Time_ns < Time_ns)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    return lo;
+}
+
+void ADS1263_Capture_ViewFree(ADS1263_CAPTURE_VIEW *v)
+{
+    free(v->Scratch);
+    memset(v, 0, sizeof(*v));
+}
+
+UBYTE ADS1263_Capture_ReadColumn(const ADS1263_CAPTURE_READER *r, UDOUBLE Chunk, UWORD Column, UDOUBLE *Code)
+{
+    const ADS1263_CAPTURE_CHUNK *h;
+    ADS1263_CAPTURE_LAYOUT l;
+    const UBYTE *in;
+    size_t size;
+
+    if(Chunk >= r->Count || Capture_ChunkOk(r, r->Index[Chunk].Offset) != 0)
+        return 1;
+    h = (const ADS1263_CAPTURE_CHUNK *)(r->Base + r->Index[Chunk].Offset);
+    if(Column >= h->Slots)
+        return 1;
+    if(h->Codec == ADS1263_CODEC_RAW) {
+        ADS1263_Capture_Layout(h->ChipCount, h->Slots, h->Frames, &l);
+        memcpy(Code, (const UBYTE *)h + l.Code + (size_t)Column * h->Frames * sizeof(UDOUBLE), (size_t)h->Frames * sizeof(UDOUBLE));
+        return 0;
+    }
+    if(h->Codec != ADS1263_CODEC_DELTA)
+        return 1;
+    ADS1263_Capture_Layout(h->ChipCount, h->Slots, 0, &l);
+    in = Capture_Stream(h, &l, ADS1263_CAPTURE_RECORD_STREAMS + h->ChipCount + Column, &size);
+    return in == NULL || ADS1263_Codec_Decode32(in, size, Code, h->Frames, 1) == 0;
+}
+
+void ADS1263_Capture_CloseRead(ADS1263_CAPTURE_READER *r)
+{
+    if(r->Base != NULL)
+        munmap((void *)r->Base, r->Size);
+    if(r->Fd >= 0)
+        close(r->Fd);
+    free(r->Built);
+    memset(r, 0, sizeof(*r));
+    r->Fd = -1;
+}
@@ -0,0 +1,369 @@
+/*****************************************************************************
+* | File        :   ADS1263_Codec.c
+* | Author      :   Highz team
+* | Function    :   Lossless delta / bit-packing sample codec
+* | Info        :
+*----------------
+* | This version:   V1.0
+* | Date        :   2026-10-19
+* | Info        :
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documnetation files (the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to  whom the Software is
+# furished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included in
+# all copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS OR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+# THE SOFTWARE.
+#
+******************************************************************************/
+#include <string.h>
+#include "ADS1263_Codec.h"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+/******************************************************************************
+Four-lane vector operations shared by the packing kernels
+******************************************************************************/
+#if defined(__SSE2__)
+typedef __m128i VEC;
+#define V_LOAD(p)       _mm_loadu_si128((const __m128i *)(p))
+#define V_STORE(p, v)   _mm_storeu_si128((__m128i *)(p), (v))
+#define V_OR(a, b)      _mm_or_si128((a), (b))
+#define V_AND(a, b)     _mm_and_si128((a), (b))
+#define V_SHL(v, n)     _mm_sll_epi32((v), _mm_cvtsi32_si128(n))
+#define V_SHR(v, n)     _mm_srl_epi32((v), _mm_cvtsi32_si128(n))
+#define V_SET1(x)       _mm_set1_epi32((int)(x))
+#define V_ZERO()        _mm_setzero_si128()
+#elif defined(__ARM_NEON)
+typedef uint32x4_t VEC;
+#define V_LOAD(p)       vreinterpretq_u32_u8(vld1q_u8((const uint8_t *)(p)))
+#define V_STORE(p, v)   vst1q_u8((uint8_t *)(p), vreinterpretq_u8_u32(v))
+#define V_OR(a, b)      vorrq_u32((a), (b))
+#define V_AND(a, b)     vandq_u32((a), (b))
+#define V_SHL(v, n)     vshlq_u32((v), vdupq_n_s32(n))
+#define V_SHR(v, n)     vshlq_u32((v), vdupq_n_s32(-(n)))
+#define V_SET1(x)       vdupq_n_u32(x)
+#define V_ZERO()        vdupq_n_u32(0)
+#else
+typedef struct { UDOUBLE v[4]; } VEC;
+static inline VEC V_LOAD(const void *p) { VEC r; memcpy(r.v, p, 16); return r; }
+static inline void V_STORE(void *p, VEC a) { memcpy(p, a.v, 16); }
+static inline VEC V_OR(VEC a, VEC b) { for(int j = 0; j < 4; j++) a.v[j] |= b.v[j]; return a; }
+static inline VEC V_AND(VEC a, VEC b) { for(int j = 0; j < 4; j++) a.v[j] &= b.v[j]; return a; }
+static inline VEC V_SHL(VEC a, int n) { for(int j = 0; j < 4; j++) a.v[j] = n < 32 ? a.v[j] << n : 0; return a; }
+static inline VEC V_SHR(VEC a, int n) { for(int j = 0; j < 4; j++) a.v[j] = n < 32 ? a.v[j] >> n : 0; return a; }
+static inline VEC V_SET1(UDOUBLE x) { VEC r = {{x, x, x, x}}; return r; }
+static inline VEC V_ZERO(void) { return V_SET1(0); }
+#endif
+
+const char *ADS1263_CodecKernel(void)
+{
+#if defined(__SSE2__)
+    return "sse2";
+#elif defined(__ARM_NEON)
+    return "neon";
+#else
+    return "scalar";
+#endif
+}
+
+/* 128 values of at most Width bits -> 16 * Width bytes */
+static void Codec_Pack(const UDOUBLE *In, int Width, UBYTE *Out)
+{
+    VEC acc = V_ZERO(), v;
+    int k, off = 0;
+
+    if(Width == 0)
+        return;
+    for(k = 0; k < ADS1263_CODEC_BLOCK / 4; k++) {
+        v = V_LOAD(In + 4 * k);
+        acc = V_OR(acc, V_SHL(v, off));
+        off += Width;
+        if(off >= 32) {
+            V_STORE(Out, acc);
+            Out += 16;
+            off -= 32;
+            // High bits of v that did not fit start the next word
+            acc = off ? V_SHR(v, Width - off) : V_ZERO();
+        }
+    }
+}
+
+/* 16 * Width bytes -> 128 values */
+static void Codec_Unpack(const UBYTE *In, int Width, UDOUBLE *Out)
+{
+    VEC mask, cur, v;
+    int k, off = 0;
+
+    if(Width == 0) {
+        memset(Out, 0, ADS1263_CODEC_BLOCK * sizeof(UDOUBLE));
+        return;
+    }
+    mask = V_SET1(Width == 32 ? 0xFFFFFFFFu : (1u << Width) - 1);
+    cur = V_LOAD(In);
+    for(k = 0; k < ADS1263_CODEC_BLOCK / 4; k++) {
+        v = V_SHR(cur, off);
+        if(off + Width >= 32) {
+            int used = 32 - off;
+            In += 16;
+            if(off + Width > 32) {
+                cur = V_LOAD(In);
+                v = V_OR(v, V_SHL(cur, used));
+                off = Width - used;
+            } else {
+                off = 0;
+                if(k + 1 < ADS1263_CODEC_BLOCK / 4)
+                    cur = V_LOAD(In);
+            }
+        } else {
+            off += Width;
+        }
+        V_STORE(Out + 4 * k, V_AND(v, mask));
+    }
+}
+
+/* zigzag values -> running sum from Prev, in place; returns the last value */
+static UDOUBLE Codec_Undelta(UDOUBLE *Data, UDOUBLE Prev)
+{
+    UDOUBLE i = 0;
+
+#if defined(__SSE2__)
+    __m128i carry = _mm_set1_epi32((int)Prev), one = _mm_set1_epi32(1);
+    for(; i < ADS1263_CODEC_BLOCK; i += 4) {
+        __m128i z = _mm_loadu_si128((const __m128i *)(Data + i));
+        __m128i x = _mm_xor_si128(_mm_srli_epi32(z, 1), _mm_sub_epi32(_mm_setzero_si128(), _mm_and_si128(z, one)));
+        x = _mm_add_epi32(x, _mm_slli_si128(x, 4));
+        x = _mm_add_epi32(x, _mm_slli_si128(x, 8));
+        x = _mm_add_epi32(x, carry);
+        _mm_storeu_si128((__m128i *)(Data + i), x);
+        carry = _mm_shuffle_epi32(x, 0xFF);
+    }
+    Prev = Data[ADS1263_CODEC_BLOCK - 1];
+#elif defined(__ARM_NEON)
+    uint32x4_t carry = vdupq_n_u32(Prev), zero = vdupq_n_u32(0);
+    for(; i < ADS1263_CODEC_BLOCK; i += 4) {
+        uint32x4_t z = vld1q_u32(Data + i);
+        uint32x4_t x = veorq_u32(vshrq_n_u32(z, 1), vreinterpretq_u32_s32(vnegq_s32(vreinterpretq_s32_u32(vandq_u32(z, vdupq_n_u32(1))))));
+        x = vaddq_u32(x, vextq_u32(zero, x, 3));
+        x = vaddq_u32(x, vextq_u32(zero, x, 2));
+        x = vaddq_u32(x, carry);
+        vst1q_u32(Data + i, x);
+        carry = vdupq_n_u32(vgetq_lane_u32(x, 3));
+    }
+    Prev = Data[ADS1263_CODEC_BLOCK - 1];
+#else
+    for(; i < ADS1263_CODEC_BLOCK; i++) {
+        Prev += (Data[i] >> 1) ^ (0u - (Data[i] & 1));
+        Data[i] = Prev;
+    }
+#endif
+    return Prev;
+}
+
+static int Codec_Width(UDOUBLE Bits)
+{
+    return Bits ? 32 - __builtin_clz(Bits) : 0;
+}
+
+size_t ADS1263_Codec_Bound(UDOUBLE Number, UBYTE Bytes)
+{
+    size_t blocks = (Number + ADS1263_CODEC_BLOCK - 1) / ADS1263_CODEC_BLOCK;
+    size_t block = Bytes == 8 ? ADS1263_CODEC_BLOCK * 8 : 16 * (Bytes == 1 ? 8 : 32);
+    return 8 + blocks * (1 + block);
+}
+
+size_t ADS1263_Codec_Encode32(const UDOUBLE *In, UDOUBLE Number, UBYTE *Out, UBYTE Delta)
+{
+    UDOUBLE tmp[ADS1263_CODEC_BLOCK];
+    UDOUBLE prev = Number ? In[0] : 0, bits, b, i;
+    UBYTE *o = Out;
+    int width;
+
+    if(Delta) {
+        memcpy(o, &prev, 4);
+        o += 4;
+    }
+    for(b = 0; b < Number; b += ADS1263_CODEC_BLOCK) {
+        bits = 0;
+        for(i = 0; i < ADS1263_CODEC_BLOCK; i++) {
+            UDOUBLE x = 0;
+            if(b + i < Number) {
+                x = In[b + i];
+                if(Delta) {
+                    int32_t d = (int32_t)(x - prev);
+                    prev = In[b + i];
+                    x = ((UDOUBLE)d << 1) ^ (UDOUBLE)(d >> 31);
+                }
+            }
+            tmp[i] = x;
+            bits |= x;
+        }
+        width = Codec_Width(bits);
+        *o++ = (UBYTE)width;
+        Codec_Pack(tmp, width, o);
+        o += 16 * width;
+    }
+    return (size_t)(o - Out);
+}
+
+size_t ADS1263_Codec_Decode32(const UBYTE *In, size_t Size, UDOUBLE *Out, UDOUBLE Number, UBYTE Delta)
+{
+    UDOUBLE tmp[ADS1263_CODEC_BLOCK];
+    const UBYTE *p = In, *end = In + Size;
+    UDOUBLE prev = 0, b;
+
+    if(Delta) {
+        if(Size < 4)
+            return 0;
+        memcpy(&prev, p, 4);
+        p += 4;
+    }
+    for(b = 0; b < Number; b += ADS1263_CODEC_BLOCK) {
+        UDOUBLE n = Number - b < ADS1263_CODEC_BLOCK ? Number - b : ADS1263_CODEC_BLOCK;
+        UDOUBLE *dst = n == ADS1263_CODEC_BLOCK ? Out + b : tmp;
+        int width;
+        if(p >= end || (width = *p++) > 32 || (size_t)(end - p) < (size_t)16 * width)
+            return 0;
+        Codec_Unpack(p, width, dst);
+        p += 16 * width;
+        if(Delta)
+            prev = Codec_Undelta(dst, prev);
+        if(dst == tmp)
+            memcpy(Out + b, tmp, n * sizeof(UDOUBLE));
+    }
+    return (size_t)(p - In);
+}
+
+size_t ADS1263_Codec_Encode64(const uint64_t *In, UDOUBLE Number, UBYTE *Out)
+{
+    uint64_t wide[ADS1263_CODEC_BLOCK];
+    UDOUBLE tmp[ADS1263_CODEC_BLOCK];
+    uint64_t prev = Number ? In[0] : 0, bits;
+    UBYTE *o = Out;
+    UDOUBLE b, i;
+    int width;
+
+    memcpy(o, &prev, 8);
+    o += 8;
+    for(b = 0; b < Number; b += ADS1263_CODEC_BLOCK) {
+        bits = 0;
+        for(i = 0; i < ADS1263_CODEC_BLOCK; i++) {
+            uint64_t z = 0;
+            if(b + i < Number) {
+                int64_t d = (int64_t)(In[b + i] - prev);
+                prev = In[b + i];
+                z = ((uint64_t)d << 1) ^ (uint64_t)(d >> 63);
+            }
+            wide[i] = z;
+            bits |= z;
+        }
+        // A clock step or a gap in the sweeps: keep the block as it is
+        if(bits >> 32) {
+            *o++ = ADS1263_CODEC_RAW64;
+            memcpy(o, wide, sizeof(wide));
+            o += sizeof(wide);
+            continue;
+        }
+        for(i = 0; i < ADS1263_CODEC_BLOCK; i++)
+            tmp[i] = (UDOUBLE)wide[i];
+        width = Codec_Width((UDOUBLE)bits);
+        *o++ = (UBYTE)width;
+        Codec_Pack(tmp, width, o);
+        o += 16 * width;
+    }
+    return (size_t)(o - Out);
+}
+
+size_t ADS1263_Codec_Decode64(const UBYTE *In, size_t Size, uint64_t *Out, UDOUBLE Number)
+{
+    uint64_t wide[ADS1263_CODEC_BLOCK];
+    UDOUBLE tmp[ADS1263_CODEC_BLOCK];
+    const UBYTE *p = In, *end = In + Size;
+    uint64_t prev;
+    UDOUBLE b, i;
+
+    if(Size < 8)
+        return 0;
+    memcpy(&prev, p, 8);
+    p += 8;
+    for(b = 0; b < Number; b += ADS1263_CODEC_BLOCK) {
+        UDOUBLE n = Number - b < ADS1263_CODEC_BLOCK ? Number - b : ADS1263_CODEC_BLOCK;
+        int width;
+        if(p >= end)
+            return 0;
+        width = *p++;
+        if(width == ADS1263_CODEC_RAW64) {
+            if((size_t)(end - p) < sizeof(wide))
+                return 0;
+            memcpy(wide, p, sizeof(wide));
+            p += sizeof(wide);
+        } else {
+            if(width > 32 || (size_t)(end - p) < (size_t)16 * width)
+                return 0;
+            Codec_Unpack(p, width, tmp);
+            p += 16 * width;
+            for(i = 0; i < n; i++)
+                wide[i] = tmp[i];
+        }
+        for(i = 0; i < n; i++) {
+            prev += (wide[i] >> 1) ^ (0 - (wide[i] & 1));
+            Out[b + i] = prev;
+        }
+    }
+    return (size_t)(p - In);
+}
+
+size_t ADS1263_Codec_Encode8(const UBYTE *In, UDOUBLE Number, UBYTE *Out)
+{
+    UDOUBLE tmp[ADS1263_CODEC_BLOCK];
+    UBYTE *o = Out;
+    UDOUBLE b, i, bits;
+    int width;
+
+    for(b = 0; b < Number; b += ADS1263_CODEC_BLOCK) {
+        bits = 0;
+        for(i = 0; i < ADS1263_CODEC_BLOCK; i++) {
+            tmp[i] = b + i < Number ? In[b + i] : 0;
+            bits |= tmp[i];
+        }
+        width = Codec_Width(bits);
+        *o++ = (UBYTE)width;
+        Codec_Pack(tmp, width, o);
+        o += 16 * width;
+    }
+    return (size_t)(o - Out);
+}
+
+size_t ADS1263_Codec_Decode8(const UBYTE *In, size_t Size, UBYTE *Out, UDOUBLE Number)
+{
+    UDOUBLE tmp[ADS1263_CODEC_BLOCK];
+    const UBYTE *p = In, *end = In + Size;
+    UDOUBLE b, i;
+
+    for(b = 0; b < Number; b += ADS1263_CODEC_BLOCK) {
+        UDOUBLE n = Number - b < ADS1263_CODEC_BLOCK ? Number - b : ADS1263_CODEC_BLOCK;
+        int width;
+        if(p >= end || (width = *p++) > 8 || (size_t)(end - p) < (size_t)16 * width)
+            return 0;
+        Codec_Unpack(p, width, tmp);
+        p += 16 * width;
+        for(i = 0; i < n; i++)
+            Out[b + i] = (UBYTE)tmp[i];
+    }
+    return (size_t)(p - In);
+}
@@ -0,0 +1,116 @@
+/*****************************************************************************
+* | File        :   ADS1263_Codec.h
+* | Author      :   Highz team
+* | Function    :   Lossless delta / bit-packing sample codec
+* | Info        :
+*----------------
+* | This version:   V1.0
+* | Date        :   2026-10-19
+* | Info        :
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documnetation files (the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to  whom the Software is
+# furished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included in
+# all copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS OR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+# THE SOFTWARE.
+#
+******************************************************************************/
+#ifndef _ADS1263_CODEC_H_
+#define _ADS1263_CODEC_H_
+
+#include <stddef.h>
+#include "DEV_Config.h"
+
+/******************************************************************************
+Sample Codec
+
+Stored columns are runs of one channel over consecutive sweeps. A detector
+code moves only in its low bits from sweep to sweep, so each column is
+coded as:
+
+    delta   d[i] = x[i] - x[i-1]            (x[-1] is stored up front)
+    zigzag  z[i] = (d[i] << 1) ^ (d[i] >> 31)  small +/- deltas -> small z
+    packing blocks of 128 values at the width of the widest z in the block
+
+A block is one width byte and then 16 * width bytes. Values sit in four
+interleaved lanes (value i in lane i % 4), each lane a little-endian bit
+stream of 32-bit words, so one vector shift/or handles four values and
+packing needs no per-width code:
+
+    word m of lane j at byte 16 * m + 4 * j
+
+Streams:
+    32-bit : optional delta/zigzag (codes: yes; flags: no)
+    64-bit : always delta/zigzag; a block whose deltas need more than 32
+             bits is stored raw (width byte 0xFF, 128 x 8 bytes)
+    8-bit  : no delta (status flags)
+
+The last block is padded with zeros. Kernels:
+
+    __SSE2__      4 lanes  (any x86-64)
+    __ARM_NEON    4 lanes  (Raspberry Pi OS 64-bit, or 32-bit with -mfpu=neon)
+    otherwise     the same layout, lane by lane
+******************************************************************************/
+#define ADS1263_CODEC_BLOCK     128
+#define ADS1263_CODEC_RAW64     0xFF    // Width byte of a raw 64-bit block
+
+/******************************************************************************
+function:   Largest encoded size of a stream
+parameter:
+    Number: Values in the stream
+    Bytes: Bytes per value, 1, 4 or 8
+Info:
+    Size an output buffer with this before encoding
+******************************************************************************/
+size_t ADS1263_Codec_Bound(UDOUBLE Number, UBYTE Bytes);
+
+/******************************************************************************
+function:   Encode a stream
+parameter:
+    In: Values
+    Number: Values in In
+    Out: Output, at least ADS1263_Codec_Bound bytes
+    Delta: Code deltas (1) or the values themselves (0), 32-bit only
+Info:
+    Returns the encoded size in bytes
+******************************************************************************/
+size_t ADS1263_Codec_Encode32(const UDOUBLE *In, UDOUBLE Number, UBYTE *Out, UBYTE Delta);
+size_t ADS1263_Codec_Encode64(const uint64_t *In, UDOUBLE Number, UBYTE *Out);
+size_t ADS1263_Codec_Encode8(const UBYTE *In, UDOUBLE Number, UBYTE *Out);
+
+/******************************************************************************
+function:   Decode a stream
+parameter:
+    In: Encoded stream
+    Size: Bytes available at In
+    Out: Number values
+    Number: Values in the stream
+    Delta: As given to the encoder, 32-bit only
+Info:
+    Returns the bytes consumed, 0 if the stream is damaged or truncated
+******************************************************************************/
+size_t ADS1263_Codec_Decode32(const UBYTE *In, size_t Size, UDOUBLE *Out, UDOUBLE Number, UBYTE Delta);
+size_t ADS1263_Codec_Decode64(const UBYTE *In, size_t Size, uint64_t *Out, UDOUBLE Number);
+size_t ADS1263_Codec_Decode8(const UBYTE *In, size_t Size, UBYTE *Out, UDOUBLE Number);
+
+/******************************************************************************
+function:   Name of the packing kernel compiled in
+parameter:
+Info:
+    "sse2", "neon" or "scalar"
+******************************************************************************/
+const char *ADS1263_CodecKernel(void);
+
+#endif
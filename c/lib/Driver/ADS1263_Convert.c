@@ -0,0 +1,134 @@
+/*****************************************************************************
+* | File        :   ADS1263_Convert.c
+* | Author      :   Highz team
+* | Function    :   Batch raw-code to voltage conversion
+* | Info        :
+*----------------
+* | This version:   V1.0
+* | Date        :   2026-10-19
+* | Info        :
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documnetation files (the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to  whom the Software is
+# furished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included in
+# all copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS OR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+# THE SOFTWARE.
+#
+******************************************************************************/
+#include "ADS1263_Convert.h"
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+#define CODE_FULL_SCALE     2147483648.0    // 2^31
+
+static double ChipRef[ADS1263_MAX_CHIPS] = {
+    [0 ... ADS1263_MAX_CHIPS - 1] = ADS1263_REF_DEFAULT
+};
+
+void ADS1263_SetRef(UBYTE Chip, double Ref)
+{
+    if(Chip < ADS1263_MAX_CHIPS)
+        ChipRef[Chip] = Ref;
+}
+
+double ADS1263_GetRef(UBYTE Chip)
+{
+    return Chip < ADS1263_MAX_CHIPS ? ChipRef[Chip] : ADS1263_REF_DEFAULT;
+}
+
+const char *ADS1263_ConvertKernel(void)
+{
+#if defined(__AVX__)
+    return "avx";
+#elif defined(__SSE2__)
+    return "sse2";
+#elif defined(__ARM_NEON)
+    return "neon";
+#else
+    return "scalar";
+#endif
+}
+
+void ADS1263_CodeToVolt_F32(const UDOUBLE *Code, float *Volt, UDOUBLE Number, double Ref)
+{
+    const int32_t *in = (const int32_t *)Code;
+    const float scale = (float)(Ref / CODE_FULL_SCALE);
+    UDOUBLE i = 0;
+
+#if defined(__AVX__)
+    const __m256 vscale = _mm256_set1_ps(scale);
+    for(; i + 8 <= Number; i += 8) {
+        __m256i c = _mm256_loadu_si256((const __m256i *)(in + i));
+        _mm256_storeu_ps(Volt + i, _mm256_mul_ps(_mm256_cvtepi32_ps(c), vscale));
+    }
+#elif defined(__SSE2__)
+    const __m128 vscale = _mm_set1_ps(scale);
+    for(; i + 4 <= Number; i += 4) {
+        __m128i c = _mm_loadu_si128((const __m128i *)(in + i));
+        _mm_storeu_ps(Volt + i, _mm_mul_ps(_mm_cvtepi32_ps(c), vscale));
+    }
+#elif defined(__ARM_NEON)
+    for(; i + 4 <= Number; i += 4) {
+        int32x4_t c = vld1q_s32(in + i);
+        vst1q_f32(Volt + i, vmulq_n_f32(vcvtq_f32_s32(c), scale));
+    }
+#endif
+    for(; i < Number; i++)
+        Volt[i] = (float)in[i] * scale;
+}
+
+void ADS1263_CodeToVolt_F64(const UDOUBLE *Code, double *Volt, UDOUBLE Number, double Ref)
+{
+    const int32_t *in = (const int32_t *)Code;
+    const double scale = Ref / CODE_FULL_SCALE;
+    UDOUBLE i = 0;
+
+#if defined(__AVX__)
+    const __m256d vscale = _mm256_set1_pd(scale);
+    for(; i + 4 <= Number; i += 4) {
+        __m128i c = _mm_loadu_si128((const __m128i *)(in + i));
+        _mm256_storeu_pd(Volt + i, _mm256_mul_pd(_mm256_cvtepi32_pd(c), vscale));
+    }
+#elif defined(__SSE2__)
+    const __m128d vscale = _mm_set1_pd(scale);
+    for(; i + 4 <= Number; i += 4) {
+        __m128i c = _mm_loadu_si128((const __m128i *)(in + i));
+        _mm_storeu_pd(Volt + i,     _mm_mul_pd(_mm_cvtepi32_pd(c), vscale));
+        _mm_storeu_pd(Volt + i + 2, _mm_mul_pd(_mm_cvtepi32_pd(_mm_srli_si128(c, 8)), vscale));
+    }
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+    for(; i + 4 <= Number; i += 4) {
+        int32x4_t c = vld1q_s32(in + i);
+        vst1q_f64(Volt + i,     vmulq_n_f64(vcvtq_f64_s64(vmovl_s32(vget_low_s32(c))), scale));
+        vst1q_f64(Volt + i + 2, vmulq_n_f64(vcvtq_f64_s64(vmovl_s32(vget_high_s32(c))), scale));
+    }
+#endif
+    for(; i < Number; i++)
+        Volt[i] = (double)in[i] * scale;
+}
+
+void ADS1263_Frame_ToVolts(ADS1263_FRAME *Frame)
+{
+    UBYTE chip;
+    for(chip = 0; chip < Frame->Header.ChipCount; chip++) {
+        ADS1263_CodeToVolt_F32(Frame->Code[chip], Frame->Volt[chip], ADS1263_FRAME_STRIDE, ChipRef[chip]);
+    }
+}
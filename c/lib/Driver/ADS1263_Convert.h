@@ -0,0 +1,100 @@
+/*****************************************************************************
+* | File        :   ADS1263_Convert.h
+* | Author      :   Highz team
+* | Function    :   Batch raw-code to voltage conversion
+* | Info        :
+*----------------
+* | This version:   V1.0
+* | Date        :   2026-10-19
+* | Info        :
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documnetation files (the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to  whom the Software is
+# furished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included in
+# all copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS OR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+# THE SOFTWARE.
+#
+******************************************************************************/
+#ifndef _ADS1263_CONVERT_H_
+#define _ADS1263_CONVERT_H_
+
+#include "ADS1263_Frame.h"
+
+/******************************************************************************
+Raw Code to Voltage Conversion
+
+ADC1 results are 32-bit two's complement codes scaled to +/-VREF:
+
+    Volt = (int32)Code * VREF / 2^31
+
+Interpreting the code as signed removes the sign-bit branch that the demo
+used, so a whole array converts with one integer-to-float conversion and one
+multiply per sample. The kernel is chosen at compile time:
+
+    __AVX__       8 lanes  (x86-64 with -mavx / -march=native)
+    __SSE2__      4 lanes  (any x86-64)
+    __ARM_NEON    4 lanes  (Raspberry Pi OS 64-bit, or 32-bit with -mfpu=neon)
+    otherwise     scalar loop
+
+Float results keep 24 significant bits, well below the noise floor of the
+log detectors at the rates Highz runs; use the double variant when the full
+32-bit code must survive the conversion.
+******************************************************************************/
+
+#define ADS1263_REF_DEFAULT     5.08    // External AVDD/AVSS reference (demo default)
+
+/******************************************************************************
+function:   Set the reference voltage used for one chip
+parameter:
+    Chip: Frame row of the ADC (0 = ADC #1)
+    Ref: Reference voltage in volts (VREFP - VREFN)
+Info:
+    All chips start at ADS1263_REF_DEFAULT
+******************************************************************************/
+void ADS1263_SetRef(UBYTE Chip, double Ref);
+double ADS1263_GetRef(UBYTE Chip);
+
+/******************************************************************************
+function:   Convert an array of ADC1 codes to volts
+parameter:
+    Code: Raw 32-bit codes
+    Volt: Output array, same length
+    Number: Number of codes
+    Ref: Reference voltage in volts
+Info:
+    Arrays need no particular alignment; aligned input runs fastest
+******************************************************************************/
+void ADS1263_CodeToVolt_F32(const UDOUBLE *Code, float *Volt, UDOUBLE Number, double Ref);
+void ADS1263_CodeToVolt_F64(const UDOUBLE *Code, double *Volt, UDOUBLE Number, double Ref);
+
+/******************************************************************************
+function:   Convert every chip row of a frame to volts
+parameter:
+    Frame: Frame filled by ADS1263_GetAll
+Info:
+    Writes Frame->Volt using each chip's reference voltage. Whole rows are
+    converted, including pad slots, so no tail handling is needed
+******************************************************************************/
+void ADS1263_Frame_ToVolts(ADS1263_FRAME *Frame);
+
+/******************************************************************************
+function:   Name of the conversion kernel compiled in
+parameter:
+Info:
+    "avx", "sse2", "neon" or "scalar"
+******************************************************************************/
+const char *ADS1263_ConvertKernel(void);
+
+#endif
@@ -0,0 +1,275 @@
+/*****************************************************************************
+* | File        :   ADS1263_Detector.c
+* | Author      :   Highz team
+* | Function    :   Log-detector voltage to dBm calibration
+* | Info        :
+*----------------
+* | This version:   V1.0
+* | Date        :   2026-10-19
+* | Info        :
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documnetation files (the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to  whom the Software is
+# furished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included in
+# all copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS OR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+# THE SOFTWARE.
+#
+******************************************************************************/
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include "ADS1263_Detector.h"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+#define CURVE_COUNT     (ADS1263_MAX_CHIPS * ADS1263_DET_INPUTS)
+#define CURVE_NONE      CURVE_COUNT             // All-NaN curve for unmapped lanes
+#define CURVE_POINTS    (ADS1263_DET_KNOTS + 1)
+
+typedef struct
+{
+    float Vmin;
+    float InvStep;          // Knots per volt
+} CURVE_RANGE;
+
+/* resampled curves, one row of knots each, plus the NaN curve at the end */
+static float CurveY[CURVE_COUNT + 1][CURVE_POINTS];
+static CURVE_RANGE CurveRange[CURVE_COUNT + 1];
+static UBYTE CurveInit = 0;
+
+/* curves bound to frame slots; rebound whenever a chip's channel list changes */
+static int32_t LaneBase[ADS1263_MAX_CHIPS][ADS1263_FRAME_STRIDE] __attribute__((aligned(ADS1263_FRAME_ALIGN)));
+static float LaneVmin[ADS1263_MAX_CHIPS][ADS1263_FRAME_STRIDE] __attribute__((aligned(ADS1263_FRAME_ALIGN)));
+static float LaneInv[ADS1263_MAX_CHIPS][ADS1263_FRAME_STRIDE] __attribute__((aligned(ADS1263_FRAME_ALIGN)));
+static UBYTE LaneChannel[ADS1263_MAX_CHIPS][ADS1263_FRAME_STRIDE];
+static UBYTE LaneCount[ADS1263_MAX_CHIPS];
+static UBYTE LaneValid = 0;
+
+static void Curve_SetNone(int Index)
+{
+    int k;
+    for(k = 0; k < CURVE_POINTS; k++)
+        CurveY[Index][k] = NAN;
+    CurveRange[Index].Vmin = 0.0f;
+    CurveRange[Index].InvStep = 0.0f;
+}
+
+static void Curve_Init(void)
+{
+    int c;
+    if(CurveInit)
+        return;
+    for(c = 0; c <= CURVE_COUNT; c++)
+        Curve_SetNone(c);
+    CurveInit = 1;
+}
+
+void ADS1263_Detector_Clear(void)
+{
+    CurveInit = 0;
+    Curve_Init();
+    LaneValid = 0;
+}
+
+UBYTE ADS1263_Detector_SetCurve(UBYTE Chip, UBYTE Input, const double *Volt, const double *dBm, int Points)
+{
+    int c = Chip * ADS1263_DET_INPUTS + Input;
+    int k, seg = 0;
+    double vmin, vmax, step;
+
+    if(Chip >= ADS1263_MAX_CHIPS || Input >= ADS1263_DET_INPUTS || Points < 2 || Points > ADS1263_DET_MAX_POINTS)
+        return 1;
+    for(k = 1; k < Points; k++) {
+        if(!(Volt[k] > Volt[k - 1]))
+            return 1;
+    }
+
+    Curve_Init();
+    vmin = Volt[0];
+    vmax = Volt[Points - 1];
+    step = (vmax - vmin) / ADS1263_DET_KNOTS;
+    for(k = 0; k < CURVE_POINTS; k++) {
+        double v = vmin + k * step;
+        while(seg < Points - 2 && v > Volt[seg + 1])
+            seg++;
+        double t = (v - Volt[seg]) / (Volt[seg + 1] - Volt[seg]);
+        CurveY[c][k] = (float)(dBm[seg] + t * (dBm[seg + 1] - dBm[seg]));
+    }
+    CurveRange[c].Vmin = (float)vmin;
+    CurveRange[c].InvStep = (float)(1.0 / step);
+    LaneValid = 0;
+    return 0;
+}
+
+UBYTE ADS1263_Detector_SetPoly(UBYTE Chip, UBYTE Input, double Vmin, double Vmax, const double *Coef, int Terms)
+{
+    int c = Chip * ADS1263_DET_INPUTS + Input;
+    int k, j;
+    double step;
+
+    if(Chip >= ADS1263_MAX_CHIPS || Input >= ADS1263_DET_INPUTS || Terms < 1 || Terms > ADS1263_DET_MAX_POINTS || !(Vmax > Vmin))
+        return 1;
+
+    Curve_Init();
+    step = (Vmax - Vmin) / ADS1263_DET_KNOTS;
+    for(k = 0; k < CURVE_POINTS; k++) {
+        double v = Vmin + k * step;
+        double y = 0.0;
+        for(j = Terms - 1; j >= 0; j--)     // Horner
+            y = y * v + Coef[j];
+        CurveY[c][k] = (float)y;
+    }
+    CurveRange[c].Vmin = (float)Vmin;
+    CurveRange[c].InvStep = (float)(1.0 / step);
+    LaneValid = 0;
+    return 0;
+}
+
+UBYTE ADS1263_Detector_Load(const char *Path)
+{
+    static float SavedY[CURVE_COUNT + 1][CURVE_POINTS];
+    static CURVE_RANGE SavedRange[CURVE_COUNT + 1];
+    char line[2048];
+    int lineno = 0;
+    FILE *fp;
+
+    fp = fopen(Path, "r");
+    if(fp == NULL) {
+        printf("Open detector table %s failed\r\n", Path);
+        return 1;
+    }
+
+    // Keep a copy so a bad line leaves the old tables in place
+    Curve_Init();
+    memcpy(SavedY, CurveY, sizeof(CurveY));
+    memcpy(SavedRange, CurveRange, sizeof(CurveRange));
+
+    while(fgets(line, sizeof(line), fp) != NULL) {
+        double val[2 * ADS1263_DET_MAX_POINTS + 2];
+        char kind[8];
+        int chip, input, used, n = 0;
+        char *p;
+        UBYTE ret = 1;
+
+        lineno++;
+        p = line + strspn(line, " \t");
+        if(*p == '#' || *p == '\n' || *p == '\r' || *p == '\0')
+            continue;
+        if(sscanf(p, "%d %d %7s %n", &chip, &input, kind, &used) != 3 || chip < 0 || input < 0)
+            goto bad;
+        p += used;
+        while(n < (int)(sizeof(val) / sizeof(val[0]))) {
+            char *end;
+            val[n] = strtod(p, &end);
+            if(end == p)
+                break;
+            p = end;
+            n++;
+        }
+
+        if(strcmp(kind, "pwl") == 0 && (n % 2) == 0) {
+            double v[ADS1263_DET_MAX_POINTS], d[ADS1263_DET_MAX_POINTS];
+            int k;
+            for(k = 0; k < n / 2 && k < ADS1263_DET_MAX_POINTS; k++) {
+                v[k] = val[2 * k];
+                d[k] = val[2 * k + 1];
+            }
+            ret = ADS1263_Detector_SetCurve(chip, input, v, d, n / 2);
+        } else if(strcmp(kind, "poly") == 0 && n >= 3) {
+            ret = ADS1263_Detector_SetPoly(chip, input, val[0], val[1], val + 2, n - 2);
+        }
+        if(ret != 0)
+            goto bad;
+    }
+    fclose(fp);
+    return 0;
+
+bad:
+    printf("Detector table %s: bad line %d\r\n", Path, lineno);
+    fclose(fp);
+    memcpy(CurveY, SavedY, sizeof(CurveY));
+    memcpy(CurveRange, SavedRange, sizeof(CurveRange));
+    LaneValid = 0;
+    return 1;
+}
+
+/******************************************************************************
+function:   Point each slot of a chip row at its curve
+parameter:
+    Frame: Frame whose channel list is being bound
+    Chip: Row to bind
+Info:
+******************************************************************************/
+static void Detector_Bind(const ADS1263_FRAME *Frame, UBYTE Chip)
+{
+    UBYTE i;
+    for(i = 0; i < ADS1263_FRAME_STRIDE; i++) {
+        UBYTE input = Frame->Channel[Chip][i];
+        int c = CURVE_NONE;
+        if(i < Frame->Count[Chip] && input < ADS1263_DET_INPUTS)
+            c = Chip * ADS1263_DET_INPUTS + input;
+        LaneBase[Chip][i] = c * CURVE_POINTS;
+        LaneVmin[Chip][i] = CurveRange[c].Vmin;
+        LaneInv[Chip][i] = CurveRange[c].InvStep;
+        LaneChannel[Chip][i] = Frame->Channel[Chip][i];
+    }
+    LaneCount[Chip] = Frame->Count[Chip];
+}
+
+void ADS1263_Frame_ToPower(ADS1263_FRAME *Frame)
+{
+    const float *Y = &CurveY[0][0];
+    const float kmax = (float)ADS1263_DET_KNOTS - 0.0001f;
+    UBYTE chip;
+    int i;
+
+    Curve_Init();
+    for(chip = 0; chip < Frame->Header.ChipCount; chip++) {
+        if(!LaneValid || LaneCount[chip] != Frame->Count[chip] ||
+           memcmp(LaneChannel[chip], Frame->Channel[chip], ADS1263_FRAME_STRIDE) != 0)
+            Detector_Bind(Frame, chip);
+
+        const float *volt = Frame->Volt[chip];
+        float *power = Frame->Power[chip];
+        i = 0;
+#if defined(__AVX2__)
+        const __m256 vzero = _mm256_setzero_ps();
+        const __m256 vkmax = _mm256_set1_ps(kmax);
+        for(; i < ADS1263_FRAME_STRIDE; i += 8) {
+            __m256 t = _mm256_mul_ps(_mm256_sub_ps(_mm256_load_ps(volt + i), _mm256_load_ps(&LaneVmin[chip][i])),
+                                     _mm256_load_ps(&LaneInv[chip][i]));
+            t = _mm256_min_ps(_mm256_max_ps(t, vzero), vkmax);
+            __m256i k = _mm256_cvttps_epi32(t);
+            __m256 f = _mm256_sub_ps(t, _mm256_cvtepi32_ps(k));
+            __m256i idx = _mm256_add_epi32(k, _mm256_load_si256((const __m256i *)&LaneBase[chip][i]));
+            __m256 y0 = _mm256_i32gather_ps(Y, idx, 4);
+            __m256 y1 = _mm256_i32gather_ps(Y + 1, idx, 4);
+            _mm256_store_ps(power + i, _mm256_add_ps(y0, _mm256_mul_ps(f, _mm256_sub_ps(y1, y0))));
+        }
+#endif
+        for(; i < ADS1263_FRAME_STRIDE; i++) {
+            float t = (volt[i] - LaneVmin[chip][i]) * LaneInv[chip][i];
+            t = t < 0.0f ? 0.0f : (t > kmax ? kmax : t);
+            int k = (int)t;
+            float f = t - (float)k;
+            const float *y = Y + LaneBase[chip][i] + k;
+            power[i] = y[0] + f * (y[1] - y[0]);
+        }
+    }
+    LaneValid = 1;
+    Frame->Header.Flags |= ADS1263_FRAME_POWER;
+}
@@ -0,0 +1,106 @@
+/*****************************************************************************
+* | File        :   ADS1263_Detector.h
+* | Author      :   Highz team
+* | Function    :   Log-detector voltage to dBm calibration
+* | Info        :
+*----------------
+* | This version:   V1.0
+* | Date        :   2026-10-19
+* | Info        :
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documnetation files (the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to  whom the Software is
+# furished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included in
+# all copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS OR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+# THE SOFTWARE.
+#
+******************************************************************************/
+#ifndef _ADS1263_DETECTOR_H_
+#define _ADS1263_DETECTOR_H_
+
+#include "ADS1263_Frame.h"
+
+/******************************************************************************
+Log-Detector Calibration
+
+Every detector input has its own voltage -> dBm curve. Curves are loaded from
+a text file, one curve per line, keyed by chip row and AIN input:
+
+    # chip  input  pwl   v0 dBm0  v1 dBm1  ...      (volts ascending)
+    0       0      pwl   0.50 -10  1.00 -25  1.50 -40  2.00 -55
+    # chip  input  poly  vmin vmax  c0 c1 c2 ...     (dBm = c0 + c1*v + ...)
+    1       3      poly  0.40 2.10  6.2 -31.5 0.8
+
+Both forms are resampled onto ADS1263_DET_KNOTS uniform segments between
+their first and last voltage. Applying a curve is then a clamp, an index and
+one linear interpolation per sample with no data-dependent branches, so a
+whole chip row is evaluated with vector arithmetic (AVX2 gathers on x86).
+Voltages outside the calibrated span saturate at the curve ends. Inputs
+without a curve (state lines, supply monitor) produce NaN.
+******************************************************************************/
+#define ADS1263_DET_INPUTS      11      // AIN0-AIN10
+#define ADS1263_DET_KNOTS       128     // Uniform segments per curve
+#define ADS1263_DET_MAX_POINTS  64      // Points per pwl line / terms per poly line
+
+/******************************************************************************
+function:   Load detector curves from a file
+parameter:
+    Path: Calibration table, see format above
+Info:
+    Returns 0 on success, 1 on failure (nothing is changed on failure)
+    Curves not mentioned in the file keep their previous value
+******************************************************************************/
+UBYTE ADS1263_Detector_Load(const char *Path);
+
+/******************************************************************************
+function:   Install a piecewise-linear curve
+parameter:
+    Chip, Input: Detector position
+    Volt, dBm: Curve points, Volt strictly ascending
+    Points: Number of points (2 .. ADS1263_DET_MAX_POINTS)
+Info:
+    Returns 0 on success, 1 on bad arguments
+******************************************************************************/
+UBYTE ADS1263_Detector_SetCurve(UBYTE Chip, UBYTE Input, const double *Volt, const double *dBm, int Points);
+
+/******************************************************************************
+function:   Install a polynomial curve
+parameter:
+    Chip, Input: Detector position
+    Vmin, Vmax: Calibrated voltage span
+    Coef: c0 .. c(Terms-1), dBm = sum(c[k] * v^k)
+    Terms: Number of coefficients (1 .. ADS1263_DET_MAX_POINTS)
+Info:
+    Returns 0 on success, 1 on bad arguments
+******************************************************************************/
+UBYTE ADS1263_Detector_SetPoly(UBYTE Chip, UBYTE Input, double Vmin, double Vmax, const double *Coef, int Terms);
+
+/******************************************************************************
+function:   Remove every curve
+parameter:
+Info:
+******************************************************************************/
+void ADS1263_Detector_Clear(void);
+
+/******************************************************************************
+function:   Convert the Volt rows of a frame to dBm
+parameter:
+    Frame: Frame converted by ADS1263_Frame_ToVolts
+Info:
+    Writes Frame->Power and sets ADS1263_FRAME_POWER in the header flags
+******************************************************************************/
+void ADS1263_Frame_ToPower(ADS1263_FRAME *Frame);
+
+#endif
@@ -0,0 +1,82 @@
+/*****************************************************************************
+* | File        :   ADS1263_Frame.c
+* | Author      :   Highz team
+* | Function    :   Sweep frame layout shared by the acquisition pipeline
+* | Info        :
+*----------------
+* | This version:   V1.0
+* | Date        :   2026-10-19
+* | Info        :
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documnetation files (the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to  whom the Software is
+# furished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included in
+# all copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS OR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+# THE SOFTWARE.
+#
+******************************************************************************/
+#include <string.h>
+#include <time.h>
+#include "ADS1263.h"
+
+uint64_t ADS1263_Clock_ns(int Clock)
+{
+    struct timespec ts;
+    clock_gettime((clockid_t)Clock, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+void ADS1263_Frame_Init(ADS1263_FRAME *Frame, UBYTE ChipCount)
+{
+    memset(Frame, 0, sizeof(*Frame));
+    Frame->Header.Magic = ADS1263_FRAME_MAGIC;
+    Frame->Header.Version = ADS1263_FRAME_VERSION;
+    Frame->Header.ChipCount = ChipCount > ADS1263_MAX_CHIPS ? ADS1263_MAX_CHIPS : ChipCount;
+    Frame->Header.CalState = ADS1263_STATE_INVALID;
+}
+
+void ADS1263_Frame_Begin(ADS1263_FRAME *Frame, uint64_t Sequence)
+{
+    Frame->Header.Sequence = Sequence;
+    Frame->Header.Time_ns  = ADS1263_Clock_ns(CLOCK_REALTIME);
+    Frame->Header.Start_ns = ADS1263_Clock_ns(CLOCK_MONOTONIC);
+    Frame->Header.End_ns   = 0;
+    Frame->Header.Flags    = 0;
+}
+
+void ADS1263_Frame_End(ADS1263_FRAME *Frame)
+{
+    Frame->Header.End_ns = ADS1263_Clock_ns(CLOCK_MONOTONIC);
+    ADS1263_Frame_Summarize(Frame);
+}
+
+void ADS1263_Frame_Summarize(ADS1263_FRAME *Frame)
+{
+    UDOUBLE Flags = 0;
+    UBYTE chip, i;
+
+    // Flag summary so consumers can skip clean frames without touching rows
+    for(chip = 0; chip < Frame->Header.ChipCount; chip++) {
+        for(i = 0; i < Frame->Count[chip]; i++) {
+            Flags |= Frame->Status[chip][i];
+        }
+    }
+
+    Frame->Header.CalState = ADS1263_ReadState();
+    if(Frame->Header.CalState == ADS1263_STATE_INVALID)
+        Flags |= ADS1263_FRAME_STATE_ERROR;
+
+    Frame->Header.Flags = Flags;
+}
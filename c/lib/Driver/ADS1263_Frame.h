@@ -0,0 +1,164 @@
+/*****************************************************************************
+* | File        :   ADS1263_Frame.h
+* | Author      :   Highz team
+* | Function    :   Sweep frame layout shared by the acquisition pipeline
+* | Info        :
+*----------------
+* | This version:   V1.0
+* | Date        :   2026-10-19
+* | Info        :
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documnetation files (the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to  whom the Software is
+# furished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included in
+# all copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS OR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+# THE SOFTWARE.
+#
+******************************************************************************/
+#ifndef _ADS1263_FRAME_H_
+#define _ADS1263_FRAME_H_
+
+#include "DEV_Config.h"
+
+/******************************************************************************
+Sweep Frame Layout
+
+One frame holds one complete sweep over every chip in the stack. Rows are
+sized for the largest supported stack; Header.ChipCount says how many are
+in use:
+
+    +----------------------------+  offset 0
+    | Header (64 bytes)          |  sequence, timestamps, state, flags
+    +----------------------------+  offset 64
+    | Code[chip][slot]           |  raw 32-bit codes, one 64-byte row per chip
+    | Volt[chip][slot]           |  codes converted by ADS1263_Frame_ToVolts
+    | Power[chip][slot]          |  dBm from ADS1263_Frame_ToPower
+    +----------------------------+
+    | ChipTime_ns[chip]          |  monotonic start time of each chip's scan
+    | Channel[chip][slot]        |  AINx input each slot was taken from
+    | Status[chip][slot]         |  per-sample ADS1263_SAMPLE_* flags
+    | Count[chip]                |  number of valid slots in each row
+    +----------------------------+
+
+Each chip row is ADS1263_FRAME_STRIDE slots wide and starts on a cache line,
+so a whole row can be processed with aligned vector loads and no tail
+handling. Unused slots are zero. Every stage after the driver (conversion,
+logging, publishing) works on this structure in place.
+******************************************************************************/
+#define ADS1263_MAX_BUSES       DEV_HARDWARE_SPI_MAX_BUS
+#define ADS1263_MAX_CHIPS_PER_BUS   8   // ADCs on one SPI bus
+#define ADS1263_MAX_CHIPS       (ADS1263_MAX_BUSES * ADS1263_MAX_CHIPS_PER_BUS)
+#define ADS1263_FRAME_STRIDE    16      // Slots per chip row (AIN0-AIN10 + pad)
+#define ADS1263_FRAME_ALIGN     64      // Cache line / widest vector alignment
+
+#define ADS1263_FRAME_MAGIC     0x46535A48  // "HZSF" little-endian
+#define ADS1263_FRAME_VERSION   1
+
+#define ADS1263_STATE_INVALID   0xFF    // CalState when the state lines are invalid
+
+/* per-sample status, also OR'd into the header flag summary */
+typedef enum
+{
+    ADS1263_SAMPLE_OK       = 0x00,
+    ADS1263_SAMPLE_CRC      = 0x01,     // Checksum mismatch on the data read
+    ADS1263_SAMPLE_TIMEOUT  = 0x02,     // DRDY never went LOW
+    ADS1263_SAMPLE_STALE    = 0x04,     // Not converted this sweep, last value repeated
+    ADS1263_SAMPLE_LATE     = 0x08,     // DRDY missed its predicted deadline
+}ADS1263_SAMPLE_FLAG;
+
+/* frame-level flags, header only */
+typedef enum
+{
+    ADS1263_FRAME_STATE_ERROR   = 0x0100,   // State lines decoded to an invalid pattern
+    ADS1263_FRAME_POWER         = 0x0200,   // Power rows hold calibrated dBm
+}ADS1263_FRAME_FLAG;
+
+typedef struct
+{
+    UDOUBLE  Magic;         // ADS1263_FRAME_MAGIC
+    UWORD    Version;       // ADS1263_FRAME_VERSION
+    UBYTE    ChipCount;     // Chip rows in use
+    UBYTE    CalState;      // Decoded calibration state (0-9 or ADS1263_STATE_INVALID)
+    uint64_t Sequence;      // Sweep counter, set by the producer
+    uint64_t Time_ns;       // CLOCK_REALTIME at sweep start
+    uint64_t Start_ns;      // CLOCK_MONOTONIC at sweep start
+    uint64_t End_ns;        // CLOCK_MONOTONIC at sweep end
+    UDOUBLE  Flags;         // OR of all sample flags plus ADS1263_FRAME_* flags
+    UDOUBLE  Epoch;         // Configuration epoch the sweep was taken under
+    UDOUBLE  Reserved[4];
+} ADS1263_FRAME_HEADER;
+
+typedef struct
+{
+    ADS1263_FRAME_HEADER Header;
+    UDOUBLE  Code[ADS1263_MAX_CHIPS][ADS1263_FRAME_STRIDE] __attribute__((aligned(ADS1263_FRAME_ALIGN)));
+    float    Volt[ADS1263_MAX_CHIPS][ADS1263_FRAME_STRIDE] __attribute__((aligned(ADS1263_FRAME_ALIGN)));
+    float    Power[ADS1263_MAX_CHIPS][ADS1263_FRAME_STRIDE] __attribute__((aligned(ADS1263_FRAME_ALIGN)));
+    uint64_t ChipTime_ns[ADS1263_MAX_CHIPS];
+    UBYTE    Channel[ADS1263_MAX_CHIPS][ADS1263_FRAME_STRIDE];
+    UBYTE    Status[ADS1263_MAX_CHIPS][ADS1263_FRAME_STRIDE];
+    UBYTE    Count[ADS1263_MAX_CHIPS];
+} __attribute__((aligned(ADS1263_FRAME_ALIGN))) ADS1263_FRAME;
+
+_Static_assert(sizeof(ADS1263_FRAME_HEADER) == 64, "frame header must stay one cache line");
+
+/******************************************************************************
+function:   Clear a frame and stamp its header
+parameter:
+    Frame: Frame to initialise
+    ChipCount: Number of chip rows that will be filled
+Info:
+    Call once per buffer; frames are reused sweep after sweep
+******************************************************************************/
+void ADS1263_Frame_Init(ADS1263_FRAME *Frame, UBYTE ChipCount);
+
+/******************************************************************************
+function:   Start a new sweep in an existing frame
+parameter:
+    Frame: Frame to fill
+    Sequence: Sweep number assigned by the producer
+Info:
+    Records the start timestamps and clears the per-sweep flags
+******************************************************************************/
+void ADS1263_Frame_Begin(ADS1263_FRAME *Frame, uint64_t Sequence);
+
+/******************************************************************************
+function:   Finish a sweep
+parameter:
+    Frame: Frame that was filled by ADS1263_GetAll
+Info:
+    Records the end timestamp, the calibration state and the flag summary
+******************************************************************************/
+void ADS1263_Frame_End(ADS1263_FRAME *Frame);
+
+/******************************************************************************
+function:   Recompute the calibration state and flag summary of a frame
+parameter:
+    Frame: Filled frame whose timestamps are already set
+Info:
+    The part of ADS1263_Frame_End that does not touch the timestamps, for
+    producers that assemble the header themselves (see ADS1263_MultiBus.h)
+******************************************************************************/
+void ADS1263_Frame_Summarize(ADS1263_FRAME *Frame);
+
+/******************************************************************************
+function:   Read a clock in nanoseconds
+parameter:
+    Clock: CLOCK_MONOTONIC or CLOCK_REALTIME
+Info:
+******************************************************************************/
+uint64_t ADS1263_Clock_ns(int Clock);
+
+#endif
@@ -0,0 +1,149 @@
+/*****************************************************************************
+* | File        :   ADS1263_Latest.c
+* | Author      :   Highz team
+* | Function    :   Seqlock latest-sweep snapshot
+* | Info        :
+*----------------
+* | This version:   V1.0
+* | Date        :   2026-10-19
+* | Info        :
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documnetation files (the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to  whom the Software is
+# furished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included in
+# all copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS OR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+# THE SOFTWARE.
+#
+******************************************************************************/
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include "ADS1263_Latest.h"
+
+UBYTE ADS1263_Latest_Create(ADS1263_LATEST *l, const char *Name, const ADS1263_MAP *Map)
+{
+    ADS1263_LATEST_AREA *a;
+    UDOUBLE pid = 0;
+    void *base;
+    int old;
+
+    memset(l, 0, sizeof(*l));
+    l->Fd = -1;
+    l->Map = Map;
+    if(Name != NULL) {
+        snprintf(l->Name, sizeof(l->Name), "%s", Name);
+        // The producer holds a lock on its object: never replace a live one
+        old = shm_open(Name, O_RDWR, 0);
+        if(old >= 0 && flock(old, LOCK_EX | LOCK_NB) != 0) {
+            if(pread(old, &pid, sizeof(pid), offsetof(ADS1263_LATEST_AREA, Pid)) != (ssize_t)sizeof(pid))
+                pid = 0;
+            printf("Latest: %s is in use by process %lu \r\n", Name, (unsigned long)pid);
+            close(old);
+            return 1;
+        }
+        // A fresh object each run, like the sweep ring
+        shm_unlink(Name);
+        l->Fd = shm_open(Name, O_RDWR | O_CREAT | O_EXCL, 0644);
+        if(old >= 0)
+            close(old);
+        if(l->Fd < 0 || ftruncate(l->Fd, (off_t)sizeof(ADS1263_LATEST_AREA)) != 0 ||
+           flock(l->Fd, LOCK_EX | LOCK_NB) != 0) {
+            printf("Latest: cannot create %s (%s) \r\n", Name, strerror(errno));
+            ADS1263_Latest_Close(l);
+            return 1;
+        }
+        base = mmap(NULL, sizeof(ADS1263_LATEST_AREA), PROT_READ | PROT_WRITE, MAP_SHARED, l->Fd, 0);
+    } else {
+        base = mmap(NULL, sizeof(ADS1263_LATEST_AREA), PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    }
+    if(base == MAP_FAILED) {
+        ADS1263_Latest_Close(l);
+        return 1;
+    }
+    // Prefault: the first sweep must not take a page fault
+    memset(base, 0, sizeof(ADS1263_LATEST_AREA));
+    a = l->Area = (ADS1263_LATEST_AREA *)base;
+    a->Version = ADS1263_LATEST_VERSION;
+    a->Pid = (UDOUBLE)getpid();
+    a->SweepSize = sizeof(ADS1263_LATEST_SWEEP);
+    a->Created_ns = ADS1263_Clock_ns(CLOCK_REALTIME);
+    __atomic_store_n(&a->Magic, ADS1263_LATEST_MAGIC, __ATOMIC_RELEASE);
+    return 0;
+}
+
+/* labels of the values, in the order Publish packs them */
+static void Latest_Label(ADS1263_LATEST *l, const ADS1263_FRAME *Frame)
+{
+    const ADS1263_MAP *Map = l->Map;
+    ADS1263_LATEST_AREA *a = l->Area;
+    UWORD n = 0;
+    UBYTE chip, i;
+
+    memset(a->Label, 0, sizeof(a->Label));
+    for(chip = 0; chip < Frame->Header.ChipCount; chip++) {
+        for(i = 0; i < Frame->Count[chip] && n < ADS1263_LATEST_MAX; i++, n++) {
+            if(chip < Map->ChipCount)
+                snprintf(a->Label[n], ADS1263_LATEST_LABEL, "%s.%s", Map->Chip[chip].Name,
+                         ADS1263_Map_Name(Map, chip, i));
+        }
+    }
+    l->Epoch = Frame->Header.Epoch;
+    l->Labelled = 1;
+}
+
+void ADS1263_Latest_Publish(ADS1263_LATEST *l, const ADS1263_FRAME *Frame)
+{
+    ADS1263_LATEST_AREA *a = l->Area;
+    ADS1263_LATEST_SWEEP *s = &a->Sweep;
+    uint64_t lock = __atomic_load_n(&a->Lock, __ATOMIC_RELAXED);
+    UWORD n = 0;
+    UBYTE chip, i;
+
+    __atomic_store_n(&a->Lock, lock + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    s->Sequence = Frame->Header.Sequence;
+    s->Time_ns = Frame->Header.Time_ns;
+    s->End_ns = Frame->Header.End_ns;
+    s->Flags = Frame->Header.Flags;
+    s->Epoch = Frame->Header.Epoch;
+    s->CalState = Frame->Header.CalState;
+    for(chip = 0; chip < Frame->Header.ChipCount; chip++) {
+        for(i = 0; i < Frame->Count[chip] && n < ADS1263_LATEST_MAX; i++, n++) {
+            s->Value[n].Code = Frame->Code[chip][i];
+            s->Value[n].Volt = Frame->Volt[chip][i];
+            s->Value[n].Power = Frame->Power[chip][i];
+            s->Value[n].Status = Frame->Status[chip][i];
+            s->Value[n].Input = Frame->Channel[chip][i];
+        }
+    }
+    s->Count = n;
+    if(!l->Labelled || Frame->Header.Epoch != l->Epoch)
+        Latest_Label(l, Frame);
+    __atomic_store_n(&a->Lock, lock + 2, __ATOMIC_RELEASE);
+}
+
+void ADS1263_Latest_Close(ADS1263_LATEST *l)
+{
+    if(l->Area != NULL)
+        munmap(l->Area, sizeof(ADS1263_LATEST_AREA));
+    if(l->Fd >= 0)
+        close(l->Fd);
+    l->Area = NULL;
+    l->Fd = -1;
+}
@@ -0,0 +1,220 @@
+/*****************************************************************************
+* | File        :   ADS1263_Latest.h
+* | Author      :   Highz team
+* | Function    :   Seqlock latest-sweep snapshot
+* | Info        :
+*----------------
+* | This version:   V1.0
+* | Date        :   2026-10-19
+* | Info        :
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documnetation files (the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to  whom the Software is
+# furished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included in
+# all copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS OR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+# THE SOFTWARE.
+#
+******************************************************************************/
+#ifndef _ADS1263_LATEST_H_
+#define _ADS1263_LATEST_H_
+
+#include "ADS1263.h"
+#include "ADS1263_Map.h"
+
+/******************************************************************************
+Latest Sweep
+
+For control loops that only need the newest value of each channel. The
+acquisition thread overwrites a single snapshot after every sweep under a
+seqlock; readers copy it without locks or system calls:
+
+    +----------------------------+  offset 0
+    | Header (64 bytes)          |  magic, producer
+    | Lock (own cache line)      |  odd while the producer writes
+    | Sweep                      |  64-byte head, then Value[Count]
+    | Label[ADS1263_LATEST_MAX]  |  "chip.channel" of each value
+    +----------------------------+
+
+Values are packed in frame order, chip by chip, so the 25 channels of the
+Highz stack are 400 bytes and one read copies only those. The producer
+bumps Lock to odd, writes, and bumps it back to even; a reader that sees
+the same even Lock before and after its copy has a consistent sweep, and
+otherwise copies again (the write takes a fraction of a microsecond). A
+Lock that stays odd means the producer died inside a write (a restarted
+hzd creates a new object): after ADS1263_LATEST_STALL_NS, or as soon as
+the producer process is gone, readers give up and report it, so a poller
+can detach and attach again instead of spinning forever.
+
+Labels change only with the channel map. They are rewritten under the same
+Lock when a sweep carries a new Epoch, so a poller looks a channel up once
+with ADS1263_Latest_Find and again only when Sweep.Epoch differs from the
+epoch it got.
+
+The snapshot lives in a POSIX shared-memory object for pollers in other
+processes, or in private memory for threads of the acquisition process,
+which read it through the producer's own handle.
+******************************************************************************/
+#define ADS1263_LATEST_MAGIC    0x4C535A48  // "HZSL"
+#define ADS1263_LATEST_VERSION  1
+#define ADS1263_LATEST_NAME     "/hz_latest"
+#define ADS1263_LATEST_MAX      ADS1263_MAP_CHANNELS
+#define ADS1263_LATEST_LABEL    (2 * ADS1263_MAP_NAME)
+#define ADS1263_LATEST_STALL_NS 100000000   // Longest wait for a write to finish
+
+typedef struct
+{
+    UDOUBLE  Code;          // Raw code
+    float    Volt;
+    float    Power;         // dBm when Sweep.Flags has ADS1263_FRAME_POWER
+    UBYTE    Status;        // ADS1263_SAMPLE_* flags
+    UBYTE    Input;         // AINx the value was taken from
+    UWORD    Reserved;
+} ADS1263_LATEST_VALUE;
+
+typedef struct
+{
+    uint64_t Sequence;      // Frame header fields of the sweep
+    uint64_t Time_ns;
+    uint64_t End_ns;
+    UDOUBLE  Flags;
+    UDOUBLE  Epoch;         // Epoch the labels belong to
+    UWORD    Count;         // Values in use
+    UBYTE    CalState;
+    UBYTE    Reserved0;
+    UDOUBLE  Reserved[7];
+    ADS1263_LATEST_VALUE Value[ADS1263_LATEST_MAX];
+} ADS1263_LATEST_SWEEP;
+
+typedef struct
+{
+    UDOUBLE  Magic;         // ADS1263_LATEST_MAGIC, set last
+    UWORD    Version;
+    UWORD    Reserved0;
+    UDOUBLE  Pid;           // Producer process
+    UDOUBLE  SweepSize;     // sizeof(ADS1263_LATEST_SWEEP), checked on attach
+    UDOUBLE  Reserved1;
+    uint64_t Created_ns;    // CLOCK_REALTIME
+    UDOUBLE  Reserved[8];
+    uint64_t Lock __attribute__((aligned(64)));     // Seqlock, 0 = nothing published
+    ADS1263_LATEST_SWEEP Sweep __attribute__((aligned(64)));
+    char     Label[ADS1263_LATEST_MAX][ADS1263_LATEST_LABEL];
+} ADS1263_LATEST_AREA;
+
+_Static_assert(sizeof(ADS1263_LATEST_VALUE) == 16, "latest value is 16 bytes");
+_Static_assert(offsetof(ADS1263_LATEST_SWEEP, Value) == 64, "latest sweep head is 64 bytes");
+
+typedef struct
+{
+    int      Fd;            // -1 for a private snapshot
+    char     Name[64];
+    ADS1263_LATEST_AREA *Area;
+    const ADS1263_MAP *Map; // Producer only
+    UDOUBLE  Epoch;         // Epoch the labels were written for
+    UBYTE    Labelled;
+} ADS1263_LATEST;
+
+/******************************************************************************
+function:   Create the snapshot
+parameter:
+    Latest: Producer handle, usually static
+    Name: Shared-memory object (ADS1263_LATEST_NAME), or NULL for a snapshot
+          only threads of this process read
+    Map: Compiled channel map the sweeps are labelled from; kept, so a map
+         swapped on reconfiguration is picked up at the new epoch
+Info:
+    Call before the acquisition starts; the area is prefaulted. Fails
+    while another producer still holds Name.
+    Returns 0 on success, 1 on failure
+******************************************************************************/
+UBYTE ADS1263_Latest_Create(ADS1263_LATEST *Latest, const char *Name, const ADS1263_MAP *Map);
+
+/******************************************************************************
+function:   Replace the snapshot with a sweep
+parameter:
+    Latest: Producer handle
+    Frame: Finished frame, after conversion
+Info:
+    Never blocks; copies the header and the used slots only
+******************************************************************************/
+void ADS1263_Latest_Publish(ADS1263_LATEST *Latest, const ADS1263_FRAME *Frame);
+
+/******************************************************************************
+function:   Release the snapshot
+parameter:
+    Latest: Producer handle
+Info:
+    The shared object stays until the next ADS1263_Latest_Create, so pollers
+    keep the last sweep
+******************************************************************************/
+void ADS1263_Latest_Close(ADS1263_LATEST *Latest);
+
+/******************************************************************************
+function:   Attach to a snapshot published by another process
+parameter:
+    Latest: Reader handle
+    Name: Shared-memory object
+Info:
+    Reader side, in ADS1263_LatestRead.c (no hardware layer needed)
+    Returns 0 on success, 1 if there is no compatible snapshot
+******************************************************************************/
+UBYTE ADS1263_Latest_Attach(ADS1263_LATEST *Latest, const char *Name);
+
+/******************************************************************************
+function:   Copy the newest sweep
+parameter:
+    Latest: Attached reader, or the producer's handle
+    Sweep: Receives the header and Count values; values past Count are not
+           touched
+Info:
+    Retries while the producer is writing; no locks, no system calls
+    unless a write takes unusually long
+    Returns 0, 1 if nothing has been published yet, or 2 if the producer
+    stopped inside a write: detach and attach again
+******************************************************************************/
+UBYTE ADS1263_Latest_Read(const ADS1263_LATEST *Latest, ADS1263_LATEST_SWEEP *Sweep);
+
+/******************************************************************************
+function:   Index of a named channel
+parameter:
+    Latest: Attached reader, or the producer's handle
+    Name: "chip.channel", or a channel name unique across chips
+    Epoch: Receives the epoch the index is good for
+Info:
+    Returns the index into Sweep.Value, or -1 (also when the producer
+    stopped inside a write)
+******************************************************************************/
+int ADS1263_Latest_Find(const ADS1263_LATEST *Latest, const char *Name, UDOUBLE *Epoch);
+
+/******************************************************************************
+function:   Copy every label
+parameter:
+    Latest: Attached reader, or the producer's handle
+    Label: Receives ADS1263_LATEST_MAX labels
+    Epoch: Receives the epoch the labels belong to
+Info:
+    Returns the number of labels in use, 0 when the producer stopped
+    inside a write
+******************************************************************************/
+UWORD ADS1263_Latest_Labels(const ADS1263_LATEST *Latest, char (*Label)[ADS1263_LATEST_LABEL], UDOUBLE *Epoch);
+
+/******************************************************************************
+function:   Detach a reader
+parameter:
+    Latest: Attached reader
+Info:
+******************************************************************************/
+void ADS1263_Latest_Detach(ADS1263_LATEST *Latest);
+
+#endif
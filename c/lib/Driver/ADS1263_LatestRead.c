@@ -0,0 +1,190 @@
+/*****************************************************************************
+* | File        :   ADS1263_LatestRead.c
+* | Author      :   Highz team
+* | Function    :   Seqlock latest-sweep snapshot, reader side
+* | Info        :
+*----------------
+* | This version:   V1.0
+* | Date        :   2026-10-19
+* | Info        :
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documnetation files (the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to  whom the Software is
+# furished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included in
+# all copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS OR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+# THE SOFTWARE.
+#
+******************************************************************************/
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "ADS1263_Latest.h"
+
+UBYTE ADS1263_Latest_Attach(ADS1263_LATEST *l, const char *Name)
+{
+    struct stat st;
+    void *base;
+
+    memset(l, 0, sizeof(*l));
+    snprintf(l->Name, sizeof(l->Name), "%s", Name);
+    l->Fd = shm_open(Name, O_RDONLY, 0);
+    if(l->Fd < 0 || fstat(l->Fd, &st) != 0 || (size_t)st.st_size < sizeof(ADS1263_LATEST_AREA)) {
+        ADS1263_Latest_Detach(l);
+        return 1;
+    }
+    base = mmap(NULL, sizeof(ADS1263_LATEST_AREA), PROT_READ, MAP_SHARED, l->Fd, 0);
+    if(base == MAP_FAILED) {
+        ADS1263_Latest_Detach(l);
+        return 1;
+    }
+    l->Area = (ADS1263_LATEST_AREA *)base;
+    if(__atomic_load_n(&l->Area->Magic, __ATOMIC_ACQUIRE) != ADS1263_LATEST_MAGIC ||
+       l->Area->Version != ADS1263_LATEST_VERSION || l->Area->SweepSize != sizeof(ADS1263_LATEST_SWEEP)) {
+        printf("Latest: %s is not a compatible snapshot \r\n", Name);
+        ADS1263_Latest_Detach(l);
+        return 1;
+    }
+    return 0;
+}
+
+static inline void Latest_Relax(void)
+{
+#if defined(__aarch64__)
+    __asm__ __volatile__("yield" ::: "memory");
+#elif defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#else
+    __asm__ __volatile__("" ::: "memory");
+#endif
+}
+
+#define LATEST_SPIN_CHECK   1024    // Spins between two looks at the clock
+
+/* the producer went away inside a publish, or never finishes it */
+static UBYTE Latest_Stalled(const ADS1263_LATEST_AREA *a, uint64_t *Since)
+{
+    struct timespec ts;
+    uint64_t now;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    now = (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+    if(*Since == 0) {
+        *Since = now;
+        return 0;
+    }
+    if(kill((pid_t)a->Pid, 0) != 0 && errno == ESRCH)
+        return 1;
+    return now - *Since > ADS1263_LATEST_STALL_NS;
+}
+
+/* even Lock to read under, 0 if nothing was published, odd if stalled */
+static uint64_t Latest_Begin(const ADS1263_LATEST_AREA *a)
+{
+    uint64_t lock, since = 0;
+    UDOUBLE spins = 0;
+
+    while((lock = __atomic_load_n(&a->Lock, __ATOMIC_ACQUIRE)) & 1) {
+        if(++spins % LATEST_SPIN_CHECK == 0 && Latest_Stalled(a, &since))
+            break;
+        Latest_Relax();
+    }
+    return lock;
+}
+
+/* nothing was written while reading under Lock */
+static UBYTE Latest_Valid(const ADS1263_LATEST_AREA *a, uint64_t Lock)
+{
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    return __atomic_load_n(&a->Lock, __ATOMIC_RELAXED) == Lock;
+}
+
+UBYTE ADS1263_Latest_Read(const ADS1263_LATEST *l, ADS1263_LATEST_SWEEP *Sweep)
+{
+    const ADS1263_LATEST_AREA *a = l->Area;
+    uint64_t lock;
+    UWORD n;
+
+    do {
+        lock = Latest_Begin(a);
+        if(lock & 1)
+            return 2;
+        if(lock == 0)
+            return 1;
+        memcpy(Sweep, &a->Sweep, offsetof(ADS1263_LATEST_SWEEP, Value));
+        // Count may be torn until the check passes; keep the copy in bounds
+        n = Sweep->Count < ADS1263_LATEST_MAX ? Sweep->Count : ADS1263_LATEST_MAX;
+        memcpy(Sweep->Value, a->Sweep.Value, (size_t)n * sizeof(ADS1263_LATEST_VALUE));
+    } while(!Latest_Valid(a, lock));
+    return 0;
+}
+
+int ADS1263_Latest_Find(const ADS1263_LATEST *l, const char *Name, UDOUBLE *Epoch)
+{
+    const ADS1263_LATEST_AREA *a = l->Area;
+    uint64_t lock;
+    int c, found;
+    UWORD n;
+
+    do {
+        lock = Latest_Begin(a);
+        if(lock & 1)
+            return -1;
+        found = -1;
+        n = a->Sweep.Count < ADS1263_LATEST_MAX ? a->Sweep.Count : ADS1263_LATEST_MAX;
+        *Epoch = a->Sweep.Epoch;
+        for(c = 0; c < n; c++) {
+            const char *dot = strchr(a->Label[c], '.');
+            if(strncmp(a->Label[c], Name, ADS1263_LATEST_LABEL) == 0) {
+                found = c;
+                break;
+            }
+            if(dot != NULL && strcmp(dot + 1, Name) == 0)
+                found = found == -1 ? c : -2;
+        }
+    } while(!Latest_Valid(a, lock));
+    return found < 0 ? -1 : found;
+}
+
+UWORD ADS1263_Latest_Labels(const ADS1263_LATEST *l, char (*Label)[ADS1263_LATEST_LABEL], UDOUBLE *Epoch)
+{
+    const ADS1263_LATEST_AREA *a = l->Area;
+    uint64_t lock;
+    UWORD n;
+
+    do {
+        lock = Latest_Begin(a);
+        if(lock & 1)
+            return 0;
+        n = a->Sweep.Count < ADS1263_LATEST_MAX ? a->Sweep.Count : ADS1263_LATEST_MAX;
+        *Epoch = a->Sweep.Epoch;
+        memcpy(Label, a->Label, (size_t)n * ADS1263_LATEST_LABEL);
+    } while(!Latest_Valid(a, lock));
+    return n;
+}
+
+void ADS1263_Latest_Detach(ADS1263_LATEST *l)
+{
+    if(l->Area != NULL)
+        munmap(l->Area, sizeof(ADS1263_LATEST_AREA));
+    if(l->Fd >= 0)
+        close(l->Fd);
+    l->Area = NULL;
+    l->Fd = -1;
+}
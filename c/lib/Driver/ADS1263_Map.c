@@ -0,0 +1,474 @@
+/*****************************************************************************
+* | File        :   ADS1263_Map.c
+* | Author      :   Highz team
+* | Function    :   Declarative channel map for the ADC stack
+* | Info        :
+*----------------
+* | This version:   V1.0
+* | Date        :   2026-10-19
+* | Info        :
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documnetation files (the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to  whom the Software is
+# furished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included in
+# all copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS OR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+# THE SOFTWARE.
+#
+******************************************************************************/
+#include <stdlib.h>
+#include <string.h>
+#include "ADS1263_Map.h"
+#include "ADS1263_Startup.h"
+#include "ADS1263_Calib.h"
+#include "ADS1263_Sched.h"
+
+static const char *RateName[] = {
+    "2.5", "5", "10", "16.6", "20", "50", "60", "100",
+    "400", "1200", "2400", "4800", "7200", "14400", "19200", "38400",
+};
+
+static const char *DelayName[] = {
+    "0", "8.7us", "17us", "35us", "69us", "139us",
+    "278us", "555us", "1.1ms", "2.2ms", "4.4ms", "8.8ms",
+};
+
+static const char *AuxRateName[] = {"10", "100", "400", "800"};
+
+static const char *InputName[] = {"temp", "avdd", "dvdd"};   // ADS1263_INPUT_*
+
+static const struct {
+    const char *Name;
+    ADS1263_FILTER Filter;
+} FilterName[] = {
+    {"sinc1", ADS1263_FILTER_SINC1},
+    {"sinc2", ADS1263_FILTER_SINC2},
+    {"sinc3", ADS1263_FILTER_SINC3},
+    {"sinc4", ADS1263_FILTER_SINC4},
+    {"fir",   ADS1263_FILTER_FIR},
+};
+
+#define COUNT_OF(a) (int)(sizeof(a) / sizeof((a)[0]))
+
+static int Map_Lookup(const char **Table, int Count, const char *Value)
+{
+    int i;
+    for(i = 0; i < Count; i++) {
+        if(strcmp(Table[i], Value) == 0)
+            return i;
+    }
+    return -1;
+}
+
+static int Map_FindChip(const ADS1263_MAP *Map, const char *Name)
+{
+    int i;
+    for(i = 0; i < Map->ChipCount; i++) {
+        if(strcmp(Map->Chip[i].Name, Name) == 0)
+            return i;
+    }
+    return -1;
+}
+
+static UBYTE Map_HasChannels(const ADS1263_MAP *Map, UBYTE Chip)
+{
+    UWORD i;
+    for(i = 0; i < Map->ChannelCount; i++) {
+        if(Map->Channel[i].Chip == Chip)
+            return 1;
+    }
+    return 0;
+}
+
+/* explicit channels of a chip, or the "*" template when it has none */
+static UBYTE Map_Owner(const ADS1263_MAP *Map, UBYTE Chip)
+{
+    return Map_HasChannels(Map, Chip) ? Chip : ADS1263_MAP_ANY;
+}
+
+static void Map_Devices(const ADS1263_MAP *Map)
+{
+    UBYTE b;
+    for(b = 0; b < ADS1263_MAX_BUSES; b++) {
+        if(Map->Device[b][0] != '\0')
+            DEV_SPI_SetDevice(b, Map->Device[b]);
+    }
+}
+
+/******************************************************************************
+function:   Apply one key=value option
+parameter:
+    Option: "key=value" token
+    Chip: Chip being declared, or NULL
+    Rate, Delay, Filter: Settings shared by chip and channel lines
+Info:
+    Returns 0 if the option was understood
+******************************************************************************/
+static UBYTE Map_Option(char *Option, ADS1263_MAP_CHIP *Chip, ADS1263_DRATE *Rate, ADS1263_DELAY *Delay, ADS1263_FILTER *Filter)
+{
+    char *value = strchr(Option, '=');
+    int i;
+
+    if(value == NULL)
+        return 1;
+    *value++ = '\0';
+
+    if(strcmp(Option, "delay") == 0) {
+        if((i = Map_Lookup(DelayName, COUNT_OF(DelayName), value)) < 0)
+            return 1;
+        *Delay = (ADS1263_DELAY)i;
+        return 0;
+    }
+    if(strcmp(Option, "filter") == 0) {
+        for(i = 0; i < COUNT_OF(FilterName); i++) {
+            if(strcmp(FilterName[i].Name, value) == 0) {
+                *Filter = FilterName[i].Filter;
+                return 0;
+            }
+        }
+        return 1;
+    }
+    if(strcmp(Option, "rate") == 0) {
+        if((i = Map_Lookup(RateName, COUNT_OF(RateName), value)) < 0)
+            return 1;
+        *Rate = (ADS1263_DRATE)i;
+        return 0;
+    }
+    if(Chip == NULL)
+        return 1;
+    if(strcmp(Option, "aux") == 0) {
+        if((i = Map_Lookup(AuxRateName, COUNT_OF(AuxRateName), value)) < 0)
+            return 1;
+        Chip->AuxRate = (ADS1263_ADC2_DRATE)i;
+        return 0;
+    }
+    i = atoi(value);
+    if(strcmp(Option, "bus") == 0) {
+        if(value[0] < '0' || value[0] > '9' || i >= ADS1263_MAX_BUSES)
+            return 1;
+        Chip->Bus = i;
+        return 0;
+    }
+    if(i <= 0 || i >= 64)
+        return 1;
+    if(strcmp(Option, "cs") == 0)
+        Chip->CS = i;
+    else if(strcmp(Option, "drdy") == 0)
+        Chip->DRDY = i;
+    else if(strcmp(Option, "rst") == 0)
+        Chip->RST = i;
+    else
+        return 1;
+    return 0;
+}
+
+static UBYTE Map_Line(ADS1263_MAP *Map, char *Line)
+{
+    char *save = NULL;
+    char *tok = strtok_r(Line, " \t\r\n", &save);
+
+    if(tok == NULL || tok[0] == '#')
+        return 0;
+
+    if(strcmp(tok, "bus") == 0) {
+        char *bus = strtok_r(NULL, " \t\r\n", &save);
+        char *device = strtok_r(NULL, " \t\r\n", &save);
+        int b;
+        if(bus == NULL || device == NULL || bus[0] < '0' || bus[0] > '9')
+            return 1;
+        b = atoi(bus);
+        if(b >= ADS1263_MAX_BUSES || strlen(device) >= sizeof(Map->Device[b]))
+            return 1;
+        strcpy(Map->Device[b], device);
+        return 0;
+    }
+
+    if(strcmp(tok, "chip") == 0 || strcmp(tok, "probe") == 0) {
+        ADS1263_MAP_CHIP *c;
+        char auto_name[ADS1263_MAP_NAME];
+        char *name;
+        if(tok[0] == 'p') {
+            snprintf(auto_name, sizeof(auto_name), "adc%d", Map->ChipCount + 1);
+            name = auto_name;
+        } else {
+            name = strtok_r(NULL, " \t\r\n", &save);
+        }
+        if(name == NULL || Map->ChipCount >= ADS1263_MAX_CHIPS || Map_FindChip(Map, name) >= 0)
+            return 1;
+        c = &Map->Chip[Map->ChipCount];
+        memset(c, 0, sizeof(*c));
+        snprintf(c->Name, sizeof(c->Name), "%s", name);
+        c->Probe = (tok[0] == 'p');
+        c->RST = 18;
+        c->Rate = ADS1263_38400SPS;
+        c->Delay = ADS1263_DELAY_35us;
+        c->Filter = ADS1263_FILTER_SINC1;
+        c->AuxRate = ADS1263_ADC2_100SPS;
+        while((tok = strtok_r(NULL, " \t\r\n", &save)) != NULL) {
+            if(Map_Option(tok, c, &c->Rate, &c->Delay, &c->Filter) != 0)
+                return 1;
+        }
+        if(c->CS == 0 || c->DRDY == 0)
+            return 1;
+        Map->ChipCount++;
+        return 0;
+    }
+
+    if(strcmp(tok, "ch") == 0) {
+        ADS1263_MAP_CHANNEL *ch;
+        char *chip = strtok_r(NULL, " \t\r\n", &save);
+        char *input = strtok_r(NULL, " \t\r\n", &save);
+        char *name = strtok_r(NULL, " \t\r\n", &save);
+        int c, in;
+        if(chip == NULL || input == NULL || name == NULL || Map->ChannelCount >= ADS1263_MAP_CHANNELS)
+            return 1;
+        if(strcmp(chip, "*") == 0)
+            c = ADS1263_MAP_ANY;
+        else if((c = Map_FindChip(Map, chip)) < 0)
+            return 1;
+        if((in = Map_Lookup(InputName, COUNT_OF(InputName), input)) >= 0)
+            in += ADS1263_INPUT_TEMP;
+        else if(input[0] < '0' || input[0] > '9' || (in = atoi(input)) > 10)
+            return 1;
+        ch = &Map->Channel[Map->ChannelCount];
+        snprintf(ch->Name, sizeof(ch->Name), "%s", name);
+        ch->Chip = c;
+        ch->Input = in;
+        ch->Adc = 1;
+        ch->Rate = c == ADS1263_MAP_ANY ? ADS1263_38400SPS : Map->Chip[c].Rate;
+        ch->Delay = c == ADS1263_MAP_ANY ? ADS1263_DELAY_35us : Map->Chip[c].Delay;
+        ch->Filter = c == ADS1263_MAP_ANY ? ADS1263_FILTER_SINC1 : Map->Chip[c].Filter;
+        while((tok = strtok_r(NULL, " \t\r\n", &save)) != NULL) {
+            if(strncmp(tok, "hz=", 3) == 0) {
+                ch->Target = atof(tok + 3);
+                if(ch->Target <= 0)
+                    return 1;
+                continue;
+            }
+            if(strncmp(tok, "adc=", 4) == 0) {
+                ch->Adc = atoi(tok + 4);
+                if(ch->Adc != 1 && ch->Adc != 2)
+                    return 1;
+                continue;
+            }
+            if(Map_Option(tok, NULL, &ch->Rate, &ch->Delay, &ch->Filter) != 0)
+                return 1;
+        }
+        Map->ChannelCount++;
+        return 0;
+    }
+    return 1;
+}
+
+UBYTE ADS1263_Map_Parse(ADS1263_MAP *Map, const char *Text)
+{
+    char line[256];
+    int lineno = 0;
+
+    memset(Map, 0, sizeof(*Map));
+    while(*Text) {
+        size_t len = strcspn(Text, "\n");
+        lineno++;
+        if(len >= sizeof(line)) {
+            printf("Channel map line %d too long\r\n", lineno);
+            return 1;
+        }
+        memcpy(line, Text, len);
+        line[len] = '\0';
+        Text += len + (Text[len] == '\n');
+        if(Map_Line(Map, line) != 0) {
+            printf("Channel map error on line %d\r\n", lineno);
+            return 1;
+        }
+    }
+    return 0;
+}
+
+UBYTE ADS1263_Map_Load(ADS1263_MAP *Map, const char *Path)
+{
+    char *text;
+    long size;
+    UBYTE ret;
+    FILE *fp = fopen(Path, "r");
+
+    if(fp == NULL) {
+        printf("Open channel map %s failed\r\n", Path);
+        return 1;
+    }
+    fseek(fp, 0, SEEK_END);
+    size = ftell(fp);
+    fseek(fp, 0, SEEK_SET);
+    text = malloc(size + 1);
+    if(text == NULL || fread(text, 1, size, fp) != (size_t)size) {
+        free(text);
+        fclose(fp);
+        return 1;
+    }
+    text[size] = '\0';
+    fclose(fp);
+
+    ret = ADS1263_Map_Parse(Map, text);
+    free(text);
+    return ret;
+}
+
+UBYTE ADS1263_Map_Compile(const ADS1263_MAP *Map, ADS1263_SCAN *Scan)
+{
+    UBYTE c;
+    UWORD i;
+
+    memset(Scan, 0, sizeof(*Scan));
+    Scan->ChipCount = Map->ChipCount;
+    for(c = 0; c < Map->ChipCount; c++) {
+        ADS1263_SCAN_CHIP *sc = &Scan->Chip[c];
+        sc->Bus = Map->Chip[c].Bus;
+        sc->CS = Map->Chip[c].CS;
+        sc->DRDY = Map->Chip[c].DRDY;
+        sc->Rate = Map->Chip[c].Rate;
+        sc->CurMODE0 = 0xFF;
+        sc->CurMODE1 = 0xFF;
+        sc->CurMODE2 = 0xFF;
+        sc->ADC2CFG = (Map->Chip[c].AuxRate << 6) | 0x20 | ADS1263_ADC2_GAIN_1;  // AVDD/AVSS reference
+        ADS1263_SetDRDYPIN(sc->CS, sc->DRDY);
+    }
+
+    for(c = 0; c < Map->ChipCount; c++) {
+        ADS1263_SCAN_CHIP *sc = &Scan->Chip[c];
+        UBYTE owner = Map_Owner(Map, c);
+        for(i = 0; i < Map->ChannelCount; i++) {
+            const ADS1263_MAP_CHANNEL *ch = &Map->Channel[i];
+            ADS1263_SCAN_ENTRY *e;
+            if(ch->Chip != owner)
+                continue;
+            if(sc->Count + sc->AuxCount >= ADS1263_FRAME_STRIDE) {
+                printf("Chip %s has more than %d channels\r\n", Map->Chip[c].Name, ADS1263_FRAME_STRIDE);
+                return 1;
+            }
+            e = ch->Adc == 2 ? &sc->Aux[sc->AuxCount++] : &sc->Entry[sc->Count++];
+            e->Input = ch->Input;
+            if(ch->Input >= ADS1263_INPUT_TEMP)
+                e->INPMUX = ch->Input * 0x11;           // Monitor on both mux inputs
+            else
+                e->INPMUX = (ch->Input << 4) | 0x0a;    // AINx against AINCOM
+            e->Divider = 1;
+            e->LastFlags = ADS1263_SAMPLE_TIMEOUT;      // Nothing converted yet
+            if(ch->Adc == 2)
+                continue;
+            e->MODE0 = ch->Delay;
+            e->MODE1 = ch->Filter;
+            e->MODE2 = 0x80 | (ADS1263_GAIN_1 << 4) | ch->Rate;  // PGA bypassed
+            e->Target = ch->Target;
+        }
+    }
+    ADS1263_Sched_Build(Scan);
+    return 0;
+}
+
+UBYTE ADS1263_Map_Discover(ADS1263_MAP *Map)
+{
+    ADS1263_DEVICE candidate[ADS1263_MAX_CHIPS], found[ADS1263_MAX_CHIPS];
+    ADS1263_MAP out;
+    UBYTE remap[ADS1263_MAX_CHIPS];
+    UBYTE c, n;
+    UWORD i;
+
+    Map_Devices(Map);
+    for(c = 0; c < Map->ChipCount; c++) {
+        candidate[c].Bus = Map->Chip[c].Bus;
+        candidate[c].CS = Map->Chip[c].CS;
+        candidate[c].DRDY = Map->Chip[c].DRDY;
+        candidate[c].RST = Map->Chip[c].RST;
+        candidate[c].Id = 0;
+    }
+    n = ADS1263_Probe(candidate, Map->ChipCount, found);
+
+    memset(&out, 0, sizeof(out));
+    memcpy(out.Device, Map->Device, sizeof(out.Device));
+    for(c = 0; c < Map->ChipCount; c++) {
+        remap[c] = ADS1263_MAP_ANY;
+        for(i = 0; i < n; i++) {
+            if(found[i].Bus == Map->Chip[c].Bus && found[i].CS == Map->Chip[c].CS)
+                break;
+        }
+        if(i == n) {
+            if(!Map->Chip[c].Probe)
+                printf("Chip %s (CS %d) not found, dropped \r\n", Map->Chip[c].Name, Map->Chip[c].CS);
+            continue;
+        }
+        remap[c] = out.ChipCount;
+        out.Chip[out.ChipCount] = Map->Chip[c];
+        out.Chip[out.ChipCount].Id = found[i].Id;
+        out.ChipCount++;
+    }
+    for(i = 0; i < Map->ChannelCount; i++) {
+        UBYTE chip = Map->Channel[i].Chip;
+        if(chip != ADS1263_MAP_ANY && remap[chip] == ADS1263_MAP_ANY)
+            continue;
+        out.Channel[out.ChannelCount] = Map->Channel[i];
+        if(chip != ADS1263_MAP_ANY)
+            out.Channel[out.ChannelCount].Chip = remap[chip];
+        out.ChannelCount++;
+    }
+
+    *Map = out;
+    printf("Discovered %d of %d ADS1263 chips \r\n", out.ChipCount, c);
+    return out.ChipCount == 0;
+}
+
+UBYTE ADS1263_Map_Init(const ADS1263_MAP *Map, const char *HashFile)
+{
+    ADS1263_STARTUP startup[ADS1263_MAX_CHIPS];
+    UBYTE Bus = DEV_HARDWARE_SPI_CurrentBus();
+    UBYTE c, ret = 0;
+
+    Map_Devices(Map);
+    for(c = 0; c < Map->ChipCount && ret == 0; c++) {
+        const ADS1263_MAP_CHIP *chip = &Map->Chip[c];
+        if(chip->Id != 0)
+            continue;
+        if(DEV_SPI_SelectBus(chip->Bus) != 0 || DEV_Module_Init(chip->RST, chip->CS, chip->DRDY) != 0)
+            ret = 1;
+    }
+    DEV_SPI_SelectBus(Bus);
+    if(ret != 0)
+        return 1;
+
+    for(c = 0; c < Map->ChipCount; c++) {
+        const ADS1263_MAP_CHIP *chip = &Map->Chip[c];
+        memset(&startup[c], 0, sizeof(startup[c]));
+        startup[c].Bus = chip->Bus;
+        startup[c].CS = chip->CS;
+        startup[c].Rate = chip->Rate;
+        startup[c].Delay = chip->Delay;
+        startup[c].Filter = chip->Filter;
+        startup[c].HaveCalib = (ADS1263_Calib_Get(chip->Bus, chip->CS, chip->Rate, startup[c].Calib) == 0);
+    }
+    return ADS1263_Startup(startup, Map->ChipCount, HashFile);
+}
+
+const char *ADS1263_Map_Name(const ADS1263_MAP *Map, UBYTE Chip, UBYTE Slot)
+{
+    UBYTE owner = Map_Owner(Map, Chip);
+    UWORD i;
+    UBYTE adc, n = 0;
+    for(adc = 1; adc <= 2; adc++) {
+        for(i = 0; i < Map->ChannelCount; i++) {
+            if(Map->Channel[i].Chip != owner || Map->Channel[i].Adc != adc)
+                continue;
+            if(n++ == Slot)
+                return Map->Channel[i].Name;
+        }
+    }
+    return "";
+}
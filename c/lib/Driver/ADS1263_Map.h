@@ -0,0 +1,190 @@
+/*****************************************************************************
+* | File        :   ADS1263_Map.h
+* | Author      :   Highz team
+* | Function    :   Declarative channel map for the ADC stack
+* | Info        :
+*----------------
+* | This version:   V1.0
+* | Date        :   2026-10-19
+* | Info        :
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documnetation files (the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to  whom the Software is
+# furished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included in
+# all copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS OR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+# THE SOFTWARE.
+#
+******************************************************************************/
+#ifndef _ADS1263_MAP_H_
+#define _ADS1263_MAP_H_
+
+#include "ADS1263.h"
+
+/******************************************************************************
+Channel Map
+
+The stack topology is described in a text file instead of code. Chips are
+listed first, in frame-row order; channels follow, in scan order:
+
+    # chip <name> cs=<pin> drdy=<pin> [bus=<n>] [rst=<pin>] [rate=<sps>] [delay=<t>] [filter=<f>] [aux=<sps>]
+    chip adc1 cs=12 drdy=16 rst=18 rate=38400 delay=35us filter=sinc1
+    # ch <chip> <input> <name> [rate=<sps>] [delay=<t>] [filter=<f>] [hz=<n>] [adc=2]
+    ch adc1 0 det01
+    ch adc1 7 state1 delay=0 filter=sinc1
+    ch adc2 7 supply adc=2
+    ch adc1 temp temp1 adc=2
+
+Boards added to the stack do not need to be named one by one. A probe line
+declares a candidate CS/DRDY pair (named adc<N> by position), and channels
+given for chip "*" apply to every chip that has no ch lines of its own:
+
+    probe cs=5 drdy=6 rate=38400
+    ch * 0 det
+
+The second SPI controller is used by giving chips bus=1 (default 0). Each bus
+is scanned by its own thread (ADS1263_MultiBus). A bus line overrides the
+spidev node of a bus:
+
+    bus 1 /dev/spidev1.0
+    chip adc9 bus=1 cs=26 drdy=27
+
+    input  : 0-10 (AINx against AINCOM), temp, avdd, dvdd
+    rate   : 2.5 5 10 16.6 20 50 60 100 400 1200 2400 4800 7200 14400 19200 38400
+    delay  : 0 8.7us 17us 35us 69us 139us 278us 555us 1.1ms 2.2ms 4.4ms 8.8ms
+    filter : sinc1 sinc2 sinc3 sinc4 fir
+    aux    : 10 100 400 800 (ADC2 rate, default 100)
+
+Channels with adc=2 are converted by the chip's ADC2 alongside the ADC1
+channels and take no time from them (see ADS1263.h); rate, delay, filter
+and hz do not apply to them. Their frame slots follow the ADC1 channels.
+
+Channel rate/delay/filter default to the chip's and may differ from channel
+to channel; the scan only rewrites the registers that change. hz= asks for
+at least that many samples per second instead of one every sweep, and the
+time saved goes to the other channels (see ADS1263_Sched.h). Inputs not listed are never
+converted. ADS1263_Map_Discover keeps only the chips that answer on the bus,
+so the same file serves any number of stacked boards up to
+ADS1263_MAX_CHIPS_PER_BUS on each bus. See examples/channels.map for the Highz allocation.
+******************************************************************************/
+#define ADS1263_MAP_NAME        16
+#define ADS1263_MAP_CHANNELS    (ADS1263_MAX_CHIPS * ADS1263_FRAME_STRIDE)
+#define ADS1263_MAP_ANY         0xFF    // Channel.Chip of "*" template channels
+
+typedef struct
+{
+    char  Name[ADS1263_MAP_NAME];
+    UBYTE Bus;              // SPI bus, 0 .. ADS1263_MAX_BUSES-1
+    UWORD CS;
+    UWORD DRDY;
+    UWORD RST;
+    ADS1263_DRATE Rate;
+    ADS1263_DELAY Delay;
+    ADS1263_FILTER Filter;
+    ADS1263_ADC2_DRATE AuxRate;     // ADC2 rate for adc=2 channels
+    UBYTE Probe;            // Declared by a probe line
+    UBYTE Id;               // REG_ID once discovered, 0 = not probed
+} ADS1263_MAP_CHIP;
+
+typedef struct
+{
+    char  Name[ADS1263_MAP_NAME];
+    UBYTE Chip;             // Index into ADS1263_MAP.Chip, or ADS1263_MAP_ANY
+    UBYTE Input;            // AIN0-AIN10 or ADS1263_INPUT_*
+    UBYTE Adc;              // Converter, 1 or 2
+    ADS1263_DRATE Rate;
+    ADS1263_DELAY Delay;
+    ADS1263_FILTER Filter;
+    float Target;           // hz=, 0 = every sweep
+} ADS1263_MAP_CHANNEL;
+
+typedef struct
+{
+    UBYTE ChipCount;
+    UWORD ChannelCount;
+    char  Device[ADS1263_MAX_BUSES][32];   // spidev node per bus, "" = default
+    ADS1263_MAP_CHIP Chip[ADS1263_MAX_CHIPS];
+    ADS1263_MAP_CHANNEL Channel[ADS1263_MAP_CHANNELS];
+} ADS1263_MAP;
+
+/******************************************************************************
+function:   Parse a channel map from text
+parameter:
+    Map: Map to fill
+    Text: NUL-terminated map text
+Info:
+    Returns 0 on success, 1 on a syntax or range error (line is printed)
+******************************************************************************/
+UBYTE ADS1263_Map_Parse(ADS1263_MAP *Map, const char *Text);
+
+/******************************************************************************
+function:   Load a channel map file
+parameter:
+    Map: Map to fill
+    Path: Map file
+Info:
+    Returns 0 on success, 1 on failure
+******************************************************************************/
+UBYTE ADS1263_Map_Load(ADS1263_MAP *Map, const char *Path);
+
+/******************************************************************************
+function:   Probe the chips of a map and drop those that do not answer
+parameter:
+    Map: Parsed map, rewritten in place
+Info:
+    Chips keep their relative order, so frame rows follow the file.
+    Channels of dropped chips are removed
+    Returns 0 if at least one chip answered, 1 otherwise
+******************************************************************************/
+UBYTE ADS1263_Map_Discover(ADS1263_MAP *Map);
+
+/******************************************************************************
+function:   Compile a map into a scan table
+parameter:
+    Map: Parsed map
+    Scan: Scan table to fill
+Info:
+    Also registers each chip's DRDY pin for get_DRDYPIN and builds the
+    multi-rate pattern (ADS1263_Sched_Build)
+    Returns 0 on success, 1 if a chip has more channels than a frame row
+******************************************************************************/
+UBYTE ADS1263_Map_Compile(const ADS1263_MAP *Map, ADS1263_SCAN *Scan);
+
+/******************************************************************************
+function:   Bring up every chip in a map
+parameter:
+    Map: Parsed map
+    HashFile: Configuration hash file for ADS1263_Startup, or NULL
+Info:
+    GPIO/SPI set-up, then ADC1 configuration at each chip's data rate with
+    all buses in parallel. Chips already set up by ADS1263_Map_Discover
+    skip the GPIO/SPI step; chips whose registers still match the hash
+    file are not reconfigured. Coefficients loaded with ADS1263_Calib_Load
+    are restored in the same burst
+    Returns 0 on success, 1 on failure
+******************************************************************************/
+UBYTE ADS1263_Map_Init(const ADS1263_MAP *Map, const char *HashFile);
+
+/******************************************************************************
+function:   Name of the channel in a frame slot
+parameter:
+    Map: Map the scan table was compiled from
+    Chip, Slot: Frame position
+Info:
+    Follows the frame order: ADC1 channels, then ADC2 channels
+    Returns "" for unused slots
+******************************************************************************/
+const char *ADS1263_Map_Name(const ADS1263_MAP *Map, UBYTE Chip, UBYTE Slot);
+
+#endif
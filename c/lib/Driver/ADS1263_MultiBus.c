@@ -0,0 +1,263 @@
+/*****************************************************************************
+* | File        :   ADS1263_MultiBus.c
+* | Author      :   Highz team
+* | Function    :   Parallel acquisition across SPI buses
+* | Info        :
+*----------------
+* | This version:   V1.0
+* | Date        :   2026-10-19
+* | Info        :
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documnetation files (the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to  whom the Software is
+# furished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included in
+# all copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS OR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+# THE SOFTWARE.
+#
+******************************************************************************/
+#include <string.h>
+#include <time.h>
+#include "ADS1263_MultiBus.h"
+#include "ADS1263_Reconfig.h"
+#include "ADS1263_RT.h"
+
+typedef struct
+{
+    ADS1263_MULTIBUS *Mb;
+    UBYTE Bus;
+} MULTIBUS_WORKER;
+
+static MULTIBUS_WORKER Worker[ADS1263_MAX_BUSES];
+
+/******************************************************************************
+function:   Scan loop of one bus
+parameter:
+    Arg: MULTIBUS_WORKER of the bus
+Info:
+    The lock is only taken at sweep boundaries, never around SPI traffic
+******************************************************************************/
+static void *MultiBus_Worker(void *Arg)
+{
+    MULTIBUS_WORKER *w = (MULTIBUS_WORKER *)Arg;
+    ADS1263_MULTIBUS *Mb = w->Mb;
+    ADS1263_SCAN *Scan = Mb->Scan;
+    UBYTE Bus = w->Bus;
+    uint64_t Sequence = 0;
+    ADS1263_CALIB_SCHED calib;
+    ADS1263_SCAN_CHIP staged[ADS1263_MAX_CHIPS];
+    UBYTE c, apply;
+
+    memset(&calib, 0, sizeof(calib));
+    ADS1263_RT_EnterBus(Bus);
+    DEV_SPI_SelectBus(Bus);
+    while(1) {
+        ADS1263_MULTIBUS_SLOT *slot = &Mb->Slot[Sequence % ADS1263_MULTIBUS_DEPTH];
+
+        // Wait for the consumer to free the slot
+        pthread_mutex_lock(&Mb->Lock);
+        while(Mb->Running && Sequence - Mb->Consumed >= ADS1263_MULTIBUS_DEPTH)
+            pthread_cond_wait(&Mb->Cond, &Mb->Lock);
+        Mb->Next[Bus] = Sequence + 1;
+        apply = (Mb->ApplyMask & (1 << Bus)) && Sequence >= Mb->ApplySeq;
+        if(apply) {
+            // Take this bus's part of the staged table
+            for(c = 0; c < Scan->ChipCount; c++) {
+                if(Scan->Chip[c].Bus == Bus)
+                    staged[c] = Mb->Staged.Chip[c];
+            }
+            Mb->BusEpoch[Bus] = Mb->Staged.Epoch;
+            Mb->ApplyMask &= ~(1 << Bus);
+            if(Mb->ApplyMask == 0)
+                Scan->Epoch = Mb->Staged.Epoch;
+        }
+        slot->Epoch[Bus] = Mb->BusEpoch[Bus];
+        pthread_mutex_unlock(&Mb->Lock);
+        if(!Mb->Running)
+            break;
+
+        // Sweep boundary: switch this bus's chips to the staged table
+        if(apply) {
+            for(c = 0; c < Scan->ChipCount; c++) {
+                if(Scan->Chip[c].Bus == Bus)
+                    ADS1263_Reconfig_Chip(Scan, c, &staged[c]);
+            }
+            DEV_SPI_SelectBus(Bus);
+        }
+
+        slot->Time_ns[Bus] = ADS1263_Clock_ns(CLOCK_REALTIME);
+        slot->Start_ns[Bus] = ADS1263_Clock_ns(CLOCK_MONOTONIC);
+        for(c = 0; c < Scan->ChipCount; c++) {
+            if(Scan->Chip[c].Bus != Bus)
+                continue;
+            ADS1263_Calib_Before(&calib, Scan, c);
+            ADS1263_ScanChip(Scan, c, &slot->Frame);
+            ADS1263_Calib_After(&calib, Scan, c);
+        }
+        slot->End_ns[Bus] = ADS1263_Clock_ns(CLOCK_MONOTONIC);
+
+        pthread_mutex_lock(&Mb->Lock);
+        slot->Pending &= ~(1 << Bus);
+        if(slot->Pending == 0)
+            pthread_cond_broadcast(&Mb->Cond);
+        pthread_mutex_unlock(&Mb->Lock);
+        Sequence++;
+    }
+    return NULL;
+}
+
+UBYTE ADS1263_MultiBus_Start(ADS1263_MULTIBUS *Mb, ADS1263_SCAN *Scan)
+{
+    UBYTE b, c;
+
+    memset(Mb, 0, sizeof(*Mb));
+    Mb->Scan = Scan;
+    for(c = 0; c < Scan->ChipCount; c++) {
+        if(Scan->Chip[c].Bus >= ADS1263_MAX_BUSES) {
+            printf("Chip %d: no SPI bus %d \r\n", c, Scan->Chip[c].Bus);
+            return 1;
+        }
+        Mb->BusMask |= 1 << Scan->Chip[c].Bus;
+    }
+    for(b = 0; b < ADS1263_MAX_BUSES; b++)
+        Mb->BusEpoch[b] = Scan->Epoch;
+    for(c = 0; c < ADS1263_MULTIBUS_DEPTH; c++) {
+        ADS1263_Frame_Init(&Mb->Slot[c].Frame, Scan->ChipCount);
+        Mb->Slot[c].Frame.Header.Sequence = c;     // Read by the scan schedule
+        Mb->Slot[c].Pending = Mb->BusMask;
+    }
+    pthread_mutex_init(&Mb->Lock, NULL);
+    pthread_cond_init(&Mb->Cond, NULL);
+
+    Mb->Running = 1;
+    for(b = 0; b < ADS1263_MAX_BUSES; b++) {
+        if(!(Mb->BusMask & (1 << b)))
+            continue;
+        Worker[b].Mb = Mb;
+        Worker[b].Bus = b;
+        if(pthread_create(&Mb->Worker[b], NULL, MultiBus_Worker, &Worker[b]) != 0) {
+            printf("Start bus %d thread failed \r\n", b);
+            Mb->BusMask &= (1 << b) - 1;    // Only join the threads that exist
+            ADS1263_MultiBus_Stop(Mb);
+            return 1;
+        }
+    }
+    return 0;
+}
+
+ADS1263_FRAME *ADS1263_MultiBus_Acquire(ADS1263_MULTIBUS *Mb)
+{
+    ADS1263_MULTIBUS_SLOT *slot = &Mb->Slot[Mb->Consumed % ADS1263_MULTIBUS_DEPTH];
+    ADS1263_FRAME_HEADER *h = &slot->Frame.Header;
+    UBYTE b, ready, first = 1;
+
+    pthread_mutex_lock(&Mb->Lock);
+    while(Mb->Running && slot->Pending != 0)
+        pthread_cond_wait(&Mb->Cond, &Mb->Lock);
+    ready = (slot->Pending == 0);
+    pthread_mutex_unlock(&Mb->Lock);
+    if(!ready)
+        return NULL;
+
+    // Merge the per-bus spans into one sweep
+    h->Sequence = Mb->Consumed;
+    for(b = 0; b < ADS1263_MAX_BUSES; b++) {
+        if(!(Mb->BusMask & (1 << b)))
+            continue;
+        h->Epoch = slot->Epoch[b];      // Equal on every bus by construction
+        if(first || slot->Start_ns[b] < h->Start_ns) {
+            h->Start_ns = slot->Start_ns[b];
+            h->Time_ns = slot->Time_ns[b];
+        }
+        if(first || slot->End_ns[b] > h->End_ns)
+            h->End_ns = slot->End_ns[b];
+        first = 0;
+    }
+    ADS1263_Frame_Summarize(&slot->Frame);
+    return &slot->Frame;
+}
+
+void ADS1263_MultiBus_Release(ADS1263_MULTIBUS *Mb)
+{
+    ADS1263_MULTIBUS_SLOT *slot = &Mb->Slot[Mb->Consumed % ADS1263_MULTIBUS_DEPTH];
+
+    pthread_mutex_lock(&Mb->Lock);
+    slot->Pending = Mb->BusMask;
+    slot->Frame.Header.Sequence = Mb->Consumed + ADS1263_MULTIBUS_DEPTH;
+    Mb->Consumed++;
+    pthread_cond_broadcast(&Mb->Cond);
+    pthread_mutex_unlock(&Mb->Lock);
+}
+
+UBYTE ADS1263_MultiBus_Reconfigure(ADS1263_MULTIBUS *Mb, const ADS1263_SCAN *New, UDOUBLE *Epoch)
+{
+    UBYTE b;
+
+    if(ADS1263_Reconfig_Check(Mb->Scan, New) != 0) {
+        printf("Reconfigure: chip set differs, not applied \r\n");
+        return 1;
+    }
+
+    pthread_mutex_lock(&Mb->Lock);
+    // Not waiting here: the caller may be the consumer the buses wait for
+    if(Mb->ApplyMask != 0 && Mb->ApplyMask != Mb->BusMask) {
+        pthread_mutex_unlock(&Mb->Lock);
+        return 1;
+    }
+    if(Mb->ApplyMask != 0) {
+        // Still untouched by every bus: replace it, same epoch and sweep
+        UDOUBLE staged = Mb->Staged.Epoch;
+        Mb->Staged = *New;
+        Mb->Staged.Epoch = staged;
+        if(Epoch != NULL)
+            *Epoch = staged;
+        pthread_mutex_unlock(&Mb->Lock);
+        return 0;
+    }
+    Mb->Staged = *New;
+    Mb->Staged.Epoch = Mb->BusEpoch[0];
+    for(b = 0; b < ADS1263_MAX_BUSES; b++) {
+        if(Mb->BusEpoch[b] > Mb->Staged.Epoch)
+            Mb->Staged.Epoch = Mb->BusEpoch[b];
+    }
+    Mb->Staged.Epoch++;
+
+    // First sweep that no bus has started
+    Mb->ApplySeq = 0;
+    for(b = 0; b < ADS1263_MAX_BUSES; b++) {
+        if((Mb->BusMask & (1 << b)) && Mb->Next[b] > Mb->ApplySeq)
+            Mb->ApplySeq = Mb->Next[b];
+    }
+    Mb->ApplyMask = Mb->BusMask;
+    if(Epoch != NULL)
+        *Epoch = Mb->Staged.Epoch;
+    pthread_mutex_unlock(&Mb->Lock);
+    return 0;
+}
+
+void ADS1263_MultiBus_Stop(ADS1263_MULTIBUS *Mb)
+{
+    UBYTE b;
+
+    pthread_mutex_lock(&Mb->Lock);
+    Mb->Running = 0;
+    pthread_cond_broadcast(&Mb->Cond);
+    pthread_mutex_unlock(&Mb->Lock);
+    for(b = 0; b < ADS1263_MAX_BUSES; b++) {
+        if(Mb->BusMask & (1 << b))
+            pthread_join(Mb->Worker[b], NULL);
+    }
+    pthread_cond_destroy(&Mb->Cond);
+    pthread_mutex_destroy(&Mb->Lock);
+}
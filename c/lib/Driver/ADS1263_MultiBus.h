@@ -0,0 +1,147 @@
+/*****************************************************************************
+* | File        :   ADS1263_MultiBus.h
+* | Author      :   Highz team
+* | Function    :   Parallel acquisition across SPI buses
+* | Info        :
+*----------------
+* | This version:   V1.0
+* | Date        :   2026-10-19
+* | Info        :
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documnetation files (the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to  whom the Software is
+# furished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included in
+# all copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS OR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+# THE SOFTWARE.
+#
+******************************************************************************/
+#ifndef _ADS1263_MULTIBUS_H_
+#define _ADS1263_MULTIBUS_H_
+
+#include <pthread.h>
+#include "ADS1263.h"
+#include "ADS1263_Calib.h"
+
+/******************************************************************************
+Multi-Bus Acquisition
+
+The Pi has two usable SPI controllers (spidev0, spidev1). Chips on different
+controllers do not share a clock or a chip select, so they can convert and be
+read at the same time. One worker thread is started per bus in use; each
+scans only its own chips (ADS1263_ScanChip) into the shared frame ring:
+
+    bus 0 worker --+--> [ Slot 0 ][ Slot 1 ] ... [ Slot DEPTH-1 ]  --> consumer
+    bus 1 worker --+        rows of a slot are owned by one bus each
+
+A slot is handed to the consumer once every bus has filled its rows. Its
+header is merged from the per-bus scans: Start_ns/Time_ns are the earliest
+bus start, End_ns the latest bus end, and ChipTime_ns keeps each chip's own
+start, so the skew between buses is visible in every frame.
+
+A bus that gets ADS1263_MULTIBUS_DEPTH sweeps ahead of the consumer waits;
+no sweep is dropped. With the chips split evenly over the two buses the
+sweep rate is close to double that of a single bus. Background offset
+recalibration (ADS1263_Calib_SetInterval) runs inside each bus thread.
+Each bus thread applies the real-time policy set with ADS1263_RT_Init
+(CPU, SCHED_FIFO priority) as it starts.
+
+ADS1263_MultiBus_Reconfigure stages a new scan table. It takes effect at
+the first sweep that no bus has started yet: each bus applies its own
+chips' part when it reaches that sequence number, so every frame is
+entirely old or entirely new configuration, and Header.Epoch says which.
+******************************************************************************/
+#define ADS1263_MULTIBUS_DEPTH  8       // Frames in flight
+
+typedef struct
+{
+    ADS1263_FRAME Frame;
+    UBYTE    Pending;                       // Buses still filling this slot
+    uint64_t Time_ns[ADS1263_MAX_BUSES];    // Per-bus CLOCK_REALTIME start
+    uint64_t Start_ns[ADS1263_MAX_BUSES];   // Per-bus CLOCK_MONOTONIC start
+    uint64_t End_ns[ADS1263_MAX_BUSES];     // Per-bus CLOCK_MONOTONIC end
+    UDOUBLE  Epoch[ADS1263_MAX_BUSES];      // Per-bus configuration epoch
+} ADS1263_MULTIBUS_SLOT;
+
+typedef struct
+{
+    ADS1263_SCAN *Scan;
+    UBYTE    BusMask;                   // Buses that have at least one chip
+    volatile UBYTE Running;
+    uint64_t Consumed;                  // Sequence of the next frame to hand out
+    uint64_t Next[ADS1263_MAX_BUSES];   // Sequence each bus starts next
+    UDOUBLE  BusEpoch[ADS1263_MAX_BUSES];   // Epoch each bus is scanning under
+    ADS1263_SCAN Staged;                // Configuration waiting to be applied
+    uint64_t ApplySeq;                  // First sweep of the staged configuration
+    UBYTE    ApplyMask;                 // Buses that have not applied it yet
+    pthread_mutex_t Lock;
+    pthread_cond_t  Cond;
+    pthread_t Worker[ADS1263_MAX_BUSES];
+    ADS1263_MULTIBUS_SLOT Slot[ADS1263_MULTIBUS_DEPTH];
+} ADS1263_MULTIBUS;
+
+/******************************************************************************
+function:   Start one scan thread per SPI bus
+parameter:
+    Mb: Acquisition state, usually static (it holds the frame ring)
+    Scan: Compiled scan table; chips are grouped by their Bus field
+Info:
+    The chips must already be initialised (ADS1263_Map_Init)
+    Returns 0 on success, 1 on failure
+******************************************************************************/
+UBYTE ADS1263_MultiBus_Start(ADS1263_MULTIBUS *Mb, ADS1263_SCAN *Scan);
+
+/******************************************************************************
+function:   Wait for the next complete sweep
+parameter:
+    Mb: Running acquisition
+Info:
+    Frames come out in sequence order. The frame stays valid until
+    ADS1263_MultiBus_Release; convert it in place as with ADS1263_Scan.
+    Returns NULL once the acquisition has been stopped
+******************************************************************************/
+ADS1263_FRAME *ADS1263_MultiBus_Acquire(ADS1263_MULTIBUS *Mb);
+
+/******************************************************************************
+function:   Give the frame returned by ADS1263_MultiBus_Acquire back
+parameter:
+    Mb: Running acquisition
+Info:
+******************************************************************************/
+void ADS1263_MultiBus_Release(ADS1263_MULTIBUS *Mb);
+
+/******************************************************************************
+function:   Stage a new scan table for the running acquisition
+parameter:
+    Mb: Running acquisition
+    New: New table for the same chips (see ADS1263_Reconfig.h)
+    Epoch: Receives the epoch frames taken under New will carry, or NULL
+Info:
+    Returns at once; the table is applied at the next sweep boundary.
+    A change no bus has applied yet is replaced by the new one
+    Returns 0 on success, 1 if New is for a different set of chips or a
+    previous change is half applied (retry after the next frame)
+******************************************************************************/
+UBYTE ADS1263_MultiBus_Reconfigure(ADS1263_MULTIBUS *Mb, const ADS1263_SCAN *New, UDOUBLE *Epoch);
+
+/******************************************************************************
+function:   Stop the bus threads
+parameter:
+    Mb: Acquisition started with ADS1263_MultiBus_Start
+Info:
+    Each bus finishes its current sweep before its thread exits
+******************************************************************************/
+void ADS1263_MultiBus_Stop(ADS1263_MULTIBUS *Mb);
+
+#endif
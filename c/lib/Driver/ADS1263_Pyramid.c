@@ -0,0 +1,309 @@
+/*****************************************************************************
+* | File        :   ADS1263_Pyramid.c
+* | Author      :   Highz team
+* | Function    :   Min/max/mean summary pyramid
+* | Info        :
+*----------------
+* | This version:   V1.0
+* | Date        :   2026-10-19
+* | Info        :
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documnetation files (the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to  whom the Software is
+# furished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included in
+# all copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS OR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+# THE SOFTWARE.
+#
+******************************************************************************/
+#include <string.h>
+#include <time.h>
+#include "ADS1263_Pyramid.h"
+#include "ADS1263_Convert.h"
+
+// Samples that say nothing about the input: repeated, or never read back
+#define SKIP_FLAGS  (ADS1263_SAMPLE_STALE | ADS1263_SAMPLE_TIMEOUT | ADS1263_SAMPLE_CRC)
+
+void ADS1263_Pyramid_Defaults(ADS1263_PYRAMID_CONFIG *Config)
+{
+    ADS1263_Writer_Defaults(&Config->Writer);
+    Config->Writer.Buffers = 2;
+    Config->Writer.BufferSize = 1024 * 1024;
+    Config->Writer.Threads = 1;
+    Config->BaseLog2 = 30;
+    Config->Levels = 20;
+    Config->PageBuckets = 128;
+    Config->FlushBuckets = 16;
+}
+
+/* visit the channels of a map in frame order */
+static UWORD Pyramid_Names(const ADS1263_MAP *Map, char (*Name)[ADS1263_PYRAMID_NAME])
+{
+    UWORD columns = 0;
+    UBYTE chip, slot;
+
+    for(chip = 0; chip < Map->ChipCount; chip++) {
+        for(slot = 0; slot < ADS1263_FRAME_STRIDE; slot++) {
+            const char *channel = ADS1263_Map_Name(Map, chip, slot);
+            if(channel[0] == '\0')
+                break;
+            if(Name != NULL)
+                snprintf(Name[columns], ADS1263_PYRAMID_NAME, "%s.%s", Map->Chip[chip].Name, channel);
+            columns++;
+        }
+    }
+    return columns;
+}
+
+static size_t Pyramid_PageSize(UWORD Columns, UWORD Buckets)
+{
+    return sizeof(ADS1263_PYRAMID_PAGE) + (size_t)Columns * Buckets * sizeof(ADS1263_PYRAMID_BUCKET);
+}
+
+size_t ADS1263_Pyramid_Reserve(const ADS1263_PYRAMID_CONFIG *Config, const ADS1263_MAP *Map)
+{
+    UWORD columns = Pyramid_Names(Map, NULL);
+    return ADS1263_Writer_Reserve(&Config->Writer)
+         + (size_t)columns * ADS1263_PYRAMID_NAME + ADS1263_ARENA_ALIGN
+         + (size_t)Config->Levels * ((size_t)columns * sizeof(ADS1263_PYRAMID_BUCKET) + ADS1263_ARENA_ALIGN)
+         + (size_t)Config->Levels * (Pyramid_PageSize(columns, Config->PageBuckets) + ADS1263_ARENA_ALIGN);
+}
+
+static void Pyramid_Reset(ADS1263_PYRAMID *p, UBYTE Level, uint64_t Bucket)
+{
+    UWORD c;
+    for(c = 0; c < p->Columns; c++) {
+        p->Acc[Level][c].Min = INT32_MAX;
+        p->Acc[Level][c].Max = INT32_MIN;
+        p->Acc[Level][c].Sum = 0;
+        p->Acc[Level][c].Count = 0;
+        p->Acc[Level][c].Flags = 0;
+    }
+    p->Current[Level] = Bucket;
+    p->Active[Level] = 1;
+}
+
+UBYTE ADS1263_Pyramid_Open(ADS1263_PYRAMID *p, ADS1263_SESSION *Session, const char *Path,
+                           const ADS1263_MAP *Map, const ADS1263_PYRAMID_CONFIG *Config)
+{
+    ADS1263_PYRAMID_FILE file;
+    ADS1263_PYRAMID_COLUMN column;
+    UBYTE level;
+    UWORD c;
+
+    memset(p, 0, sizeof(*p));
+    p->Config = *Config;
+    p->Map = Map;
+    p->Columns = Pyramid_Names(Map, NULL);
+    if(Config->Levels == 0 || Config->Levels > ADS1263_PYRAMID_MAX_LEVELS || Config->BaseLog2 + Config->Levels > 63 ||
+       Config->PageBuckets == 0 || Pyramid_PageSize(p->Columns, Config->PageBuckets) > Config->Writer.BufferSize) {
+        printf("Pyramid: bad level or page configuration \r\n");
+        return 1;
+    }
+    p->Name = ADS1263_Session_Alloc(Session, (size_t)p->Columns * ADS1263_PYRAMID_NAME);
+    if(p->Name == NULL)
+        return 1;
+    Pyramid_Names(Map, p->Name);
+    for(level = 0; level < Config->Levels; level++) {
+        p->Acc[level] = ADS1263_Session_Alloc(Session, (size_t)p->Columns * sizeof(ADS1263_PYRAMID_BUCKET));
+        p->Page[level] = ADS1263_Session_Alloc(Session, Pyramid_PageSize(p->Columns, Config->PageBuckets));
+        if(p->Acc[level] == NULL || p->Page[level] == NULL)
+            return 1;
+        memset(p->Page[level], 0, sizeof(ADS1263_PYRAMID_PAGE));
+        ((ADS1263_PYRAMID_PAGE *)p->Page[level])->Magic = ADS1263_PYRAMID_PAGE_MAGIC;
+        ((ADS1263_PYRAMID_PAGE *)p->Page[level])->Level = level;
+    }
+    if(ADS1263_Writer_Open(&p->Writer, Session, Path, &Config->Writer) != 0)
+        return 1;
+
+    memset(&file, 0, sizeof(file));
+    file.Magic = ADS1263_PYRAMID_MAGIC;
+    file.Version = ADS1263_PYRAMID_VERSION;
+    file.Columns = p->Columns;
+    file.BaseLog2 = Config->BaseLog2;
+    file.Levels = Config->Levels;
+    file.PageBuckets = Config->PageBuckets;
+    file.Created_ns = ADS1263_Clock_ns(CLOCK_REALTIME);
+    if(ADS1263_Writer_WriteWait(&p->Writer, &file, sizeof(file)) != 0)
+        return 1;
+    for(c = 0; c < p->Columns; c++) {
+        const char *dot = strchr(p->Name[c], '.');
+        UBYTE chip;
+        memset(&column, 0, sizeof(column));
+        memcpy(column.Name, p->Name[c], ADS1263_PYRAMID_NAME);
+        column.Ref = ADS1263_REF_DEFAULT;
+        for(chip = 0; chip < Map->ChipCount; chip++) {
+            if(strncmp(Map->Chip[chip].Name, p->Name[c], dot - p->Name[c]) == 0 && Map->Chip[chip].Name[dot - p->Name[c]] == '\0')
+                column.Ref = ADS1263_GetRef(chip);
+        }
+        if(ADS1263_Writer_WriteWait(&p->Writer, &column, sizeof(column)) != 0)
+            return 1;
+    }
+    return 0;
+}
+
+/* frame slot -> column, by name, for the configuration epoch of Frame */
+static void Pyramid_Map(ADS1263_PYRAMID *p, const ADS1263_FRAME *Frame)
+{
+    char name[ADS1263_PYRAMID_NAME];
+    UBYTE chip, slot;
+    UWORD c;
+
+    for(chip = 0; chip < ADS1263_MAX_CHIPS; chip++) {
+        for(slot = 0; slot < ADS1263_FRAME_STRIDE; slot++) {
+            p->Slot[chip][slot] = -1;
+            if(chip >= Frame->Header.ChipCount || chip >= p->Map->ChipCount || slot >= Frame->Count[chip])
+                continue;
+            snprintf(name, sizeof(name), "%s.%s", p->Map->Chip[chip].Name, ADS1263_Map_Name(p->Map, chip, slot));
+            for(c = 0; c < p->Columns; c++) {
+                if(strcmp(p->Name[c], name) == 0) {
+                    p->Slot[chip][slot] = c;
+                    break;
+                }
+            }
+        }
+    }
+    p->Epoch = Frame->Header.Epoch;
+    p->Mapped = 1;
+}
+
+static UBYTE Pyramid_Flush(ADS1263_PYRAMID *p, UBYTE Level, UBYTE Wait)
+{
+    ADS1263_PYRAMID_PAGE *h = (ADS1263_PYRAMID_PAGE *)p->Page[Level];
+    ADS1263_PYRAMID_BUCKET *b = (ADS1263_PYRAMID_BUCKET *)(h + 1);
+    size_t size;
+    UWORD c;
+    UBYTE ret;
+
+    if(h->Count == 0)
+        return 0;
+    // Columns were filled at full-page spacing; close the gaps of a short page
+    if(h->Count < p->Config.PageBuckets) {
+        for(c = 1; c < p->Columns; c++)
+            memmove(b + (size_t)c * h->Count, b + (size_t)c * p->Config.PageBuckets, h->Count * sizeof(*b));
+    }
+    size = Pyramid_PageSize(p->Columns, h->Count);
+    ret = Wait ? ADS1263_Writer_WriteWait(&p->Writer, h, size) : ADS1263_Writer_Write(&p->Writer, h, size);
+    if(ret != 0)
+        p->Stats.Dropped++;
+    else
+        p->Stats.Pages++;
+    h->Count = 0;
+    return ret;
+}
+
+/* the bucket of a level is complete: store it and merge it one level up */
+static UBYTE Pyramid_Finish(ADS1263_PYRAMID *p, UBYTE Level, UBYTE Wait)
+{
+    ADS1263_PYRAMID_PAGE *h = (ADS1263_PYRAMID_PAGE *)p->Page[Level];
+    ADS1263_PYRAMID_BUCKET *page = (ADS1263_PYRAMID_BUCKET *)(h + 1);
+    ADS1263_PYRAMID_BUCKET *acc = p->Acc[Level];
+    uint64_t k = p->Current[Level];
+    UBYTE ret = 0;
+    UWORD c;
+
+    if(h->Count > 0 && k != h->First + h->Count)
+        ret |= Pyramid_Flush(p, Level, Wait);
+    if(h->Count == 0)
+        h->First = k;
+    for(c = 0; c < p->Columns; c++)
+        page[(size_t)c * p->Config.PageBuckets + h->Count] = acc[c];
+    if(++h->Count == p->Config.PageBuckets)
+        ret |= Pyramid_Flush(p, Level, Wait);
+    p->Stats.Buckets++;
+    p->Active[Level] = 0;
+
+    if(Level + 1 < p->Config.Levels) {
+        ADS1263_PYRAMID_BUCKET *up = p->Acc[Level + 1];
+        if(p->Active[Level + 1] && p->Current[Level + 1] != k >> 1)
+            ret |= Pyramid_Finish(p, Level + 1, Wait);
+        if(!p->Active[Level + 1])
+            Pyramid_Reset(p, Level + 1, k >> 1);
+        for(c = 0; c < p->Columns; c++) {
+            if(acc[c].Count > 0) {
+                if(acc[c].Min < up[c].Min) up[c].Min = acc[c].Min;
+                if(acc[c].Max > up[c].Max) up[c].Max = acc[c].Max;
+                up[c].Sum += acc[c].Sum;
+                up[c].Count += acc[c].Count;
+            }
+            up[c].Flags |= acc[c].Flags;
+        }
+    }
+    return ret;
+}
+
+UBYTE ADS1263_Pyramid_Append(ADS1263_PYRAMID *p, const ADS1263_FRAME *Frame)
+{
+    uint64_t k = Frame->Header.Time_ns >> p->Config.BaseLog2;
+    ADS1263_PYRAMID_BUCKET *acc;
+    UBYTE chip, slot, level, ret = 0;
+
+    if(!p->Mapped || p->Epoch != Frame->Header.Epoch)
+        Pyramid_Map(p, Frame);
+    if(p->Active[0] && p->Current[0] != k) {
+        ret = Pyramid_Finish(p, 0, 0);
+        // Coarse pages fill slowly: bound how far the file lags behind
+        if(p->Config.FlushBuckets > 0 && p->Current[0] - p->Flushed >= p->Config.FlushBuckets) {
+            for(level = 0; level < p->Config.Levels; level++)
+                ret |= Pyramid_Flush(p, level, 0);
+            ADS1263_Writer_Push(&p->Writer);
+            p->Flushed = p->Current[0];
+        }
+    }
+    if(!p->Active[0])
+        Pyramid_Reset(p, 0, k);
+
+    acc = p->Acc[0];
+    for(chip = 0; chip < Frame->Header.ChipCount; chip++) {
+        for(slot = 0; slot < Frame->Count[chip]; slot++) {
+            int c = p->Slot[chip][slot];
+            int32_t v = (int32_t)Frame->Code[chip][slot];
+            if(c < 0) {
+                p->Stats.Unmapped++;
+                continue;
+            }
+            acc[c].Flags |= Frame->Status[chip][slot];
+            if(Frame->Status[chip][slot] & SKIP_FLAGS)
+                continue;
+            if(v < acc[c].Min) acc[c].Min = v;
+            if(v > acc[c].Max) acc[c].Max = v;
+            acc[c].Sum += v;
+            acc[c].Count++;
+        }
+    }
+    return ret;
+}
+
+UBYTE ADS1263_Pyramid_Close(ADS1263_PYRAMID *p)
+{
+    UBYTE level, ret = 0;
+
+    // Partial buckets are stored too, then merged upwards level by level
+    for(level = 0; level < p->Config.Levels; level++) {
+        if(p->Active[level])
+            ret |= Pyramid_Finish(p, level, 1);
+    }
+    for(level = 0; level < p->Config.Levels; level++)
+        ret |= Pyramid_Flush(p, level, 1);
+    ret |= ADS1263_Writer_Close(&p->Writer);
+    ADS1263_Writer_GetStats(&p->Writer, &p->Stats.Disk);
+    return ret;
+}
+
+void ADS1263_Pyramid_GetStats(const ADS1263_PYRAMID *p, ADS1263_PYRAMID_STATS *Stats)
+{
+    *Stats = p->Stats;
+    if(p->Writer.Fd >= 0)
+        ADS1263_Writer_GetStats(&p->Writer, &Stats->Disk);
+}
@@ -0,0 +1,298 @@
+/*****************************************************************************
+* | File        :   ADS1263_Pyramid.h
+* | Author      :   Highz team
+* | Function    :   Min/max/mean summary pyramid
+* | Info        :
+*----------------
+* | This version:   V1.0
+* | Date        :   2026-10-19
+* | Info        :
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documnetation files (the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to  whom the Software is
+# furished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included in
+# all copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS OR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+# THE SOFTWARE.
+#
+******************************************************************************/
+#ifndef _ADS1263_PYRAMID_H_
+#define _ADS1263_PYRAMID_H_
+
+#include "ADS1263.h"
+#include "ADS1263_Map.h"
+#include "ADS1263_Writer.h"
+
+/******************************************************************************
+Summary Pyramid
+
+Next to a capture, a pyramid file keeps per-channel summaries (min, max,
+sum, count) over time buckets at power-of-two widths:
+
+    level 0 : 2^BaseLog2 ns of CLOCK_REALTIME per bucket (default ~1.07 s)
+    level j : 2^(BaseLog2 + j) ns, two level j-1 buckets merged
+
+Buckets are aligned to absolute time (bucket k of level j starts at
+k << (BaseLog2 + j)), so a viewer turns a time range and a pixel width
+into a level and a bucket range with two shifts. Levels are built
+incrementally as sweeps arrive: a finished level-0 bucket is merged into
+level 1, and so on up, which costs a few hundred operations per second.
+Samples flagged STALE, TIMEOUT or CRC carry no new reading and are not
+counted; every flag is still OR'd into the bucket.
+
+The file is append-only, written through an ADS1263_WRITER:
+
+    +----------------------------+
+    | File header (64 bytes)     |  base width, levels, columns
+    | Column[Columns]            |  "chip.channel" name and reference
+    +----------------------------+
+    | Page                       |  ADS1263_PYRAMID_PAGE header, then
+    | Page                       |  Bucket[Columns][Count], column by column
+    | ...                        |
+    +----------------------------+
+
+A page holds up to PageBuckets consecutive buckets of one level; a gap in
+the acquisition starts a new page. Opening walks the page headers once (a
+few per level and hour), after which fetching any zoom level reads only
+the buckets that are drawn. Pages are final when written, so the file is
+readable while the capture runs and after a power loss. A coarse level
+fills a page only every PageBuckets << level seconds, so every
+FlushBuckets level-0 buckets the open pages of all levels are written
+short and pushed to the disk: a reader opened during the capture sees
+every level up to its newest finished bucket, not up to its last full
+page.
+
+Columns are fixed when the file is created, from the channel map; after a
+reconfiguration channels are matched by name and new names are counted
+in ADS1263_PYRAMID_STATS.Unmapped.
+******************************************************************************/
+#define ADS1263_PYRAMID_MAGIC       0x59505A48  // "HZPY"
+#define ADS1263_PYRAMID_PAGE_MAGIC  0x47505A48  // "HZPG"
+#define ADS1263_PYRAMID_VERSION     1
+#define ADS1263_PYRAMID_MAX_LEVELS  32
+#define ADS1263_PYRAMID_NAME        (2 * ADS1263_MAP_NAME)
+
+typedef struct
+{
+    UDOUBLE  Magic;         // ADS1263_PYRAMID_MAGIC
+    UWORD    Version;
+    UWORD    Columns;
+    UBYTE    BaseLog2;      // Level 0 bucket width, log2 ns
+    UBYTE    Levels;
+    UWORD    PageBuckets;   // Most buckets per page
+    UDOUBLE  Reserved0;
+    uint64_t Created_ns;
+    UDOUBLE  Reserved[10];
+} ADS1263_PYRAMID_FILE;
+
+typedef struct
+{
+    char     Name[ADS1263_PYRAMID_NAME];    // "chip.channel"
+    double   Ref;           // Reference voltage for code to volt conversion
+    UDOUBLE  Reserved[2];
+} ADS1263_PYRAMID_COLUMN;
+
+typedef struct
+{
+    UDOUBLE  Magic;         // ADS1263_PYRAMID_PAGE_MAGIC
+    UBYTE    Level;
+    UBYTE    Reserved0;
+    UWORD    Count;         // Buckets in the page
+    uint64_t First;         // Bucket number of the first bucket
+    uint64_t Reserved;
+} ADS1263_PYRAMID_PAGE;
+
+typedef struct
+{
+    int32_t  Min;           // Codes, as stored in the frame
+    int32_t  Max;
+    int64_t  Sum;
+    UDOUBLE  Count;         // Samples; 0 = nothing converted in the bucket
+    UDOUBLE  Flags;         // OR of the sample flags
+} ADS1263_PYRAMID_BUCKET;
+
+_Static_assert(sizeof(ADS1263_PYRAMID_FILE) == 64, "pyramid file header is 64 bytes");
+_Static_assert(sizeof(ADS1263_PYRAMID_COLUMN) == 48, "pyramid column is 48 bytes");
+_Static_assert(sizeof(ADS1263_PYRAMID_PAGE) == 24, "pyramid page header is 24 bytes");
+_Static_assert(sizeof(ADS1263_PYRAMID_BUCKET) == 24, "pyramid bucket is 24 bytes");
+
+typedef struct
+{
+    ADS1263_WRITER_CONFIG Writer;
+    UBYTE    BaseLog2;      // Level 0 bucket width, log2 ns
+    UBYTE    Levels;
+    UWORD    PageBuckets;
+    UWORD    FlushBuckets;  // Write short pages this often, in level-0 buckets; 0 = full pages only
+} ADS1263_PYRAMID_CONFIG;
+
+typedef struct
+{
+    uint64_t Buckets;       // Finished, all levels
+    uint64_t Pages;         // Handed to the writer
+    uint64_t Dropped;       // Pages the writer refused
+    uint64_t Unmapped;      // Frame slots whose channel is not a column
+    ADS1263_WRITER_STATS Disk;
+} ADS1263_PYRAMID_STATS;
+
+typedef struct
+{
+    ADS1263_WRITER Writer;
+    ADS1263_PYRAMID_CONFIG Config;
+    const ADS1263_MAP *Map;
+    UWORD    Columns;
+    UDOUBLE  Epoch;                 // Epoch the slot mapping was built for
+    UBYTE    Mapped;
+    int16_t  Slot[ADS1263_MAX_CHIPS][ADS1263_FRAME_STRIDE];  // Column per frame slot, -1 = none
+    char   (*Name)[ADS1263_PYRAMID_NAME];
+    // Per level: the bucket being accumulated and the page being filled
+    uint64_t Current[ADS1263_PYRAMID_MAX_LEVELS];
+    UBYTE    Active[ADS1263_PYRAMID_MAX_LEVELS];
+    uint64_t Flushed;               // Level-0 bucket of the last short-page flush
+    ADS1263_PYRAMID_BUCKET *Acc[ADS1263_PYRAMID_MAX_LEVELS];    // [column]
+    UBYTE   *Page[ADS1263_PYRAMID_MAX_LEVELS];                  // Header + [column][PageBuckets]
+    ADS1263_PYRAMID_STATS Stats;
+} ADS1263_PYRAMID;
+
+typedef struct
+{
+    int      Fd;
+    const UBYTE *Base;
+    size_t   Size;
+    const ADS1263_PYRAMID_FILE *Header;
+    const ADS1263_PYRAMID_COLUMN *Column;
+    UDOUBLE  Count[ADS1263_PYRAMID_MAX_LEVELS];     // Pages per level
+    uint64_t *Page[ADS1263_PYRAMID_MAX_LEVELS];     // File offsets, in bucket order
+} ADS1263_PYRAMID_READER;
+
+/******************************************************************************
+function:   Default configuration
+parameter:
+    Config: Receives 2^30 ns level-0 buckets, 20 levels (up to ~12 days per
+            bucket), 128-bucket pages written at least every 16 level-0
+            buckets (~17 s), and the writer defaults
+Info:
+******************************************************************************/
+void ADS1263_Pyramid_Defaults(ADS1263_PYRAMID_CONFIG *Config);
+
+/******************************************************************************
+function:   Arena bytes a pyramid needs
+parameter:
+    Config: Pyramid configuration
+    Map: Channel map, for the number of columns
+Info:
+    Add to the Reserve given to ADS1263_Session_Open
+******************************************************************************/
+size_t ADS1263_Pyramid_Reserve(const ADS1263_PYRAMID_CONFIG *Config, const ADS1263_MAP *Map);
+
+/******************************************************************************
+function:   Create a pyramid file
+parameter:
+    Pyramid: Pyramid state, usually static
+    Session: Open session the buffers are taken from
+    Path: File to create
+    Map: Compiled channel map; one column per channel
+    Config: Pyramid configuration
+Info:
+    Returns 0 on success, 1 on failure
+******************************************************************************/
+UBYTE ADS1263_Pyramid_Open(ADS1263_PYRAMID *Pyramid, ADS1263_SESSION *Session, const char *Path,
+                           const ADS1263_MAP *Map, const ADS1263_PYRAMID_CONFIG *Config);
+
+/******************************************************************************
+function:   Add one sweep
+parameter:
+    Pyramid: Open pyramid
+    Frame: Finished frame
+Info:
+    Never blocks. Returns 0, or 1 if a finished page was dropped
+******************************************************************************/
+UBYTE ADS1263_Pyramid_Append(ADS1263_PYRAMID *Pyramid, const ADS1263_FRAME *Frame);
+
+/******************************************************************************
+function:   Finish every open bucket and page, close the file
+parameter:
+    Pyramid: Open pyramid
+Info:
+    Returns 0 if everything reached the disk
+******************************************************************************/
+UBYTE ADS1263_Pyramid_Close(ADS1263_PYRAMID *Pyramid);
+
+/******************************************************************************
+function:   Read the pyramid counters
+parameter:
+    Pyramid: Open or closed pyramid
+    Stats: Receives the counters
+Info:
+******************************************************************************/
+void ADS1263_Pyramid_GetStats(const ADS1263_PYRAMID *Pyramid, ADS1263_PYRAMID_STATS *Stats);
+
+/******************************************************************************
+function:   Map a pyramid file for reading
+parameter:
+    Reader: Reader state
+    Path: Pyramid file
+Info:
+    Reader side, in ADS1263_PyramidRead.c (no hardware layer needed)
+    Returns 0 on success, 1 if the file is not a pyramid
+******************************************************************************/
+UBYTE ADS1263_Pyramid_OpenRead(ADS1263_PYRAMID_READER *Reader, const char *Path);
+
+/******************************************************************************
+function:   Column of a named channel
+parameter:
+    Reader: Open reader
+    Name: "chip.channel", or a channel name unique across chips
+Info:
+    Returns the column, or -1
+******************************************************************************/
+int ADS1263_Pyramid_Column(const ADS1263_PYRAMID_READER *Reader, const char *Name);
+
+/******************************************************************************
+function:   Summaries of one channel over a time range
+parameter:
+    Reader: Open reader
+    Column: Column to read
+    From, To: CLOCK_REALTIME range in ns, To exclusive
+    Pixels: Most buckets wanted
+    Out: Receives up to Pixels + 1 buckets, one per bucket of the level
+    Level: Receives the level used; bucket i starts at
+           ((From >> shift) + i) << shift, shift = BaseLog2 + Level
+Info:
+    Picks the finest level with at most Pixels + 1 buckets in the range.
+    Buckets with no data have Count 0
+    Returns the number of buckets written to Out
+******************************************************************************/
+UDOUBLE ADS1263_Pyramid_Fetch(const ADS1263_PYRAMID_READER *Reader, UWORD Column, uint64_t From, uint64_t To,
+                              UDOUBLE Pixels, ADS1263_PYRAMID_BUCKET *Out, UBYTE *Level);
+
+/******************************************************************************
+function:   Time span covered by the file
+parameter:
+    Reader: Open reader
+    From, To: Receive the start of the first and the end of the last
+              level-0 bucket
+Info:
+    Returns 1 if the file holds no pages yet
+******************************************************************************/
+UBYTE ADS1263_Pyramid_Span(const ADS1263_PYRAMID_READER *Reader, uint64_t *From, uint64_t *To);
+
+/******************************************************************************
+function:   Unmap a pyramid file
+parameter:
+    Reader: Open reader
+Info:
+******************************************************************************/
+void ADS1263_Pyramid_CloseRead(ADS1263_PYRAMID_READER *Reader);
+
+#endif
@@ -0,0 +1,193 @@
+/*****************************************************************************
+* | File        :   ADS1263_PyramidRead.c
+* | Author      :   Highz team
+* | Function    :   Summary pyramid reader
+* | Info        :
+*----------------
+* | This version:   V1.0
+* | Date        :   2026-10-19
+* | Info        :
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documnetation files (the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to  whom the Software is
+# furished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included in
+# all copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS OR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+# THE SOFTWARE.
+#
+******************************************************************************/
+#define _GNU_SOURCE
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "ADS1263_Pyramid.h"
+
+static const ADS1263_PYRAMID_PAGE *Pyramid_Page(const ADS1263_PYRAMID_READER *r, UBYTE Level, UDOUBLE i)
+{
+    return (const ADS1263_PYRAMID_PAGE *)(r->Base + r->Page[Level][i]);
+}
+
+static int Pyramid_Order(const void *a, const void *b, void *Base)
+{
+    const ADS1263_PYRAMID_PAGE *x = (const ADS1263_PYRAMID_PAGE *)((const UBYTE *)Base + *(const uint64_t *)a);
+    const ADS1263_PYRAMID_PAGE *y = (const ADS1263_PYRAMID_PAGE *)((const UBYTE *)Base + *(const uint64_t *)b);
+    return x->First < y->First ? -1 : x->First > y->First;
+}
+
+UBYTE ADS1263_Pyramid_OpenRead(ADS1263_PYRAMID_READER *r, const char *Path)
+{
+    UDOUBLE room[ADS1263_PYRAMID_MAX_LEVELS] = {0};
+    struct stat st;
+    uint64_t off;
+    UBYTE level;
+
+    memset(r, 0, sizeof(*r));
+    r->Fd = open(Path, O_RDONLY);
+    if(r->Fd < 0 || fstat(r->Fd, &st) != 0 || (size_t)st.st_size < sizeof(ADS1263_PYRAMID_FILE)) {
+        printf("Pyramid: cannot read %s \r\n", Path);
+        goto fail;
+    }
+    r->Size = (size_t)st.st_size;
+    r->Base = mmap(NULL, r->Size, PROT_READ, MAP_SHARED, r->Fd, 0);
+    if(r->Base == MAP_FAILED) {
+        r->Base = NULL;
+        goto fail;
+    }
+    r->Header = (const ADS1263_PYRAMID_FILE *)r->Base;
+    off = sizeof(ADS1263_PYRAMID_FILE) + (uint64_t)r->Header->Columns * sizeof(ADS1263_PYRAMID_COLUMN);
+    if(r->Header->Magic != ADS1263_PYRAMID_MAGIC || r->Header->Levels > ADS1263_PYRAMID_MAX_LEVELS || off > r->Size) {
+        printf("Pyramid: %s is not a pyramid file \r\n", Path);
+        goto fail;
+    }
+    r->Column = (const ADS1263_PYRAMID_COLUMN *)(r->Header + 1);
+
+    // One pass over the page headers; a torn last page ends the walk
+    while(off + sizeof(ADS1263_PYRAMID_PAGE) <= r->Size) {
+        const ADS1263_PYRAMID_PAGE *h = (const ADS1263_PYRAMID_PAGE *)(r->Base + off);
+        uint64_t size = sizeof(*h) + (uint64_t)r->Header->Columns * h->Count * sizeof(ADS1263_PYRAMID_BUCKET);
+        if(h->Magic != ADS1263_PYRAMID_PAGE_MAGIC || h->Level >= r->Header->Levels || off + size > r->Size)
+            break;
+        level = h->Level;
+        if(r->Count[level] == room[level]) {
+            uint64_t *grown = realloc(r->Page[level], (room[level] = room[level] ? 2 * room[level] : 64) * sizeof(uint64_t));
+            if(grown == NULL)
+                goto fail;
+            r->Page[level] = grown;
+        }
+        r->Page[level][r->Count[level]++] = off;
+        off += size;
+    }
+    // Pages are written in time order unless the wall clock was stepped back
+    for(level = 0; level < r->Header->Levels; level++) {
+        if(r->Count[level] > 1)
+            qsort_r(r->Page[level], r->Count[level], sizeof(uint64_t), Pyramid_Order, (void *)r->Base);
+    }
+    return 0;
+fail:
+    ADS1263_Pyramid_CloseRead(r);
+    return 1;
+}
+
+int ADS1263_Pyramid_Column(const ADS1263_PYRAMID_READER *r, const char *Name)
+{
+    int c, found = -1;
+
+    for(c = 0; c < r->Header->Columns; c++) {
+        const char *dot = strchr(r->Column[c].Name, '.');
+        if(strncmp(r->Column[c].Name, Name, ADS1263_PYRAMID_NAME) == 0)
+            return c;
+        if(dot != NULL && strcmp(dot + 1, Name) == 0)
+            found = found < 0 ? c : -2;
+    }
+    return found < 0 ? -1 : found;
+}
+
+UDOUBLE ADS1263_Pyramid_Fetch(const ADS1263_PYRAMID_READER *r, UWORD Column, uint64_t From, uint64_t To,
+                              UDOUBLE Pixels, ADS1263_PYRAMID_BUCKET *Out, UBYTE *Level)
+{
+    uint64_t lo, hi, n;
+    UDOUBLE i, a, b;
+    UBYTE level = 0, shift;
+
+    if(To <= From || Column >= r->Header->Columns || r->Header->Levels == 0)
+        return 0;
+    // Finest level that fits the pixel budget
+    while(1) {
+        shift = r->Header->BaseLog2 + level;
+        n = ((To - 1) >> shift) - (From >> shift) + 1;
+        if(n <= (uint64_t)Pixels + 1 || level + 1 == r->Header->Levels)
+            break;
+        level++;
+    }
+    if(n > (uint64_t)Pixels + 1)
+        n = (uint64_t)Pixels + 1;
+    lo = From >> shift;
+    hi = lo + n - 1;
+    *Level = level;
+    for(i = 0; i < n; i++) {
+        memset(&Out[i], 0, sizeof(Out[i]));
+    }
+
+    // First page that ends after lo, then every page starting up to hi
+    a = 0;
+    b = r->Count[level];
+    while(a < b) {
+        UDOUBLE mid = a + (b - a) / 2;
+        const ADS1263_PYRAMID_PAGE *h = Pyramid_Page(r, level, mid);
+        if(h->First + h->Count <= lo)
+            a = mid + 1;
+        else
+            b = mid;
+    }
+    for(; a < r->Count[level]; a++) {
+        const ADS1263_PYRAMID_PAGE *h = Pyramid_Page(r, level, a);
+        const ADS1263_PYRAMID_BUCKET *col = (const ADS1263_PYRAMID_BUCKET *)(h + 1) + (size_t)Column * h->Count;
+        uint64_t k;
+        if(h->First > hi)
+            break;
+        for(k = h->First > lo ? h->First : lo; k < h->First + h->Count && k <= hi; k++)
+            Out[k - lo] = col[k - h->First];
+    }
+    return (UDOUBLE)n;
+}
+
+UBYTE ADS1263_Pyramid_Span(const ADS1263_PYRAMID_READER *r, uint64_t *From, uint64_t *To)
+{
+    const ADS1263_PYRAMID_PAGE *first, *last;
+
+    if(r->Header->Levels == 0 || r->Count[0] == 0)
+        return 1;
+    first = Pyramid_Page(r, 0, 0);
+    last = Pyramid_Page(r, 0, r->Count[0] - 1);
+    *From = first->First << r->Header->BaseLog2;
+    *To = (last->First + last->Count) << r->Header->BaseLog2;
+    return 0;
+}
+
+void ADS1263_Pyramid_CloseRead(ADS1263_PYRAMID_READER *r)
+{
+    UBYTE level;
+
+    for(level = 0; level < ADS1263_PYRAMID_MAX_LEVELS; level++)
+        free(r->Page[level]);
+    if(r->Base != NULL)
+        munmap((void *)r->Base, r->Size);
+    if(r->Fd >= 0)
+        close(r->Fd);
+    memset(r, 0, sizeof(*r));
+    r->Fd = -1;
+}
@@ -0,0 +1,164 @@
+/*****************************************************************************
+* | File        :   ADS1263_RT.c
+* | Author      :   Highz team
+* | Function    :   Real-time set-up of the acquisition threads
+* | Info        :
+*----------------
+* | This version:   V1.0
+* | Date        :   2026-10-19
+* | Info        :
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documnetation files (the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to  whom the Software is
+# furished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included in
+# all copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS OR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+# THE SOFTWARE.
+#
+******************************************************************************/
+#define _GNU_SOURCE
+#include <pthread.h>
+#include <sched.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include "ADS1263_RT.h"
+#include "ADS1263_Timing.h"
+
+typedef struct
+{
+    UBYTE Entered;      // Bus thread has run ADS1263_RT_EnterBus
+    int   Cpu;          // CPU pinned to, -1 = none
+    int   Priority;     // SCHED_FIFO priority obtained, 0 = normal
+} RT_BUS;
+
+static ADS1263_RT_CONFIG Config = {0, {-1, -1}, 0};
+static UBYTE Locked;
+static RT_BUS BusState[ADS1263_MAX_BUSES];
+
+UBYTE ADS1263_RT_Init(const ADS1263_RT_CONFIG *New)
+{
+    Config = *New;
+    memset(BusState, 0, sizeof(BusState));
+    if(!Config.LockMemory)
+        return 0;
+    // Present and future mappings, thread stacks included
+    if(mlockall(MCL_CURRENT | MCL_FUTURE) != 0) {
+        printf("mlockall failed (%s), memory not locked \r\n", strerror(errno));
+        return 1;
+    }
+    Locked = 1;
+    return 0;
+}
+
+void ADS1263_RT_Prefault(void *Buffer, size_t Size)
+{
+    volatile UBYTE *p = (volatile UBYTE *)Buffer;
+    size_t page = (size_t)sysconf(_SC_PAGESIZE);
+    size_t i;
+
+    for(i = 0; i < Size; i += page)
+        p[i] = p[i];
+    if(Size > 0)
+        p[Size - 1] = p[Size - 1];
+}
+
+static void RT_PrefaultStack(void)
+{
+    volatile UBYTE stack[ADS1263_RT_STACK];
+    ADS1263_RT_Prefault((void *)stack, sizeof(stack));
+}
+
+UBYTE ADS1263_RT_EnterBus(UBYTE Bus)
+{
+    RT_BUS *b = &BusState[Bus];
+    struct sched_param param;
+    UBYTE ret = 0;
+
+    if(Bus >= ADS1263_MAX_BUSES)
+        return 1;
+    b->Entered = 1;
+    b->Cpu = -1;
+    b->Priority = 0;
+    if(Config.BusCpu[Bus] >= 0) {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(Config.BusCpu[Bus], &set);
+        if(pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0) {
+            b->Cpu = Config.BusCpu[Bus];
+        } else {
+            printf("Bus %d: cannot pin to CPU %d \r\n", Bus, Config.BusCpu[Bus]);
+            ret = 1;
+        }
+    }
+    if(Config.Priority > 0) {
+        memset(&param, 0, sizeof(param));
+        param.sched_priority = Config.Priority;
+        if(pthread_setschedparam(pthread_self(), SCHED_FIFO, &param) == 0) {
+            b->Priority = Config.Priority;
+        } else {
+            printf("Bus %d: SCHED_FIFO %d refused, running at normal priority \r\n", Bus, Config.Priority);
+            ret = 1;
+        }
+    }
+    if(Config.LockMemory)
+        RT_PrefaultStack();
+    return ret;
+}
+
+UBYTE ADS1263_RT_EnterIo(void)
+{
+    struct sched_param param;
+    cpu_set_t set;
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    int cpu, b, used;
+
+    CPU_ZERO(&set);
+    for(cpu = 0; cpu < cpus && cpu < CPU_SETSIZE; cpu++) {
+        used = 0;
+        for(b = 0; b < ADS1263_MAX_BUSES; b++) {
+            if(Config.BusCpu[b] == cpu)
+                used = 1;
+        }
+        if(!used)
+            CPU_SET(cpu, &set);
+    }
+    // Nothing left over on a single core: share it
+    if(CPU_COUNT(&set) == 0)
+        return 0;
+    memset(&param, 0, sizeof(param));
+    pthread_setschedparam(pthread_self(), SCHED_OTHER, &param);
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) != 0;
+}
+
+void ADS1263_RT_Report(void)
+{
+    ADS1263_TIMING_STATS t;
+    UBYTE b;
+
+    printf("Memory %s \r\n", Locked ? "locked" : "not locked");
+    for(b = 0; b < ADS1263_MAX_BUSES; b++) {
+        if(!BusState[b].Entered)
+            continue;
+        printf("Bus %d thread: CPU %d, %s %d \r\n", b, BusState[b].Cpu,
+               BusState[b].Priority ? "SCHED_FIFO" : "SCHED_OTHER", BusState[b].Priority);
+    }
+    ADS1263_Timing_GetStats(&t);
+    printf("Wake-up latency: mean %.1f us, max %.1f us over %llu sleeps \r\n",
+           t.Sleeps ? t.WakeSum_ns * 1e-3 / t.Sleeps : 0.0, t.WakeMax_ns * 1e-3,
+           (unsigned long long)t.Sleeps);
+    printf("DRDY timeouts %llu, CRC errors %llu \r\n", (unsigned long long)t.Timeouts,
+           (unsigned long long)ADS1263_CrcErrors());
+}
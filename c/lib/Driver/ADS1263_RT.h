@@ -0,0 +1,118 @@
+/*****************************************************************************
+* | File        :   ADS1263_RT.h
+* | Author      :   Highz team
+* | Function    :   Real-time set-up of the acquisition threads
+* | Info        :
+*----------------
+* | This version:   V1.0
+* | Date        :   2026-10-19
+* | Info        :
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documnetation files (the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to  whom the Software is
+# furished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included in
+# all copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS OR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+# THE SOFTWARE.
+#
+******************************************************************************/
+#ifndef _ADS1263_RT_H_
+#define _ADS1263_RT_H_
+
+#include <stddef.h>
+#include "ADS1263.h"
+
+/******************************************************************************
+Real-Time Acquisition
+
+The bus threads of ADS1263_MultiBus are the data path: a late DRDY service
+shows up as sweep jitter. ADS1263_RT_Init sets them up once for the whole
+process:
+
+    - memory is locked (mlockall) so no page fault can stall a sweep, and
+      buffers handed to ADS1263_RT_Prefault are touched up front
+    - each bus thread pins itself to its own CPU and switches to SCHED_FIFO
+      at the configured priority when it starts (ADS1263_RT_EnterBus)
+    - logging, printing and disk threads call ADS1263_RT_EnterIo to move
+      onto the CPUs the bus threads do not use, at normal priority
+
+Pair the bus CPUs with isolcpus= on the kernel command line to keep other
+processes off them as well. Scheduling latency is measured where the data
+path sleeps: each DRDY wait that sleeps records how late it woke up
+(ADS1263_TIMING_STATS.WakeMax_ns / WakeSum_ns). The bus threads never
+print: DRDY timeouts and CRC errors are flagged on the sample and counted.
+ADS1263_RT_Report prints the set-up of every bus, the latency figures
+and those counts.
+
+SCHED_FIFO and mlockall need root or CAP_SYS_NICE / CAP_IPC_LOCK; without
+them the acquisition still runs, with a warning.
+******************************************************************************/
+#define ADS1263_RT_STACK    (256 * 1024)    // Stack prefaulted by each bus thread
+
+typedef struct
+{
+    int   Priority;                     // SCHED_FIFO priority 1-99, 0 = normal scheduling
+    int   BusCpu[ADS1263_MAX_BUSES];    // CPU of each bus thread, -1 = any
+    UBYTE LockMemory;                   // mlockall and prefault
+} ADS1263_RT_CONFIG;
+
+/******************************************************************************
+function:   Set the real-time policy of the process
+parameter:
+    Config: Policy applied by ADS1263_RT_EnterBus / ADS1263_RT_EnterIo
+Info:
+    Call before ADS1263_MultiBus_Start. Locks memory when asked to
+    Returns 0 on success, 1 if memory could not be locked (not fatal)
+******************************************************************************/
+UBYTE ADS1263_RT_Init(const ADS1263_RT_CONFIG *Config);
+
+/******************************************************************************
+function:   Touch every page of a buffer
+parameter:
+    Buffer: Start of the buffer
+    Size: Bytes
+Info:
+    Call before the data path uses it; contents are left unchanged
+******************************************************************************/
+void ADS1263_RT_Prefault(void *Buffer, size_t Size);
+
+/******************************************************************************
+function:   Make the calling thread the data path of a bus
+parameter:
+    Bus: SPI bus the thread scans
+Info:
+    Called by the ADS1263_MultiBus bus threads. Pins, raises the priority
+    and prefaults ADS1263_RT_STACK of stack
+    Returns 0 on success, 1 if part of the policy could not be applied
+******************************************************************************/
+UBYTE ADS1263_RT_EnterBus(UBYTE Bus);
+
+/******************************************************************************
+function:   Keep the calling thread off the data path
+parameter:
+Info:
+    Moves the thread to every online CPU not given to a bus thread, at
+    normal priority. For consumers, loggers and writers
+    Returns 0 on success, 1 on failure
+******************************************************************************/
+UBYTE ADS1263_RT_EnterIo(void);
+
+/******************************************************************************
+function:   Print the real-time set-up and scheduling latency
+parameter:
+Info:
+******************************************************************************/
+void ADS1263_RT_Report(void);
+
+#endif
@@ -0,0 +1,116 @@
+/*****************************************************************************
+* | File        :   ADS1263_Reconfig.c
+* | Author      :   Highz team
+* | Function    :   Runtime reconfiguration of a running scan
+* | Info        :
+*----------------
+* | This version:   V1.0
+* | Date        :   2026-10-19
+* | Info        :
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documnetation files (the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to  whom the Software is
+# furished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included in
+# all copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS OR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+# THE SOFTWARE.
+#
+******************************************************************************/
+#include <string.h>
+#include "ADS1263_Reconfig.h"
+#include "ADS1263_Calib.h"
+
+/* copy a new entry table; an entry that keeps its slot and input keeps its
+   history: the value repeated while it sits out, and the count
+   ADS1263_Sched_Update reads */
+static void Reconfig_Entries(ADS1263_SCAN_ENTRY *Entry, UBYTE Count, const ADS1263_SCAN_ENTRY *New, UBYTE NewCount)
+{
+    UBYTE i;
+
+    for(i = 0; i < ADS1263_FRAME_STRIDE; i++) {
+        ADS1263_SCAN_ENTRY old = Entry[i];
+        Entry[i] = New[i];
+        if(i < Count && i < NewCount && old.Input == New[i].Input && old.INPMUX == New[i].INPMUX) {
+            Entry[i].Last = old.Last;
+            Entry[i].LastFlags = old.LastFlags;
+            Entry[i].Samples = old.Samples;
+        }
+    }
+}
+
+UBYTE ADS1263_Reconfig_Chip(ADS1263_SCAN *Scan, UBYTE Chip, const ADS1263_SCAN_CHIP *New)
+{
+    ADS1263_SCAN_CHIP *sc = &Scan->Chip[Chip];
+    UBYTE regs[2 + ADS1263_CALIB_BYTES];    // MODE2, INPMUX, OFCAL0-FSCAL2
+    UBYTE count = 1;
+
+    if(New->Bus != sc->Bus || New->CS != sc->CS)
+        return 1;
+
+    regs[0] = 0x80 | (ADS1263_GAIN_1 << 4) | (New->Rate & 0x0f);
+    if(regs[0] != sc->CurMODE2) {
+        DEV_SPI_SelectBus(sc->Bus);
+        ADS1263_WriteCmd(CMD_STOP1, sc->CS);
+        // Coefficients depend on the rate; restore the new rate's set if known
+        if(ADS1263_Calib_Get(sc->Bus, sc->CS, New->Rate, &regs[2]) == 0) {
+            regs[1] = New->Count > 0 ? New->Entry[0].INPMUX : 0x01;
+            count = sizeof(regs);
+        }
+        ADS1263_WriteRegs(REG_MODE2, regs, count, sc->CS);
+        sc->CurMODE2 = regs[0];
+    }
+
+    // The register shadows describe the chip, not the table: keep them
+    sc->DRDY = New->DRDY;
+    sc->Rate = New->Rate;
+    Reconfig_Entries(sc->Entry, sc->Count, New->Entry, New->Count);
+    sc->Count = New->Count;
+    // ADC2 is set up again on the next visit
+    Reconfig_Entries(sc->Aux, sc->AuxCount, New->Aux, New->AuxCount);
+    sc->AuxCount = New->AuxCount;
+    sc->AuxNext = 0;
+    sc->AuxRun = 0;
+    sc->ADC2CFG = New->ADC2CFG;
+    return 0;
+}
+
+UBYTE ADS1263_Reconfig_Check(const ADS1263_SCAN *Scan, const ADS1263_SCAN *New)
+{
+    UBYTE c;
+
+    if(New->ChipCount != Scan->ChipCount)
+        return 1;
+    for(c = 0; c < Scan->ChipCount; c++) {
+        if(New->Chip[c].Bus != Scan->Chip[c].Bus || New->Chip[c].CS != Scan->Chip[c].CS)
+            return 1;
+    }
+    return 0;
+}
+
+UBYTE ADS1263_Reconfig_Scan(ADS1263_SCAN *Scan, const ADS1263_SCAN *New)
+{
+    UBYTE Bus = DEV_HARDWARE_SPI_CurrentBus();
+    UBYTE c;
+
+    if(ADS1263_Reconfig_Check(Scan, New) != 0) {
+        printf("Reconfigure: chip set differs, not applied \r\n");
+        return 1;
+    }
+    for(c = 0; c < Scan->ChipCount; c++) {
+        ADS1263_Reconfig_Chip(Scan, c, &New->Chip[c]);
+    }
+    Scan->Epoch++;
+    DEV_SPI_SelectBus(Bus);
+    return 0;
+}
@@ -0,0 +1,92 @@
+/*****************************************************************************
+* | File        :   ADS1263_Reconfig.h
+* | Author      :   Highz team
+* | Function    :   Runtime reconfiguration of a running scan
+* | Info        :
+*----------------
+* | This version:   V1.0
+* | Date        :   2026-10-19
+* | Info        :
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documnetation files (the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to  whom the Software is
+# furished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included in
+# all copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS OR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+# THE SOFTWARE.
+#
+******************************************************************************/
+#ifndef _ADS1263_RECONFIG_H_
+#define _ADS1263_RECONFIG_H_
+
+#include "ADS1263.h"
+
+/******************************************************************************
+Runtime Reconfiguration
+
+A new configuration is a complete scan table (usually from
+ADS1263_Map_Compile) for the same chips: data rates, channel lists, settle
+delays and filters may all change, the chips themselves may not. It is
+swapped in between two sweeps, never in the middle of one:
+
+    ADS1263_Reconfig_Scan       single-threaded, call between ADS1263_Scan
+    ADS1263_MultiBus_Reconfigure  staged, every bus switches at the same
+                                  sweep sequence number
+
+Only registers whose value changes are written. MODE0/MODE1 are already
+written on demand by the scan; here MODE2 is written when the data rate
+changes, together with the stored OFCAL/FSCAL of the new rate in the same
+burst (MODE2, INPMUX and OFCAL0-FSCAL2 are contiguous). A change costs a
+few SPI bytes per chip instead of an ADS1263_init_ADC1 per chip.
+
+Each applied configuration increments ADS1263_SCAN.Epoch, which is copied
+into Header.Epoch of every frame, so consumers can tell which sweeps were
+taken under which settings.
+******************************************************************************/
+
+/******************************************************************************
+function:   Apply a new scan table entry to one chip
+parameter:
+    Scan: Table being scanned
+    Chip: Chip index
+    New: New table entry for the same chip
+Info:
+    Call from the thread that scans the chip's bus, between sweeps.
+    Does not touch the epoch
+    Returns 0 on success, 1 if New is for another chip
+******************************************************************************/
+UBYTE ADS1263_Reconfig_Chip(ADS1263_SCAN *Scan, UBYTE Chip, const ADS1263_SCAN_CHIP *New);
+
+/******************************************************************************
+function:   Check that a new scan table covers the same chips
+parameter:
+    Scan: Table being scanned
+    New: Proposed table
+Info:
+    Returns 0 if the chip count, buses and CS pins all match, 1 otherwise
+******************************************************************************/
+UBYTE ADS1263_Reconfig_Check(const ADS1263_SCAN *Scan, const ADS1263_SCAN *New);
+
+/******************************************************************************
+function:   Apply a new scan table to every chip
+parameter:
+    Scan: Table being scanned
+    New: New table for the same chips
+Info:
+    For single-threaded acquisition with ADS1263_Scan; call between sweeps
+    Returns 0 on success (Epoch is incremented), 1 if the chips differ
+******************************************************************************/
+UBYTE ADS1263_Reconfig_Scan(ADS1263_SCAN *Scan, const ADS1263_SCAN *New);
+
+#endif
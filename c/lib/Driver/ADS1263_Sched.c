@@ -0,0 +1,231 @@
+/*****************************************************************************
+* | File        :   ADS1263_Sched.c
+* | Author      :   Highz team
+* | Function    :   Multi-rate channel scheduling
+* | Info        :
+*----------------
+* | This version:   V1.0
+* | Date        :   2026-10-19
+* | Info        :
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documnetation files (the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to  whom the Software is
+# furished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included in
+# all copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS OR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+# THE SOFTWARE.
+#
+******************************************************************************/
+#include <string.h>
+#include <time.h>
+#include "ADS1263_Sched.h"
+#include "ADS1263_Timing.h"
+
+double ADS1263_Sched_EntryTime(const ADS1263_SCAN_ENTRY *Entry)
+{
+    return ADS1263_Timing_Model(Entry->MODE0, Entry->MODE1, Entry->MODE2) * 1e-9
+         + ADS1263_SCHED_OVERHEAD;
+}
+
+/* average sweep time of the slowest bus with the current dividers, as modelled */
+static double Sched_SweepTime(const ADS1263_SCAN *Scan)
+{
+    double bus[ADS1263_MAX_BUSES] = {0}, worst = 0;
+    UBYTE c, i;
+
+    for(c = 0; c < Scan->ChipCount; c++) {
+        const ADS1263_SCAN_CHIP *sc = &Scan->Chip[c];
+        for(i = 0; i < sc->Count; i++)
+            bus[sc->Bus] += ADS1263_Sched_EntryTime(&sc->Entry[i]) / sc->Entry[i].Divider;
+    }
+    for(c = 0; c < ADS1263_MAX_BUSES; c++) {
+        if(bus[c] > worst)
+            worst = bus[c];
+    }
+    return worst;
+}
+
+static UBYTE Sched_Divider(float Target, double SweepHz)
+{
+    UBYTE k = 1;
+    if(Target <= 0)
+        return 1;
+    while(k < ADS1263_SCHED_MAX_DIVIDER && SweepHz / (2 * k) >= Target)
+        k *= 2;
+    return k;
+}
+
+/* spread the phases of one bus so every sweep of the pattern costs the same */
+static void Sched_Phases(ADS1263_SCAN *Scan, UBYTE Bus)
+{
+    double load[ADS1263_SCHED_MAX_DIVIDER] = {0};
+    UBYTE c, i, k, p, j, best;
+
+    // Largest dividers last: they have the most phases to choose from
+    for(k = 1; k != 0 && k <= ADS1263_SCHED_MAX_DIVIDER; k *= 2) {
+        for(c = 0; c < Scan->ChipCount; c++) {
+            ADS1263_SCAN_CHIP *sc = &Scan->Chip[c];
+            if(sc->Bus != Bus)
+                continue;
+            for(i = 0; i < sc->Count; i++) {
+                ADS1263_SCAN_ENTRY *e = &sc->Entry[i];
+                double t = ADS1263_Sched_EntryTime(e);
+                double worst = -1;
+                if(e->Divider != k)
+                    continue;
+                best = 0;
+                for(p = 0; p < k; p++) {
+                    double m = 0;
+                    for(j = (k - p) % k; j < ADS1263_SCHED_MAX_DIVIDER; j += k) {
+                        if(load[j] > m)
+                            m = load[j];
+                    }
+                    if(worst < 0 || m < worst) {
+                        worst = m;
+                        best = p;
+                    }
+                }
+                e->Phase = best;
+                // Converted in sweeps s with (s + Phase) % k == 0
+                for(j = (k - best) % k; j < ADS1263_SCHED_MAX_DIVIDER; j += k)
+                    load[j] += t;
+            }
+        }
+    }
+}
+
+/* dividers and phases for a sweep Slow times as long as the model says */
+static double Sched_Assign(ADS1263_SCAN *Scan, double Slow)
+{
+    double hz = 0;
+    UBYTE c, i, b, pass, changed;
+
+    for(c = 0; c < Scan->ChipCount; c++) {
+        for(i = 0; i < Scan->Chip[c].Count; i++) {
+            Scan->Chip[c].Entry[i].Divider = 1;
+            Scan->Chip[c].Entry[i].Phase = 0;
+        }
+    }
+
+    for(pass = 0; pass < 8; pass++) {
+        double t = Sched_SweepTime(Scan) * Slow;
+        hz = t > 0 ? 1.0 / t : 0;
+        changed = 0;
+        for(c = 0; c < Scan->ChipCount; c++) {
+            for(i = 0; i < Scan->Chip[c].Count; i++) {
+                ADS1263_SCAN_ENTRY *e = &Scan->Chip[c].Entry[i];
+                UBYTE k = Sched_Divider(e->Target, hz);
+                if(k != e->Divider) {
+                    e->Divider = k;
+                    changed = 1;
+                }
+            }
+        }
+        if(!changed)
+            break;
+    }
+
+    for(b = 0; b < ADS1263_MAX_BUSES; b++)
+        Sched_Phases(Scan, b);
+    return hz;
+}
+
+double ADS1263_Sched_Build(ADS1263_SCAN *Scan)
+{
+    return Sched_Assign(Scan, 1.0);
+}
+
+UBYTE ADS1263_Sched_Starved(const ADS1263_SCAN *Scan, const ADS1263_SCHED_STATS *Stats)
+{
+    UBYTE c, i, n = 0;
+
+    if(Stats->SweepHz <= 0)
+        return 0;
+    for(c = 0; c < Scan->ChipCount; c++) {
+        for(i = 0; i < Scan->Chip[c].Count; i++) {
+            float target = Scan->Chip[c].Entry[i].Target;
+            if(target > 0 && Stats->Hz[c][i] < target * ADS1263_SCHED_STARVED)
+                n++;
+        }
+    }
+    return n;
+}
+
+UBYTE ADS1263_Sched_Retune(ADS1263_SCAN *Scan, const ADS1263_SCHED_STATS *Stats)
+{
+    UBYTE divider[ADS1263_MAX_CHIPS][ADS1263_FRAME_STRIDE], phase[ADS1263_MAX_CHIPS][ADS1263_FRAME_STRIDE];
+    double model = Sched_SweepTime(Scan);
+    UBYTE c, i, changed = 0;
+
+    if(model <= 0 || ADS1263_Sched_Starved(Scan, Stats) == 0)
+        return 0;
+    for(c = 0; c < Scan->ChipCount; c++) {
+        for(i = 0; i < Scan->Chip[c].Count; i++) {
+            divider[c][i] = Scan->Chip[c].Entry[i].Divider;
+            phase[c][i] = Scan->Chip[c].Entry[i].Phase;
+        }
+    }
+    // The model is off by the same factor whatever the dividers
+    Sched_Assign(Scan, 1.0 / (Stats->SweepHz * model));
+    for(c = 0; c < Scan->ChipCount; c++) {
+        for(i = 0; i < Scan->Chip[c].Count; i++) {
+            if(Scan->Chip[c].Entry[i].Divider != divider[c][i] || Scan->Chip[c].Entry[i].Phase != phase[c][i])
+                changed = 1;
+        }
+    }
+    return changed;
+}
+
+/* samples per second from two counts; a count that went back was reset */
+static float Sched_Rate(UDOUBLE Now, UDOUBLE Before, double dt)
+{
+    if(dt <= 0 || Now < Before)
+        return 0;
+    return (Now - Before) / dt;
+}
+
+void ADS1263_Sched_Update(const ADS1263_SCAN *Scan, ADS1263_SCHED_STATS *Stats)
+{
+    uint64_t now = ADS1263_Clock_ns(CLOCK_MONOTONIC);
+    UDOUBLE epoch = __atomic_load_n(&Scan->Epoch, __ATOMIC_ACQUIRE);
+    double dt = Stats->Time_ns ? (now - Stats->Time_ns) * 1e-9 : 0;
+    double hz = 0, share = 0;
+    UBYTE c, i;
+
+    // The epoch moves when the last bus takes a new table, before its chips
+    // are switched: rebase now and once more an interval later
+    if(epoch != Stats->Epoch || Stats->Settle) {
+        Stats->Settle = epoch != Stats->Epoch && Stats->Time_ns != 0;
+        Stats->Epoch = epoch;
+        dt = 0;
+    }
+    for(c = 0; c < Scan->ChipCount; c++) {
+        for(i = 0; i < Scan->Chip[c].Count; i++) {
+            UDOUBLE n = __atomic_load_n(&Scan->Chip[c].Entry[i].Samples, __ATOMIC_RELAXED);
+            Stats->Hz[c][i] = Sched_Rate(n, Stats->Samples[c][i], dt);
+            Stats->Samples[c][i] = n;
+            // An entry with divider k is converted in 1/k of the sweeps
+            hz += Stats->Hz[c][i];
+            share += 1.0 / Scan->Chip[c].Entry[i].Divider;
+        }
+        for(i = 0; i < Scan->Chip[c].AuxCount; i++) {
+            UBYTE slot = Scan->Chip[c].Count + i;
+            UDOUBLE n = __atomic_load_n(&Scan->Chip[c].Aux[i].Samples, __ATOMIC_RELAXED);
+            Stats->Hz[c][slot] = Sched_Rate(n, Stats->Samples[c][slot], dt);
+            Stats->Samples[c][slot] = n;
+        }
+    }
+    Stats->SweepHz = share > 0 ? (float)(hz / share) : 0;
+    Stats->Time_ns = now;
+}
@@ -0,0 +1,135 @@
+/*****************************************************************************
+* | File        :   ADS1263_Sched.h
+* | Author      :   Highz team
+* | Function    :   Multi-rate channel scheduling
+* | Info        :
+*----------------
+* | This version:   V1.0
+* | Date        :   2026-10-19
+* | Info        :
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documnetation files (the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to  whom the Software is
+# furished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included in
+# all copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS OR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+# THE SOFTWARE.
+#
+******************************************************************************/
+#ifndef _ADS1263_SCHED_H_
+#define _ADS1263_SCHED_H_
+
+#include "ADS1263.h"
+
+/******************************************************************************
+Multi-Rate Scheduling
+
+Not every channel needs a sample every sweep: the supply monitor changes
+over seconds, the log detectors over microseconds. Each scan entry carries
+a target rate (map option hz=, 0 = every sweep). ADS1263_Sched_Build turns
+the targets into a repeating pattern:
+
+    - the sweep time is estimated from each entry's conversion time
+      (ADS1263_Timing_Model plus SPI overhead), per bus,
+      the slowest bus setting the pace
+    - an entry with a target gets the largest power-of-two divider that
+      still meets it, so the pattern repeats every max(divider) sweeps
+    - a shorter sweep raises the sweep rate, which can raise the dividers
+      again; this is iterated until it settles
+    - phases are spread so the sweeps of the pattern are equally long
+
+Every slot time freed this way goes to the entries without a target (the
+detectors): they are converted every sweep, and sweeps get shorter. Slots
+that sit out a sweep repeat their last value flagged ADS1263_SAMPLE_STALE.
+
+The targets are only met if the timing model is right: the dividers come
+from the estimated sweep rate, and a sweep slower than estimated starves
+the entries with a target. ADS1263_Sched_Update measures the rate each
+entry actually achieved and the sweep rate behind it. ADS1263_Sched_Retune
+feeds that back: when an entry gets less than ADS1263_SCHED_STARVED of its
+target, the dividers are rebuilt for the measured sweep rate, to be staged
+like any reconfiguration (ADS1263_MultiBus_Reconfigure). An entry that
+stays under its target at divider 1 cannot be helped; ADS1263_Sched_Starved
+tells the caller so it can warn.
+******************************************************************************/
+#define ADS1263_SCHED_MAX_DIVIDER   128
+#define ADS1263_SCHED_OVERHEAD      60e-6   // SPI/GPIO cost of one conversion, s
+#define ADS1263_SCHED_STARVED       0.75f   // Achieved share of the target that is too little
+
+typedef struct
+{
+    uint64_t Time_ns;                   // When the counts below were taken
+    UDOUBLE  Epoch;                     // Scan epoch the counts belong to
+    UBYTE    Settle;                    // Epoch just changed, rebase once more
+    float    SweepHz;                   // Achieved sweeps per second, 0 after a rebase
+    UDOUBLE  Samples[ADS1263_MAX_CHIPS][ADS1263_FRAME_STRIDE];
+    float    Hz[ADS1263_MAX_CHIPS][ADS1263_FRAME_STRIDE];   // Achieved rate per slot
+} ADS1263_SCHED_STATS;
+
+/******************************************************************************
+function:   Assign dividers and phases from the entries' targets
+parameter:
+    Scan: Compiled scan table
+Info:
+    Called by ADS1263_Map_Compile. Returns the estimated sweeps per second
+******************************************************************************/
+double ADS1263_Sched_Build(ADS1263_SCAN *Scan);
+
+/******************************************************************************
+function:   Estimated time of one conversion
+parameter:
+    Entry: Scan entry
+Info:
+    Seconds from START1 to data read, used to balance the pattern
+******************************************************************************/
+double ADS1263_Sched_EntryTime(const ADS1263_SCAN_ENTRY *Entry);
+
+/******************************************************************************
+function:   Measure the achieved rate of every entry
+parameter:
+    Scan: Table being scanned
+    Stats: Previous measurement (zeroed before the first call), updated
+Info:
+    Stats->Hz gets the samples per second since the previous call.
+    Safe to call from the consumer while the bus threads run. The interval
+    in which the scan epoch changes, and the one after it while the buses
+    switch over, report 0 Hz: slots may have changed meaning
+******************************************************************************/
+void ADS1263_Sched_Update(const ADS1263_SCAN *Scan, ADS1263_SCHED_STATS *Stats);
+
+/******************************************************************************
+function:   Count the entries short of their target
+parameter:
+    Scan: Table the rates were measured on
+    Stats: Last ADS1263_Sched_Update
+Info:
+    Entries with a target that got less than ADS1263_SCHED_STARVED of it.
+    0 while Stats holds no measurement
+******************************************************************************/
+UBYTE ADS1263_Sched_Starved(const ADS1263_SCAN *Scan, const ADS1263_SCHED_STATS *Stats);
+
+/******************************************************************************
+function:   Rebuild the dividers from the achieved sweep rate
+parameter:
+    Scan: Private copy of the table being scanned, changed in place
+    Stats: Last ADS1263_Sched_Update of the table being scanned
+Info:
+    Does nothing unless an entry is starved (ADS1263_Sched_Starved). Then
+    the modelled sweep time is scaled to the measured one and dividers and
+    phases are assigned again. Returns 1 if Scan changed and should be
+    staged, 0 if not
+******************************************************************************/
+UBYTE ADS1263_Sched_Retune(ADS1263_SCAN *Scan, const ADS1263_SCHED_STATS *Stats);
+
+#endif
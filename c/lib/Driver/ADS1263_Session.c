@@ -0,0 +1,139 @@
+/*****************************************************************************
+* | File        :   ADS1263_Session.c
+* | Author      :   Highz team
+* | Function    :   Acquisition session with arena-backed buffers
+* | Info        :
+*----------------
+* | This version:   V1.0
+* | Date        :   2026-10-19
+* | Info        :
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documnetation files (the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to  whom the Software is
+# furished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included in
+# all copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS OR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+# THE SOFTWARE.
+#
+******************************************************************************/
+#include <string.h>
+#include "ADS1263_Session.h"
+#include "ADS1263_RT.h"
+
+#ifdef ADS1263_ALLOC_CHECK
+/******************************************************************************
+Allocation counter: replaces the glibc allocator entry points and forwards
+to the real ones, so allocations made inside libc are counted as well
+******************************************************************************/
+extern void *__libc_malloc(size_t Size);
+extern void *__libc_calloc(size_t Count, size_t Size);
+extern void *__libc_realloc(void *Ptr, size_t Size);
+extern void __libc_free(void *Ptr);
+
+static uint64_t Allocations;
+
+void *malloc(size_t Size)
+{
+    __atomic_fetch_add(&Allocations, 1, __ATOMIC_RELAXED);
+    return __libc_malloc(Size);
+}
+
+void *calloc(size_t Count, size_t Size)
+{
+    __atomic_fetch_add(&Allocations, 1, __ATOMIC_RELAXED);
+    return __libc_calloc(Count, Size);
+}
+
+void *realloc(void *Ptr, size_t Size)
+{
+    __atomic_fetch_add(&Allocations, 1, __ATOMIC_RELAXED);
+    return __libc_realloc(Ptr, Size);
+}
+
+void free(void *Ptr)
+{
+    __libc_free(Ptr);
+}
+
+static uint64_t Session_Allocations(void)
+{
+    return __atomic_load_n(&Allocations, __ATOMIC_RELAXED);
+}
+#else
+static uint64_t Session_Allocations(void)
+{
+    return 0;
+}
+#endif
+
+UBYTE ADS1263_Session_Open(ADS1263_SESSION *Session, size_t Reserve, UBYTE Huge)
+{
+    size_t size = 0;
+
+    memset(Session, 0, sizeof(*Session));
+    size += sizeof(ADS1263_SCAN) + ADS1263_ARENA_ALIGN;
+    size += sizeof(ADS1263_MULTIBUS) + ADS1263_ARENA_ALIGN;
+    size += sizeof(ADS1263_SCHED_STATS) + ADS1263_ARENA_ALIGN;
+    size += Reserve;
+    if(ADS1263_Arena_Init(&Session->Arena, size, Huge) != 0)
+        return 1;
+
+    Session->Scan = ADS1263_Arena_Alloc(&Session->Arena, sizeof(ADS1263_SCAN));
+    Session->MultiBus = ADS1263_Arena_Alloc(&Session->Arena, sizeof(ADS1263_MULTIBUS));
+    Session->Rates = ADS1263_Arena_Alloc(&Session->Arena, sizeof(ADS1263_SCHED_STATS));
+    printf("Session arena: %zu bytes%s \r\n", Session->Arena.Size, Session->Arena.Huge ? " in huge pages" : "");
+    return 0;
+}
+
+void *ADS1263_Session_Alloc(ADS1263_SESSION *Session, size_t Size)
+{
+    return ADS1263_Arena_Alloc(&Session->Arena, Size);
+}
+
+UBYTE ADS1263_Session_Start(ADS1263_SESSION *Session)
+{
+    ADS1263_RT_Prefault(Session->Arena.Base, Session->Arena.Size);
+    if(ADS1263_MultiBus_Start(Session->MultiBus, Session->Scan) != 0)
+        return 1;
+    Session->Running = 1;
+    // Thread creation allocates; count from here on
+    ADS1263_Session_Mark(Session);
+    return 0;
+}
+
+void ADS1263_Session_Mark(ADS1263_SESSION *Session)
+{
+    Session->Allocs = Session_Allocations();
+}
+
+uint64_t ADS1263_Session_Check(const ADS1263_SESSION *Session)
+{
+    (void)Session;
+#ifdef ADS1263_ALLOC_CHECK
+    uint64_t n = Session_Allocations() - Session->Allocs;
+    printf("Heap allocations since session start: %llu \r\n", (unsigned long long)n);
+    return n;
+#else
+    printf("Heap allocations not counted (build with -DADS1263_ALLOC_CHECK) \r\n");
+    return 0;
+#endif
+}
+
+void ADS1263_Session_Close(ADS1263_SESSION *Session)
+{
+    if(Session->Running)
+        ADS1263_MultiBus_Stop(Session->MultiBus);
+    ADS1263_Arena_Free(&Session->Arena);
+    memset(Session, 0, sizeof(*Session));
+}
@@ -0,0 +1,127 @@
+/*****************************************************************************
+* | File        :   ADS1263_Session.h
+* | Author      :   Highz team
+* | Function    :   Acquisition session with arena-backed buffers
+* | Info        :
+*----------------
+* | This version:   V1.0
+* | Date        :   2026-10-19
+* | Info        :
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documnetation files (the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to  whom the Software is
+# furished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included in
+# all copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS OR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+# THE SOFTWARE.
+#
+******************************************************************************/
+#ifndef _ADS1263_SESSION_H_
+#define _ADS1263_SESSION_H_
+
+#include "ADS1263.h"
+#include "ADS1263_Arena.h"
+#include "ADS1263_MultiBus.h"
+#include "ADS1263_Sched.h"
+
+/******************************************************************************
+Acquisition Session
+
+A session owns every buffer the acquisition touches: the scan table, the
+MultiBus frame ring, the rate statistics and whatever later stages (disk
+writer, publisher, summaries) reserve with ADS1263_Session_Alloc. All of
+it comes from one arena mapped at ADS1263_Session_Open, optionally in huge
+pages, and is prefaulted at ADS1263_Session_Start. Once started, the
+steady-state loop (Acquire, convert, Release) makes no heap allocation.
+
+ADS1263_Session_Check verifies that. Build with -DADS1263_ALLOC_CHECK
+(make RPI CFLAGS="-g -O0 -Wall -DADS1263_ALLOC_CHECK") to count every
+malloc/calloc/realloc of the process, libc's own included; the check then
+reports the allocations made since the session started. "make alloccheck"
+does this without hardware: tools/alloccheck.c runs the whole consumer
+path against the simulated bus in lib/Config/DEV_Stub.c and fails on any
+allocation.
+******************************************************************************/
+typedef struct
+{
+    ADS1263_ARENA Arena;
+    ADS1263_SCAN *Scan;             // Compile the map into this
+    ADS1263_MULTIBUS *MultiBus;     // Frame ring and bus threads
+    ADS1263_SCHED_STATS *Rates;     // For ADS1263_Sched_Update
+    UBYTE    Running;
+    uint64_t Allocs;                // Heap allocations counted at start
+} ADS1263_SESSION;
+
+/******************************************************************************
+function:   Map the arena and lay out the session buffers
+parameter:
+    Session: Session to open
+    Reserve: Extra bytes for ADS1263_Session_Alloc
+    Huge: Back the arena with 2 MB huge pages when available
+Info:
+    Returns 0 on success, 1 on failure
+******************************************************************************/
+UBYTE ADS1263_Session_Open(ADS1263_SESSION *Session, size_t Reserve, UBYTE Huge);
+
+/******************************************************************************
+function:   Take a buffer from the session arena
+parameter:
+    Session: Open session
+    Size: Bytes
+Info:
+    For later pipeline stages; call before ADS1263_Session_Start so the
+    buffer is prefaulted. Returns a zeroed block, or NULL when the reserve
+    given to ADS1263_Session_Open is used up
+******************************************************************************/
+void *ADS1263_Session_Alloc(ADS1263_SESSION *Session, size_t Size);
+
+/******************************************************************************
+function:   Prefault the arena and start the bus threads
+parameter:
+    Session: Open session whose Scan has been compiled
+Info:
+    Returns 0 on success, 1 on failure
+******************************************************************************/
+UBYTE ADS1263_Session_Start(ADS1263_SESSION *Session);
+
+/******************************************************************************
+function:   Count heap allocations from now on
+parameter:
+    Session: Started session
+Info:
+    For callers that stop and restart the bus threads with
+    ADS1263_MultiBus_Start: thread creation allocates
+******************************************************************************/
+void ADS1263_Session_Mark(ADS1263_SESSION *Session);
+
+/******************************************************************************
+function:   Report heap allocations made since the session started
+parameter:
+    Session: Started session
+Info:
+    Returns the number of allocations since ADS1263_Session_Start or the
+    last ADS1263_Session_Mark, 0 when none were made or when the process
+    was built without ADS1263_ALLOC_CHECK
+******************************************************************************/
+uint64_t ADS1263_Session_Check(const ADS1263_SESSION *Session);
+
+/******************************************************************************
+function:   Stop the bus threads and unmap the arena
+parameter:
+    Session: Session to close
+Info:
+******************************************************************************/
+void ADS1263_Session_Close(ADS1263_SESSION *Session);
+
+#endif
@@ -0,0 +1,355 @@
+/*****************************************************************************
+* | File        :   ADS1263_Shm.c
+* | Author      :   Highz team
+* | Function    :   Shared-memory sweep publisher
+* | Info        :
+*----------------
+* | This version:   V1.0
+* | Date        :   2026-10-19
+* | Info        :
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documnetation files (the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to  whom the Software is
+# furished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included in
+# all copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS OR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+# THE SOFTWARE.
+#
+******************************************************************************/
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+#include "ADS1263_Shm.h"
+
+#define SLOT_SIZE   ((sizeof(ADS1263_SHM_SLOT) + ADS1263_FRAME_ALIGN - 1) / ADS1263_FRAME_ALIGN * ADS1263_FRAME_ALIGN)
+
+_Static_assert(sizeof(ADS1263_SHM_HEADER) <= ADS1263_SHM_HEADER_SIZE, "ring header must fit its page");
+
+static ADS1263_SHM_SLOT *Shm_Slot(const ADS1263_SHM *s, uint64_t n)
+{
+    return (ADS1263_SHM_SLOT *)(s->Slot + (size_t)(n % s->Header->Slots) * s->Header->SlotSize);
+}
+
+/* lock the ring under Name, if there is one; 1 if its producer still runs */
+static UBYTE Shm_Claim(const char *Name, int *Fd)
+{
+    ADS1263_SHM_HEADER h;
+
+    *Fd = shm_open(Name, O_RDWR, 0);
+    if(*Fd < 0)
+        return 0;
+    // The producer holds a lock on the object; it goes away with the process
+    if(flock(*Fd, LOCK_EX | LOCK_NB) != 0) {
+        if(pread(*Fd, &h, sizeof(h), 0) != (ssize_t)sizeof(h))
+            h.Pid = 0;
+        printf("Shm: %s is in use by process %lu \r\n", Name, (unsigned long)h.Pid);
+        close(*Fd);
+        *Fd = -1;
+        return 1;
+    }
+    return 0;
+}
+
+/* a fresh object under Name; the caller holds the lock of the old one */
+static UBYTE Shm_New(ADS1263_SHM *s, const char *Name, UDOUBLE Slots)
+{
+    ADS1263_SHM_HEADER *h;
+    struct timespec now;
+
+    memset(s, 0, sizeof(*s));
+    s->Fd = -1;
+    if(Slots == 0)
+        Slots = ADS1263_SHM_SLOTS;
+    snprintf(s->Name, sizeof(s->Name), "%s", Name);
+    s->Size = ADS1263_SHM_HEADER_SIZE + (size_t)Slots * SLOT_SIZE;
+
+    // A fresh object each run: readers of the old one see it closed
+    shm_unlink(Name);
+    s->Fd = shm_open(Name, O_RDWR | O_CREAT | O_EXCL, 0644);
+    if(s->Fd < 0 || ftruncate(s->Fd, (off_t)s->Size) != 0 || flock(s->Fd, LOCK_EX | LOCK_NB) != 0) {
+        printf("Shm: cannot create %s (%s) \r\n", Name, strerror(errno));
+        ADS1263_Shm_Close(s);
+        return 1;
+    }
+    s->Base = mmap(NULL, s->Size, PROT_READ | PROT_WRITE, MAP_SHARED, s->Fd, 0);
+    if(s->Base == MAP_FAILED) {
+        s->Base = NULL;
+        ADS1263_Shm_Close(s);
+        return 1;
+    }
+    // Touch every page now so no sweep takes a page fault
+    memset(s->Base, 0, s->Size);
+    h = s->Header = (ADS1263_SHM_HEADER *)s->Base;
+    s->Slot = s->Base + ADS1263_SHM_HEADER_SIZE;
+    h->Version = ADS1263_SHM_VERSION;
+    h->Slots = Slots;
+    h->SlotSize = SLOT_SIZE;
+    h->FrameSize = sizeof(ADS1263_FRAME);
+    h->Pid = (UDOUBLE)getpid();
+    clock_gettime(CLOCK_REALTIME, &now);
+    h->Created_ns = (uint64_t)now.tv_sec * 1000000000ull + (uint64_t)now.tv_nsec;
+    __atomic_store_n(&h->Magic, ADS1263_SHM_MAGIC, __ATOMIC_RELEASE);
+    printf("Shm: %s, %lu x %lu byte slots \r\n", Name, (unsigned long)Slots, (unsigned long)SLOT_SIZE);
+    return 0;
+}
+
+UBYTE ADS1263_Shm_Create(ADS1263_SHM *s, const char *Name, UDOUBLE Slots)
+{
+    UBYTE ret;
+    int old;
+
+    memset(s, 0, sizeof(*s));
+    s->Fd = -1;
+    if(Shm_Claim(Name, &old) != 0)
+        return 1;
+    ret = Shm_New(s, Name, Slots);
+    if(old >= 0)
+        close(old);
+    return ret;
+}
+
+UBYTE ADS1263_Shm_Resume(ADS1263_SHM *s, const char *Name, UDOUBLE Slots)
+{
+    ADS1263_SHM_HEADER *h;
+    struct stat st;
+    size_t i;
+    UBYTE ret;
+    int old;
+
+    memset(s, 0, sizeof(*s));
+    s->Fd = -1;
+    if(Slots == 0)
+        Slots = ADS1263_SHM_SLOTS;
+    snprintf(s->Name, sizeof(s->Name), "%s", Name);
+    s->Size = ADS1263_SHM_HEADER_SIZE + (size_t)Slots * SLOT_SIZE;
+    // Locked before anything else: a ring still in use is never replaced
+    if(Shm_Claim(Name, &s->Fd) != 0)
+        return 1;
+    if(s->Fd < 0 || fstat(s->Fd, &st) != 0 || (size_t)st.st_size != s->Size)
+        goto create;
+    s->Base = mmap(NULL, s->Size, PROT_READ | PROT_WRITE, MAP_SHARED, s->Fd, 0);
+    if(s->Base == MAP_FAILED) {
+        s->Base = NULL;
+        goto create;
+    }
+    h = s->Header = (ADS1263_SHM_HEADER *)s->Base;
+    s->Slot = s->Base + ADS1263_SHM_HEADER_SIZE;
+    if(h->Magic != ADS1263_SHM_MAGIC || h->Version != ADS1263_SHM_VERSION || h->Slots != Slots ||
+       h->SlotSize != SLOT_SIZE || h->FrameSize != sizeof(ADS1263_FRAME))
+        goto create;
+    // Fault every page in now, without changing what the ring holds
+    for(i = 0; i < s->Size; i += ADS1263_SHM_HEADER_SIZE)
+        __atomic_fetch_add(&s->Base[i], 0, __ATOMIC_RELAXED);
+    s->Next = h->Head;
+    if(h->Saved > h->Head)
+        h->Saved = h->Head;
+    h->Pid = (UDOUBLE)getpid();
+    h->Restarts++;
+    __atomic_store_n(&h->Closed, 0, __ATOMIC_RELEASE);
+    printf("Shm: resumed %s at sweep %llu, %llu not stored \r\n", Name, (unsigned long long)h->Head,
+           (unsigned long long)(h->Head - h->Saved));
+    return 0;
+
+create:
+    // Keep the old object locked until the new one is in place
+    old = s->Fd;
+    s->Fd = -1;
+    ADS1263_Shm_Detach(s);
+    ret = Shm_New(s, Name, Slots);
+    if(old >= 0)
+        close(old);
+    return ret;
+}
+
+void ADS1263_Shm_Publish(ADS1263_SHM *s, const ADS1263_FRAME *Frame)
+{
+    ADS1263_SHM_SLOT *slot = Shm_Slot(s, s->Next);
+
+    __atomic_store_n(&slot->Seq, 2 * s->Next + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    memcpy(&slot->Frame, Frame, sizeof(*Frame));
+    __atomic_store_n(&slot->Seq, 2 * s->Next + 2, __ATOMIC_RELEASE);
+    __atomic_store_n(&s->Header->Head, ++s->Next, __ATOMIC_RELEASE);
+    __atomic_fetch_add(&s->Header->Notify, 1, __ATOMIC_RELEASE);
+    syscall(SYS_futex, &s->Header->Notify, FUTEX_WAKE, INT_MAX, NULL, NULL, 0);
+}
+
+void ADS1263_Shm_Commit(ADS1263_SHM *s, uint64_t Sweep)
+{
+    __atomic_store_n(&s->Header->Saved, Sweep, __ATOMIC_RELEASE);
+}
+
+uint64_t ADS1263_Shm_Unsaved(ADS1263_SHM *Reader, const ADS1263_SHM *Ring)
+{
+    uint64_t saved = __atomic_load_n(&Ring->Header->Saved, __ATOMIC_ACQUIRE);
+
+    if(saved >= Ring->Next || ADS1263_Shm_Attach(Reader, Ring->Name) != 0)
+        return 0;
+    Reader->Next = saved;
+    return Ring->Next - saved;
+}
+
+void ADS1263_Shm_Close(ADS1263_SHM *s)
+{
+    if(s->Header != NULL) {
+        __atomic_store_n(&s->Header->Closed, 1, __ATOMIC_RELEASE);
+        __atomic_fetch_add(&s->Header->Notify, 1, __ATOMIC_RELEASE);
+        syscall(SYS_futex, &s->Header->Notify, FUTEX_WAKE, INT_MAX, NULL, NULL, 0);
+    }
+    ADS1263_Shm_Detach(s);
+}
+
+UBYTE ADS1263_Shm_Attach(ADS1263_SHM *s, const char *Name)
+{
+    const ADS1263_SHM_HEADER *h;
+    struct stat st;
+
+    memset(s, 0, sizeof(*s));
+    snprintf(s->Name, sizeof(s->Name), "%s", Name);
+    s->Fd = shm_open(Name, O_RDONLY, 0);
+    if(s->Fd < 0 || fstat(s->Fd, &st) != 0 || (size_t)st.st_size < ADS1263_SHM_HEADER_SIZE) {
+        ADS1263_Shm_Detach(s);
+        return 1;
+    }
+    s->Size = (size_t)st.st_size;
+    s->Base = mmap(NULL, s->Size, PROT_READ, MAP_SHARED, s->Fd, 0);
+    if(s->Base == MAP_FAILED) {
+        s->Base = NULL;
+        ADS1263_Shm_Detach(s);
+        return 1;
+    }
+    h = s->Header = (ADS1263_SHM_HEADER *)s->Base;
+    s->Slot = s->Base + ADS1263_SHM_HEADER_SIZE;
+    if(__atomic_load_n(&h->Magic, __ATOMIC_ACQUIRE) != ADS1263_SHM_MAGIC || h->Version != ADS1263_SHM_VERSION ||
+       h->FrameSize != sizeof(ADS1263_FRAME) || h->SlotSize < sizeof(ADS1263_SHM_SLOT) || h->Slots == 0 ||
+       ADS1263_SHM_HEADER_SIZE + (size_t)h->Slots * h->SlotSize > s->Size) {
+        printf("Shm: %s is not a compatible ring \r\n", Name);
+        ADS1263_Shm_Detach(s);
+        return 1;
+    }
+    s->Next = __atomic_load_n(&h->Head, __ATOMIC_ACQUIRE);
+    return 0;
+}
+
+/* position the reader on a published sweep, skipping what was overwritten */
+static ADS1263_SHM_STATUS Shm_Next(ADS1263_SHM *s, ADS1263_SHM_SLOT **Slot)
+{
+    uint64_t head = __atomic_load_n(&s->Header->Head, __ATOMIC_ACQUIRE);
+
+    if(head == s->Next)
+        return __atomic_load_n(&s->Header->Closed, __ATOMIC_ACQUIRE) ? ADS1263_SHM_CLOSED : ADS1263_SHM_EMPTY;
+    if(head - s->Next >= s->Header->Slots) {
+        // The oldest slot is the next to be overwritten: resume just past it
+        s->Missed += head - s->Header->Slots + 1 - s->Next;
+        s->Next = head - s->Header->Slots + 1;
+        return ADS1263_SHM_OVERRUN;
+    }
+    *Slot = Shm_Slot(s, s->Next);
+    s->Seen = __atomic_load_n(&(*Slot)->Seq, __ATOMIC_ACQUIRE);
+    if(s->Seen != 2 * s->Next + 2) {
+        s->Missed++;
+        s->Next++;
+        return ADS1263_SHM_OVERRUN;
+    }
+    return ADS1263_SHM_OK;
+}
+
+/* the slot still holds the sweep it held at Shm_Next */
+static ADS1263_SHM_STATUS Shm_Check(ADS1263_SHM *s, const ADS1263_SHM_SLOT *Slot)
+{
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    s->Next++;
+    if(__atomic_load_n(&Slot->Seq, __ATOMIC_RELAXED) != s->Seen) {
+        s->Missed++;
+        return ADS1263_SHM_OVERRUN;
+    }
+    s->Read++;
+    return ADS1263_SHM_OK;
+}
+
+ADS1263_SHM_STATUS ADS1263_Shm_Read(ADS1263_SHM *s, ADS1263_FRAME *Frame)
+{
+    ADS1263_SHM_SLOT *slot;
+    ADS1263_SHM_STATUS ret = Shm_Next(s, &slot);
+
+    if(ret != ADS1263_SHM_OK)
+        return ret;
+    memcpy(Frame, &slot->Frame, sizeof(*Frame));
+    return Shm_Check(s, slot);
+}
+
+ADS1263_SHM_STATUS ADS1263_Shm_Peek(ADS1263_SHM *s, const ADS1263_FRAME **Frame)
+{
+    ADS1263_SHM_SLOT *slot;
+    ADS1263_SHM_STATUS ret = Shm_Next(s, &slot);
+
+    if(ret == ADS1263_SHM_OK)
+        *Frame = &slot->Frame;
+    return ret;
+}
+
+ADS1263_SHM_STATUS ADS1263_Shm_Done(ADS1263_SHM *s)
+{
+    return Shm_Check(s, Shm_Slot(s, s->Next));
+}
+
+UBYTE ADS1263_Shm_Wait(ADS1263_SHM *s, UDOUBLE Timeout_ms)
+{
+    struct timespec end, now, left;
+    UDOUBLE notify;
+
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    end.tv_sec += Timeout_ms / 1000;
+    end.tv_nsec += (long)(Timeout_ms % 1000) * 1000000L;
+    if(end.tv_nsec >= 1000000000L) {
+        end.tv_sec++;
+        end.tv_nsec -= 1000000000L;
+    }
+    while(1) {
+        // Read the futex word first so a sweep published in between is not slept through
+        notify = __atomic_load_n(&s->Header->Notify, __ATOMIC_ACQUIRE);
+        if(__atomic_load_n(&s->Header->Head, __ATOMIC_ACQUIRE) != s->Next ||
+           __atomic_load_n(&s->Header->Closed, __ATOMIC_ACQUIRE))
+            return 0;
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        left.tv_sec = end.tv_sec - now.tv_sec;
+        left.tv_nsec = end.tv_nsec - now.tv_nsec;
+        if(left.tv_nsec < 0) {
+            left.tv_sec--;
+            left.tv_nsec += 1000000000L;
+        }
+        if(left.tv_sec < 0)
+            return 1;
+        syscall(SYS_futex, &s->Header->Notify, FUTEX_WAIT, notify, &left, NULL, 0);
+    }
+}
+
+void ADS1263_Shm_Detach(ADS1263_SHM *s)
+{
+    if(s->Base != NULL)
+        munmap(s->Base, s->Size);
+    if(s->Fd >= 0)
+        close(s->Fd);
+    s->Base = NULL;
+    s->Header = NULL;
+    s->Fd = -1;
+}
@@ -0,0 +1,260 @@
+/*****************************************************************************
+* | File        :   ADS1263_Shm.h
+* | Author      :   Highz team
+* | Function    :   Shared-memory sweep publisher
+* | Info        :
+*----------------
+* | This version:   V1.0
+* | Date        :   2026-10-19
+* | Info        :
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documnetation files (the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to  whom the Software is
+# furished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included in
+# all copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS OR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+# THE SOFTWARE.
+#
+******************************************************************************/
+#ifndef _ADS1263_SHM_H_
+#define _ADS1263_SHM_H_
+
+#include "ADS1263.h"
+
+/******************************************************************************
+Shared-Memory Publisher
+
+The acquisition process publishes every sweep into a POSIX shared-memory
+ring; plotters, loggers and monitors in other processes attach read-only
+and follow it at their own pace:
+
+    +----------------------------+  offset 0
+    | Header (one page)          |  magic, geometry, Head, Notify
+    +----------------------------+
+    | Slot 0: Seq | Frame        |  slot n % Slots holds sweep n
+    | Slot 1: Seq | Frame        |
+    | ...                        |
+    +----------------------------+
+
+The producer never waits for a reader. Publishing sweep n sets the slot's
+Seq to 2n + 1, copies the frame, sets Seq to 2n + 2 and then Head to n + 1.
+A reader expects Seq == 2n + 2 before and after it reads a slot (a seqlock).
+If the value is anything else, the slot was overwritten under the reader.
+In that case, or when Head has moved more than Slots past the reader, the
+read reports ADS1263_SHM_OVERRUN. The reader skips ahead and counts what it
+missed in Missed.
+
+The ring also carries the producer across a restart. ADS1263_Shm_Resume
+re-attaches to the ring a crashed or stopped producer left behind,
+keeping its sweeps and Head, so sweep numbers carry on where they
+stopped. The producer records in Saved how far one output has stored the
+sweeps (ADS1263_Shm_Commit); after a restart, the sweeps from Saved to
+Head that are still in the ring can be stored again (ADS1263_Shm_Unsaved).
+Nothing is lost from that output as long as the ring holds more sweeps
+than it keeps in memory. Other outputs are ahead of Saved or behind it,
+so replaying into them would duplicate or still miss sweeps.
+
+Readers can copy a frame out (ADS1263_Shm_Read) or use it in place
+(ADS1263_Shm_Peek, then ADS1263_Shm_Done to learn whether it stayed
+intact). Waiting for the next sweep is a futex wait on Header.Notify, which
+the producer bumps and wakes after every sweep: one system call that never
+blocks it.
+******************************************************************************/
+#define ADS1263_SHM_MAGIC       0x48535A48  // "HZSH"
+#define ADS1263_SHM_VERSION     2
+#define ADS1263_SHM_NAME        "/hz_sweeps"
+#define ADS1263_SHM_HEADER_SIZE 4096        // Header page, slots start after it
+#define ADS1263_SHM_SLOTS       256         // ~1 MB, a few seconds of sweeps
+
+typedef enum
+{
+    ADS1263_SHM_OK = 0,         // A frame was read
+    ADS1263_SHM_EMPTY,          // Nothing new yet
+    ADS1263_SHM_OVERRUN,        // The reader fell behind; skipped ahead, see Missed
+    ADS1263_SHM_CLOSED,         // The producer closed the ring and everything was read
+}ADS1263_SHM_STATUS;
+
+typedef struct
+{
+    UDOUBLE  Magic;         // ADS1263_SHM_MAGIC
+    UWORD    Version;
+    UWORD    Closed;        // Set by ADS1263_Shm_Close
+    UDOUBLE  Slots;
+    UDOUBLE  SlotSize;      // Bytes per slot, Seq line plus frame
+    UDOUBLE  FrameSize;     // sizeof(ADS1263_FRAME) of the producer
+    UDOUBLE  Pid;           // Producer process
+    uint64_t Created_ns;    // CLOCK_REALTIME when the ring was created
+    UDOUBLE  Restarts;      // Producers that resumed the ring
+    UDOUBLE  Reserved[7];
+    // Written on every sweep, on a line of their own
+    uint64_t Head __attribute__((aligned(64)));     // Sweeps published
+    UDOUBLE  Notify;        // Futex word, bumped after every sweep
+    uint64_t Saved __attribute__((aligned(64)));    // Sweeps before this one are stored
+} ADS1263_SHM_HEADER;
+
+typedef struct
+{
+    uint64_t Seq __attribute__((aligned(64)));      // 2n + 1 while sweep n is written, 2n + 2 after
+    ADS1263_FRAME Frame;
+} ADS1263_SHM_SLOT;
+
+typedef struct
+{
+    int      Fd;
+    UBYTE   *Base;
+    size_t   Size;
+    char     Name[64];
+    ADS1263_SHM_HEADER *Header;
+    UBYTE   *Slot;
+    uint64_t Next;          // Producer: next sweep number; reader: next to read
+    uint64_t Read;          // Reader: frames returned
+    uint64_t Missed;        // Reader: frames skipped by overruns
+    uint64_t Seen;          // Reader: slot Seq at ADS1263_Shm_Peek
+} ADS1263_SHM;
+
+/******************************************************************************
+function:   Create the ring and become its producer
+parameter:
+    Shm: Ring state
+    Name: Shared-memory object, e.g. ADS1263_SHM_NAME
+    Slots: Frames in the ring, 0 = ADS1263_SHM_SLOTS
+Info:
+    Replaces a ring left by an earlier run; fails while another producer
+    still holds the ring. The whole ring is touched here, so publishing
+    never faults. Returns 0 on success, 1 on failure
+******************************************************************************/
+UBYTE ADS1263_Shm_Create(ADS1263_SHM *Shm, const char *Name, UDOUBLE Slots);
+
+/******************************************************************************
+function:   Take over the ring an earlier producer left, or create one
+parameter:
+    Shm: Ring state
+    Name: Shared-memory object, e.g. ADS1263_SHM_NAME
+    Slots: Frames in the ring, 0 = ADS1263_SHM_SLOTS
+Info:
+    A ring of the same geometry is kept with its sweeps, Head and Saved;
+    Shm->Next continues at Head. Anything else is replaced as by
+    ADS1263_Shm_Create. Fails while the earlier producer is still running,
+    whatever the geometry of its ring.
+    Returns 0 on success, 1 on failure
+******************************************************************************/
+UBYTE ADS1263_Shm_Resume(ADS1263_SHM *Shm, const char *Name, UDOUBLE Slots);
+
+/******************************************************************************
+function:   Publish one sweep
+parameter:
+    Shm: Ring created by ADS1263_Shm_Create
+    Frame: Finished frame
+Info:
+    One frame copy and one futex wake; never waits for readers
+******************************************************************************/
+void ADS1263_Shm_Publish(ADS1263_SHM *Shm, const ADS1263_FRAME *Frame);
+
+/******************************************************************************
+function:   Record how far the sweeps are stored
+parameter:
+    Shm: Ring of the producer
+    Sweep: Every sweep before this one is stored by the producer's outputs
+Info:
+    One store; call after every sweep, and with Shm->Next once the outputs
+    are closed
+******************************************************************************/
+void ADS1263_Shm_Commit(ADS1263_SHM *Shm, uint64_t Sweep);
+
+/******************************************************************************
+function:   Read back the sweeps an earlier producer had not stored
+parameter:
+    Reader: Reader state
+    Ring: Ring just taken over with ADS1263_Shm_Resume
+Info:
+    Attaches Reader at Header->Saved; ADS1263_Shm_Read then returns the
+    sweeps up to Head, ADS1263_SHM_OVERRUN for those already overwritten
+    (counted in Missed) and ADS1263_SHM_EMPTY at the end. Call before
+    publishing. Returns the number of sweeps to read back, 0 if none
+******************************************************************************/
+uint64_t ADS1263_Shm_Unsaved(ADS1263_SHM *Reader, const ADS1263_SHM *Ring);
+
+/******************************************************************************
+function:   Mark the ring closed and unmap it
+parameter:
+    Shm: Ring created by ADS1263_Shm_Create
+Info:
+    Readers drain what is left and then see ADS1263_SHM_CLOSED; the
+    object stays until the next ADS1263_Shm_Create
+******************************************************************************/
+void ADS1263_Shm_Close(ADS1263_SHM *Shm);
+
+/******************************************************************************
+function:   Attach to a ring as a reader
+parameter:
+    Shm: Reader state
+    Name: Shared-memory object
+Info:
+    Maps the ring read-only and starts at the newest sweep; set Shm->Next
+    to Shm->Header->Head - Slots + 1 to start from the oldest instead.
+    Returns 0 on success, 1 if there is no compatible ring
+******************************************************************************/
+UBYTE ADS1263_Shm_Attach(ADS1263_SHM *Shm, const char *Name);
+
+/******************************************************************************
+function:   Copy out the next sweep
+parameter:
+    Shm: Attached reader
+    Frame: Receives the sweep on ADS1263_SHM_OK
+Info:
+    Returns an ADS1263_SHM_STATUS
+******************************************************************************/
+ADS1263_SHM_STATUS ADS1263_Shm_Read(ADS1263_SHM *Shm, ADS1263_FRAME *Frame);
+
+/******************************************************************************
+function:   Use the next sweep in place
+parameter:
+    Shm: Attached reader
+    Frame: Receives a pointer into the ring on ADS1263_SHM_OK
+Info:
+    The producer may overwrite the frame while it is used; call
+    ADS1263_Shm_Done before trusting what was read from it
+******************************************************************************/
+ADS1263_SHM_STATUS ADS1263_Shm_Peek(ADS1263_SHM *Shm, const ADS1263_FRAME **Frame);
+
+/******************************************************************************
+function:   Finish with a frame from ADS1263_Shm_Peek
+parameter:
+    Shm: Attached reader
+Info:
+    Returns ADS1263_SHM_OK if the frame stayed intact, ADS1263_SHM_OVERRUN
+    if it was overwritten (counted in Missed). Moves on to the next sweep
+******************************************************************************/
+ADS1263_SHM_STATUS ADS1263_Shm_Done(ADS1263_SHM *Shm);
+
+/******************************************************************************
+function:   Wait for the next sweep
+parameter:
+    Shm: Attached reader
+    Timeout_ms: Longest wait
+Info:
+    Returns 0 when there is something to read (or the ring closed), 1 on
+    timeout
+******************************************************************************/
+UBYTE ADS1263_Shm_Wait(ADS1263_SHM *Shm, UDOUBLE Timeout_ms);
+
+/******************************************************************************
+function:   Detach a reader
+parameter:
+    Shm: Attached reader
+Info:
+******************************************************************************/
+void ADS1263_Shm_Detach(ADS1263_SHM *Shm);
+
+#endif
@@ -0,0 +1,252 @@
+/*****************************************************************************
+* | File        :   ADS1263_Startup.c
+* | Author      :   Highz team
+* | Function    :   Parallel chip bring-up with a persisted configuration hash
+* | Info        :
+*----------------
+* | This version:   V1.0
+* | Date        :   2026-10-19
+* | Info        :
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documnetation files (the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to  whom the Software is
+# furished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included in
+# all copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS OR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+# THE SOFTWARE.
+#
+******************************************************************************/
+#include <pthread.h>
+#include <stdio.h>
+#include <string.h>
+#include "ADS1263_Startup.h"
+
+#define POWER_VALUE     0x01    // INTREF on, RESET flag cleared
+#define INTERFACE_VALUE 0x05    // Status byte + checksum, as read by ADS1263_Read_ADC1_Data
+#define REFMUX_VALUE    0x24    // VDD/VSS reference
+
+typedef struct
+{
+    UBYTE Bus;
+    UWORD CS;
+    UDOUBLE Hash;
+} STARTUP_RECORD;
+
+typedef struct
+{
+    ADS1263_STARTUP *Chip;
+    UBYTE Number;
+    UBYTE Bus;
+    const STARTUP_RECORD *Record;
+    int RecordCount;
+} STARTUP_BUS;
+
+UDOUBLE ADS1263_ConfigHash(const UBYTE *Regs)
+{
+    UDOUBLE hash = 2166136261u;
+    UBYTE i;
+
+    for(i = 0; i < ADS1263_REG_COUNT; i++) {
+        // Rewritten by every scan, or live input levels
+        if(i == REG_MODE0 || i == REG_MODE1 || i == REG_MODE2 || i == REG_INPMUX ||
+           i == REG_GPIODAT || i == REG_ADC2CFG || i == REG_ADC2MUX)
+            continue;
+        hash = (hash ^ Regs[i]) * 16777619u;
+    }
+    return hash;
+}
+
+/* reference, interface and calibration the bring-up owns; not the rate (Startup_Rate) */
+static UBYTE Startup_Matches(const ADS1263_STARTUP *Chip, const UBYTE *Regs)
+{
+    if(Chip->HaveCalib && memcmp(&Regs[REG_OFCAL0], Chip->Calib, sizeof(Chip->Calib)) != 0)
+        return 0;
+    return Regs[REG_POWER] == POWER_VALUE &&
+           Regs[REG_INTERFACE] == INTERFACE_VALUE &&
+           Regs[REG_REFMUX] == REFMUX_VALUE;
+}
+
+/* MODE0-MODE2 of the requested delay, filter and rate */
+static void Startup_Mode(const ADS1263_STARTUP *Chip, UBYTE *Mode)
+{
+    Mode[0] = Chip->Delay;                              // MODE0
+    Mode[1] = Chip->Filter;                             // MODE1
+    Mode[2] = 0x80 | (ADS1263_GAIN_1 << 4) | Chip->Rate; // MODE2, PGA bypassed
+}
+
+/* a reused chip still gets the requested rate: MODE0-MODE2 are not hashed */
+static UBYTE Startup_Rate(const ADS1263_STARTUP *Chip, UBYTE *Regs)
+{
+    UBYTE mode[3];
+
+    Startup_Mode(Chip, mode);
+    if(memcmp(&Regs[REG_MODE0], mode, sizeof(mode)) != 0) {
+        ADS1263_WriteCmd(CMD_STOP1, Chip->CS);
+        ADS1263_WriteRegs(REG_MODE0, mode, sizeof(mode), Chip->CS);
+        ADS1263_ReadRegs(REG_MODE0, &Regs[REG_MODE0], sizeof(mode), Chip->CS);
+    }
+    return memcmp(&Regs[REG_MODE0], mode, sizeof(mode)) == 0;
+}
+
+static UBYTE Startup_Configure(const ADS1263_STARTUP *Chip, UBYTE *Regs)
+{
+    UBYTE mode[4 + sizeof(Chip->Calib)];
+
+    Startup_Mode(Chip, mode);
+    mode[3] = 0x01;                                     // INPMUX reset value
+    memcpy(&mode[4], Chip->Calib, sizeof(Chip->Calib)); // OFCAL0-FSCAL2 follow
+
+    ADS1263_WriteCmd(CMD_STOP1, Chip->CS);
+    ADS1263_WriteRegs(REG_POWER, (const UBYTE[]){POWER_VALUE, INTERFACE_VALUE}, 2, Chip->CS);
+    ADS1263_WriteRegs(REG_MODE0, mode, Chip->HaveCalib ? sizeof(mode) : 3, Chip->CS);
+    ADS1263_WriteRegs(REG_REFMUX, (const UBYTE[]){REFMUX_VALUE}, 1, Chip->CS);
+
+    ADS1263_ReadRegs(REG_ID, Regs, ADS1263_REG_COUNT, Chip->CS);
+    return Startup_Matches(Chip, Regs) && memcmp(&Regs[REG_MODE0], mode, 3) == 0;
+}
+
+static void *Startup_Bus(void *Arg)
+{
+    STARTUP_BUS *b = (STARTUP_BUS *)Arg;
+    UBYTE regs[ADS1263_REG_COUNT];
+    UBYTE c;
+    int r;
+
+    DEV_SPI_SelectBus(b->Bus);
+    for(c = 0; c < b->Number; c++) {
+        ADS1263_STARTUP *chip = &b->Chip[c];
+        if(chip->Bus != b->Bus)
+            continue;
+
+        ADS1263_ReadRegs(REG_ID, regs, ADS1263_REG_COUNT, chip->CS);
+        if((regs[REG_ID] >> 5) != 1) {
+            printf("Bus %d CS %d: ID read failed (0x%02x) \r\n", chip->Bus, chip->CS, regs[REG_ID]);
+            chip->Error = 1;
+            continue;
+        }
+        chip->Hash = ADS1263_ConfigHash(regs);
+        for(r = 0; r < b->RecordCount; r++) {
+            if(b->Record[r].Bus == chip->Bus && b->Record[r].CS == chip->CS)
+                break;
+        }
+        if(r < b->RecordCount && b->Record[r].Hash == chip->Hash && Startup_Matches(chip, regs) &&
+           Startup_Rate(chip, regs)) {
+            chip->Reused = 1;
+            continue;
+        }
+
+        if(!Startup_Configure(chip, regs)) {
+            printf("Bus %d CS %d: configuration unsuccess \r\n", chip->Bus, chip->CS);
+            chip->Error = 1;
+            continue;
+        }
+        chip->Hash = ADS1263_ConfigHash(regs);
+    }
+    return NULL;
+}
+
+static int Startup_Load(const char *HashFile, STARTUP_RECORD *Record, int Max)
+{
+    unsigned int bus, cs;
+    unsigned long hash;
+    int n = 0;
+    FILE *fp;
+
+    if(HashFile == NULL || (fp = fopen(HashFile, "r")) == NULL)
+        return 0;
+    while(n < Max && fscanf(fp, "%u %u %lx", &bus, &cs, &hash) == 3) {
+        Record[n].Bus = bus;
+        Record[n].CS = cs;
+        Record[n].Hash = hash;
+        n++;
+    }
+    fclose(fp);
+    return n;
+}
+
+static void Startup_Save(const char *HashFile, const ADS1263_STARTUP *Chip, UBYTE Number)
+{
+    char tmp[256];
+    FILE *fp;
+    UBYTE c;
+
+    // Write aside and rename, so a crash never leaves a half-written file
+    snprintf(tmp, sizeof(tmp), "%s.tmp", HashFile);
+    if((fp = fopen(tmp, "w")) == NULL) {
+        printf("Write %s failed \r\n", tmp);
+        return;
+    }
+    for(c = 0; c < Number; c++) {
+        if(!Chip[c].Error)
+            fprintf(fp, "%d %d %08x\n", Chip[c].Bus, Chip[c].CS, (unsigned int)Chip[c].Hash);
+    }
+    if(fclose(fp) != 0 || rename(tmp, HashFile) != 0)
+        printf("Write %s failed \r\n", HashFile);
+}
+
+UBYTE ADS1263_Startup(ADS1263_STARTUP *Chip, UBYTE Number, const char *HashFile)
+{
+    STARTUP_RECORD record[ADS1263_MAX_CHIPS];
+    STARTUP_BUS bus[ADS1263_MAX_BUSES];
+    pthread_t thread[ADS1263_MAX_BUSES];
+    UBYTE started[ADS1263_MAX_BUSES] = {0};
+    UBYTE used = 0, reused = 0, ret = 0;
+    UBYTE Bus = DEV_HARDWARE_SPI_CurrentBus();
+    int count, b;
+    UBYTE c;
+
+    count = Startup_Load(HashFile, record, ADS1263_MAX_CHIPS);
+    for(c = 0; c < Number; c++) {
+        Chip[c].Reused = 0;
+        Chip[c].Error = Chip[c].Bus >= ADS1263_MAX_BUSES;
+        if(!Chip[c].Error)
+            used |= 1 << Chip[c].Bus;
+    }
+
+    for(b = 0; b < ADS1263_MAX_BUSES; b++) {
+        bus[b].Chip = Chip;
+        bus[b].Number = Number;
+        bus[b].Bus = b;
+        bus[b].Record = record;
+        bus[b].RecordCount = count;
+    }
+    // A thread for every bus but the last, which runs here
+    for(b = 0; b < ADS1263_MAX_BUSES; b++) {
+        if(!(used & (1 << b)) || (used >> (b + 1)) == 0)
+            continue;
+        started[b] = (pthread_create(&thread[b], NULL, Startup_Bus, &bus[b]) == 0);
+        if(!started[b])
+            Startup_Bus(&bus[b]);
+    }
+    for(b = ADS1263_MAX_BUSES - 1; b >= 0; b--) {
+        if(used & (1 << b)) {
+            Startup_Bus(&bus[b]);
+            break;
+        }
+    }
+    for(b = 0; b < ADS1263_MAX_BUSES; b++) {
+        if(started[b])
+            pthread_join(thread[b], NULL);
+    }
+    DEV_SPI_SelectBus(Bus);
+
+    for(c = 0; c < Number; c++) {
+        ret |= Chip[c].Error;
+        reused += Chip[c].Reused;
+    }
+    printf("Startup: %d chips, %d kept their configuration \r\n", Number, reused);
+    if(HashFile != NULL)
+        Startup_Save(HashFile, Chip, Number);
+    return ret;
+}
@@ -0,0 +1,96 @@
+/*****************************************************************************
+* | File        :   ADS1263_Startup.h
+* | Author      :   Highz team
+* | Function    :   Parallel chip bring-up with a persisted configuration hash
+* | Info        :
+*----------------
+* | This version:   V1.0
+* | Date        :   2026-10-19
+* | Info        :
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documnetation files (the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to  whom the Software is
+# furished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included in
+# all copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS OR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+# THE SOFTWARE.
+#
+******************************************************************************/
+#ifndef _ADS1263_STARTUP_H_
+#define _ADS1263_STARTUP_H_
+
+#include "ADS1263.h"
+
+/******************************************************************************
+Fast Startup
+
+ADS1263_init_ADC1 configures one chip at a time with a 5 ms pause and a
+read-back after every register. ADS1263_Startup brings a whole stack up at
+once instead:
+
+    1. One RREG burst dumps all 27 registers of a chip
+    2. If the dump hashes to the value saved by the previous run and holds
+       the requested reference, interface and calibration settings, the
+       chip is kept. Only MODE0-MODE2 are written, with one burst and a
+       read-back, when they differ from the requested delay, filter and rate
+    3. Otherwise STOP1, one WREG burst for MODE0-MODE2 (through FSCAL2 when
+       stored calibration coefficients are given) plus POWER, INTERFACE
+       and REFMUX, then one dump to verify. No sleeps: register writes
+       take effect at the end of the SPI frame
+    4. The new hashes are written back to the hash file
+
+Each SPI bus is handled by its own thread. POWER is written with the RESET
+flag cleared, so a chip that was power cycled or reset since the last run
+never matches its old hash and is always reconfigured. Registers the scan
+rewrites on its own (MODE0-MODE2, INPMUX, ADC2CFG, ADC2MUX) and the GPIO input
+levels are left out of the hash.
+
+Hash file, one line per chip: <bus> <cs> <hash in hex>
+******************************************************************************/
+typedef struct
+{
+    UBYTE Bus;              // SPI bus
+    UWORD CS;               // Chip select pin
+    ADS1263_DRATE Rate;     // Requested settings
+    ADS1263_DELAY Delay;
+    ADS1263_FILTER Filter;
+    UBYTE HaveCalib;        // Calib holds OFCAL0-2/FSCAL0-2 to restore
+    UBYTE Calib[6];
+    UBYTE Reused;           // Set when the chip kept its previous configuration
+    UBYTE Error;            // Set when the chip could not be configured
+    UDOUBLE Hash;           // Configuration hash after bring-up
+} ADS1263_STARTUP;
+
+/******************************************************************************
+function:   Configure a set of chips in parallel
+parameter:
+    Chip: Chips to bring up; Reused, Error and Hash are filled in
+    Number: Number of chips
+    HashFile: File holding the hashes of the previous run, NULL = never reuse
+Info:
+    GPIO/SPI must already be set up (DEV_Module_Init on each bus)
+    Returns 0 when every chip is configured, 1 otherwise
+******************************************************************************/
+UBYTE ADS1263_Startup(ADS1263_STARTUP *Chip, UBYTE Number, const char *HashFile);
+
+/******************************************************************************
+function:   Hash a register dump
+parameter:
+    Regs: ADS1263_REG_COUNT register values starting at REG_ID
+Info:
+    32-bit FNV-1a over the configuration registers
+******************************************************************************/
+UDOUBLE ADS1263_ConfigHash(const UBYTE *Regs);
+
+#endif
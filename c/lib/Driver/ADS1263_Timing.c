@@ -0,0 +1,103 @@
+/*****************************************************************************
+* | File        :   ADS1263_Timing.c
+* | Author      :   Highz team
+* | Function    :   Conversion time model and DRDY deadlines
+* | Info        :
+*----------------
+* | This version:   V1.0
+* | Date        :   2026-10-19
+* | Info        :
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documnetation files (the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to  whom the Software is
+# furished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included in
+# all copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS OR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+# THE SOFTWARE.
+#
+******************************************************************************/
+#include "ADS1263_Timing.h"
+
+#define TIMING_MAX_PIN  64      // CS pins, as ADS1263_SetDRDYPIN
+
+static int32_t Correction_ns[TIMING_MAX_PIN][16];   // Per CS pin and MODE2 rate
+static ADS1263_TIMING_STATS Stats;
+
+/* conversions until the first settled result, by MODE1 filter */
+static UDOUBLE Timing_Latency(UBYTE MODE1)
+{
+    switch(MODE1 & 0xe0) {
+    case ADS1263_FILTER_SINC2: return 2;
+    case ADS1263_FILTER_SINC3: return 3;
+    case ADS1263_FILTER_SINC4: return 4;
+    case ADS1263_FILTER_FIR:   return 3;
+    default:                   return 1;
+    }
+}
+
+uint64_t ADS1263_Timing_Model(UBYTE MODE0, UBYTE MODE1, UBYTE MODE2)
+{
+    double t = Timing_Latency(MODE1) / ADS1263_RateHz(MODE2) + ADS1263_DelaySeconds(MODE0);
+    return (uint64_t)(t * 1e9);
+}
+
+uint64_t ADS1263_Timing_Predict(UWORD DEV_CS_PIN, UBYTE MODE0, UBYTE MODE1, UBYTE MODE2)
+{
+    int64_t t = ADS1263_Timing_Model(MODE0, MODE1, MODE2);
+    if(DEV_CS_PIN < TIMING_MAX_PIN)
+        t += Correction_ns[DEV_CS_PIN][MODE2 & 0x0f];
+    return t > 0 ? (uint64_t)t : 1;
+}
+
+void ADS1263_Timing_Observe(UWORD DEV_CS_PIN, UBYTE MODE2, int64_t Error_ns)
+{
+    if(DEV_CS_PIN >= TIMING_MAX_PIN)
+        return;
+    Correction_ns[DEV_CS_PIN][MODE2 & 0x0f] += (int32_t)(Error_ns / 8);
+}
+
+static void Timing_Max(uint64_t *Max, uint64_t Value)
+{
+    uint64_t cur = __atomic_load_n(Max, __ATOMIC_RELAXED);
+    while(Value > cur &&
+          !__atomic_compare_exchange_n(Max, &cur, Value, 1, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+        ;
+}
+
+void ADS1263_Timing_Count(UBYTE Slept, uint64_t Wake_ns, uint64_t Late_ns, UBYTE Timeout)
+{
+    __atomic_fetch_add(&Stats.Waits, 1, __ATOMIC_RELAXED);
+    if(Slept) {
+        __atomic_fetch_add(&Stats.Sleeps, 1, __ATOMIC_RELAXED);
+        __atomic_fetch_add(&Stats.WakeSum_ns, Wake_ns, __ATOMIC_RELAXED);
+        Timing_Max(&Stats.WakeMax_ns, Wake_ns);
+    }
+    if(Timeout)
+        __atomic_fetch_add(&Stats.Timeouts, 1, __ATOMIC_RELAXED);
+    if(Late_ns == 0)
+        return;
+    __atomic_fetch_add(&Stats.Misses, 1, __ATOMIC_RELAXED);
+    Timing_Max(&Stats.WorstLate_ns, Late_ns);
+}
+
+void ADS1263_Timing_GetStats(ADS1263_TIMING_STATS *Out)
+{
+    Out->Waits = __atomic_load_n(&Stats.Waits, __ATOMIC_RELAXED);
+    Out->Sleeps = __atomic_load_n(&Stats.Sleeps, __ATOMIC_RELAXED);
+    Out->Misses = __atomic_load_n(&Stats.Misses, __ATOMIC_RELAXED);
+    Out->Timeouts = __atomic_load_n(&Stats.Timeouts, __ATOMIC_RELAXED);
+    Out->WorstLate_ns = __atomic_load_n(&Stats.WorstLate_ns, __ATOMIC_RELAXED);
+    Out->WakeSum_ns = __atomic_load_n(&Stats.WakeSum_ns, __ATOMIC_RELAXED);
+    Out->WakeMax_ns = __atomic_load_n(&Stats.WakeMax_ns, __ATOMIC_RELAXED);
+}
@@ -0,0 +1,124 @@
+/*****************************************************************************
+* | File        :   ADS1263_Timing.h
+* | Author      :   Highz team
+* | Function    :   Conversion time model and DRDY deadlines
+* | Info        :
+*----------------
+* | This version:   V1.0
+* | Date        :   2026-10-19
+* | Info        :
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documnetation files (the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to  whom the Software is
+# furished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included in
+# all copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS OR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+# THE SOFTWARE.
+#
+******************************************************************************/
+#ifndef _ADS1263_TIMING_H_
+#define _ADS1263_TIMING_H_
+
+#include "ADS1263.h"
+
+/******************************************************************************
+Conversion Timing
+
+Every conversion the scan starts is a restarted one (STOP1, register burst,
+START1), so its DRDY edge comes after the first-conversion latency:
+
+    t = delay (MODE0) + filter latency / data rate (MODE1, MODE2)
+
+with a latency of 1 conversion for sinc1, 2-4 for sinc2-sinc4 and 3 for
+the FIR filter. The chip's oscillator and internal overheads are not in the
+tables, so each chip learns a correction per data rate from the DRDY edges
+it actually produces (ADS1263_Timing_Observe, a 1/8 running average).
+
+ADS1263_WaitDRDY uses the prediction as a deadline: it sleeps until
+ADS1263_TIMING_GUARD_NS before the expected edge (when that is at least
+ADS1263_TIMING_SLEEP_NS away), then polls DRDY. An edge later than the
+prediction plus an eighth is a deadline miss: the sample is flagged
+ADS1263_SAMPLE_LATE and counted. No edge within four times the prediction
+plus ADS1263_TIMING_SLACK_NS is a timeout. Conversions with no prediction
+(probing, legacy single reads) time out after ADS1263_TIMING_MAX_NS.
+******************************************************************************/
+#define ADS1263_TIMING_GUARD_NS     100000ull       // Wake this early, then poll
+#define ADS1263_TIMING_SLEEP_NS     300000ull       // Shorter waits are polled only
+#define ADS1263_TIMING_SLACK_NS     10000000ull     // Added to the timeout
+#define ADS1263_TIMING_MAX_NS       2000000000ull   // Timeout without a prediction
+
+typedef struct
+{
+    uint64_t Waits;         // DRDY waits with a prediction
+    uint64_t Sleeps;        // Waits that slept before polling
+    uint64_t Misses;        // Edges after the deadline
+    uint64_t Timeouts;      // Edges that never came
+    uint64_t WorstLate_ns;  // Largest lateness seen
+    uint64_t WakeSum_ns;    // Scheduling latency: total oversleep of the sleeps
+    uint64_t WakeMax_ns;    // and the largest single one
+} ADS1263_TIMING_STATS;
+
+/******************************************************************************
+function:   Nominal first-conversion time of register settings
+parameter:
+    MODE0: Delay register value
+    MODE1: Filter register value
+    MODE2: Data rate register value
+Info:
+    Returns ns from START1 to DRDY, from the datasheet tables only
+******************************************************************************/
+uint64_t ADS1263_Timing_Model(UBYTE MODE0, UBYTE MODE1, UBYTE MODE2);
+
+/******************************************************************************
+function:   Predicted first-conversion time on a chip
+parameter:
+    DEV_CS_PIN: Chip select pin of the chip
+    MODE0, MODE1, MODE2: Register values of the conversion
+Info:
+    ADS1263_Timing_Model plus the chip's learned correction for the rate
+******************************************************************************/
+uint64_t ADS1263_Timing_Predict(UWORD DEV_CS_PIN, UBYTE MODE0, UBYTE MODE1, UBYTE MODE2);
+
+/******************************************************************************
+function:   Feed a measured DRDY edge back into the model
+parameter:
+    DEV_CS_PIN: Chip select pin of the chip
+    MODE2: Data rate register value of the conversion
+    Error_ns: Measured minus predicted time, negative when early
+Info:
+    Each chip is scanned by a single bus thread, so no locking is needed
+******************************************************************************/
+void ADS1263_Timing_Observe(UWORD DEV_CS_PIN, UBYTE MODE2, int64_t Error_ns);
+
+/******************************************************************************
+function:   Count one DRDY wait
+parameter:
+    Slept: The wait slept before polling
+    Wake_ns: How much later than asked the sleep returned
+    Late_ns: Lateness past the deadline, 0 if on time
+    Timeout: DRDY never went LOW
+Info:
+    Called by ADS1263_WaitDRDY; safe from several threads
+******************************************************************************/
+void ADS1263_Timing_Count(UBYTE Slept, uint64_t Wake_ns, uint64_t Late_ns, UBYTE Timeout);
+
+/******************************************************************************
+function:   Read the wait counters
+parameter:
+    Stats: Receives the counters since startup
+Info:
+******************************************************************************/
+void ADS1263_Timing_GetStats(ADS1263_TIMING_STATS *Stats);
+
+#endif
@@ -0,0 +1,513 @@
+/*****************************************************************************
+* | File        :   ADS1263_Writer.c
+* | Author      :   Highz team
+* | Function    :   Streaming binary disk writer
+* | Info        :
+*----------------
+* | This version:   V1.0
+* | Date        :   2026-10-19
+* | Info        :
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documnetation files (the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to  whom the Software is
+# furished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included in
+# all copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS OR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+# THE SOFTWARE.
+#
+******************************************************************************/
+#define _GNU_SOURCE
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include "ADS1263_Writer.h"
+#include "ADS1263_RT.h"
+
+#if defined(__linux__) && defined(__has_include)
+#if __has_include(<linux/io_uring.h>) && defined(__NR_io_uring_setup)
+#include <linux/io_uring.h>
+#define ADS1263_HAVE_URING
+#endif
+#endif
+
+enum { BUF_FREE = 0, BUF_FILLING, BUF_QUEUED };
+
+/******************************************************************************
+io_uring back end, on raw system calls
+******************************************************************************/
+struct ADS1263_WRITER_IORING
+{
+    int Fd;
+    void *SqPtr, *CqPtr;
+    size_t SqSize, CqSize, SqeSize;
+    unsigned *SqTail, *SqMask, *SqArray;
+    unsigned *CqHead, *CqTail, *CqMask;
+#ifdef ADS1263_HAVE_URING
+    struct io_uring_sqe *Sqes;
+    struct io_uring_cqe *Cqes;
+#endif
+};
+
+#ifdef ADS1263_HAVE_URING
+static UBYTE Uring_Setup(ADS1263_WRITER_IORING *u, unsigned Entries)
+{
+    struct io_uring_params p;
+
+    memset(&p, 0, sizeof(p));
+    memset(u, 0, sizeof(*u));
+    u->Fd = (int)syscall(__NR_io_uring_setup, Entries, &p);
+    if(u->Fd < 0)
+        return 1;
+
+    u->SqSize = p.sq_off.array + p.sq_entries * sizeof(unsigned);
+    u->CqSize = p.cq_off.cqes + p.cq_entries * sizeof(struct io_uring_cqe);
+    if(p.features & IORING_FEAT_SINGLE_MMAP) {
+        if(u->CqSize > u->SqSize)
+            u->SqSize = u->CqSize;
+        u->CqSize = 0;
+    }
+    u->SqPtr = mmap(NULL, u->SqSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, u->Fd, IORING_OFF_SQ_RING);
+    if(u->SqPtr == MAP_FAILED)
+        goto fail;
+    if(u->CqSize == 0) {
+        u->CqPtr = u->SqPtr;
+    } else {
+        u->CqPtr = mmap(NULL, u->CqSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, u->Fd, IORING_OFF_CQ_RING);
+        if(u->CqPtr == MAP_FAILED)
+            goto fail;
+    }
+    u->SqeSize = p.sq_entries * sizeof(struct io_uring_sqe);
+    u->Sqes = mmap(NULL, u->SqeSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, u->Fd, IORING_OFF_SQES);
+    if(u->Sqes == MAP_FAILED)
+        goto fail;
+
+    u->SqTail = (unsigned *)((UBYTE *)u->SqPtr + p.sq_off.tail);
+    u->SqMask = (unsigned *)((UBYTE *)u->SqPtr + p.sq_off.ring_mask);
+    u->SqArray = (unsigned *)((UBYTE *)u->SqPtr + p.sq_off.array);
+    u->CqHead = (unsigned *)((UBYTE *)u->CqPtr + p.cq_off.head);
+    u->CqTail = (unsigned *)((UBYTE *)u->CqPtr + p.cq_off.tail);
+    u->CqMask = (unsigned *)((UBYTE *)u->CqPtr + p.cq_off.ring_mask);
+    u->Cqes = (struct io_uring_cqe *)((UBYTE *)u->CqPtr + p.cq_off.cqes);
+    return 0;
+fail:
+    close(u->Fd);
+    u->Fd = -1;
+    return 1;
+}
+
+static void Uring_Release(ADS1263_WRITER_IORING *u)
+{
+    if(u->Sqes != NULL && u->Sqes != MAP_FAILED)
+        munmap(u->Sqes, u->SqeSize);
+    if(u->CqSize != 0 && u->CqPtr != NULL && u->CqPtr != MAP_FAILED)
+        munmap(u->CqPtr, u->CqSize);
+    if(u->SqPtr != NULL && u->SqPtr != MAP_FAILED)
+        munmap(u->SqPtr, u->SqSize);
+    if(u->Fd >= 0)
+        close(u->Fd);
+}
+
+static void Uring_Queue(ADS1263_WRITER_IORING *u, int Fd, const void *Buf, size_t Size, uint64_t Offset, UBYTE Index)
+{
+    unsigned tail = *u->SqTail;
+    unsigned i = tail & *u->SqMask;
+    struct io_uring_sqe *sqe = &u->Sqes[i];
+
+    memset(sqe, 0, sizeof(*sqe));
+    sqe->opcode = IORING_OP_WRITE;
+    sqe->fd = Fd;
+    sqe->addr = (uint64_t)(uintptr_t)Buf;
+    sqe->len = (UDOUBLE)Size;
+    sqe->off = Offset;
+    sqe->user_data = Index;
+    u->SqArray[i] = i;
+    __atomic_store_n(u->SqTail, tail + 1, __ATOMIC_RELEASE);
+}
+
+static int Uring_Enter(ADS1263_WRITER_IORING *u, unsigned Submit, unsigned Wait)
+{
+    int ret;
+    do {
+        ret = (int)syscall(__NR_io_uring_enter, u->Fd, Submit, Wait, Wait ? IORING_ENTER_GETEVENTS : 0, NULL, 0);
+    } while(ret < 0 && errno == EINTR);
+    return ret;
+}
+#endif
+
+/* write a whole buffer with pwrite, for the pool and for io_uring leftovers */
+static UBYTE Writer_Pwrite(int Fd, const UBYTE *Buf, size_t Size, uint64_t Offset)
+{
+    while(Size > 0) {
+        ssize_t n = pwrite(Fd, Buf, Size, (off_t)Offset);
+        if(n < 0 && errno == EINTR)
+            continue;
+        if(n <= 0)
+            return 1;
+        Buf += n;
+        Size -= (size_t)n;
+        Offset += (uint64_t)n;
+    }
+    return 0;
+}
+
+static void Writer_Done(ADS1263_WRITER *w, UBYTE h, UBYTE Error)
+{
+    if(Error) {
+        // Durable must never pass the hole this leaves in the file
+        uint64_t failed = __atomic_load_n(&w->Failed, __ATOMIC_RELAXED);
+        while(w->Offset[h] < failed &&
+              !__atomic_compare_exchange_n(&w->Failed, &failed, w->Offset[h], 0, __ATOMIC_RELEASE, __ATOMIC_RELAXED))
+            ;
+        __atomic_fetch_add(&w->Stats.Errors, 1, __ATOMIC_RELAXED);
+    } else
+        __atomic_fetch_add(&w->Stats.Written, w->Fill[h], __ATOMIC_RELAXED);
+    __atomic_store_n(&w->State[h], BUF_FREE, __ATOMIC_RELEASE);
+}
+
+/* next queued buffer, or -1 once the writer is closing and all are taken */
+static int Writer_Claim(ADS1263_WRITER *w)
+{
+    UDOUBLE idx = __atomic_fetch_add(&w->Tail, 1, __ATOMIC_ACQ_REL);
+    if(idx >= __atomic_load_n(&w->Head, __ATOMIC_ACQUIRE) && !w->Running)
+        return -1;
+    return idx % w->Config.Buffers;
+}
+
+static void *Writer_Pool(void *Arg)
+{
+    ADS1263_WRITER *w = (ADS1263_WRITER *)Arg;
+    int h;
+
+    ADS1263_RT_EnterIo();
+    while(1) {
+        while(sem_wait(&w->Ready) != 0)
+            ;
+        if((h = Writer_Claim(w)) < 0)
+            break;
+        Writer_Done(w, h, Writer_Pwrite(w->Fd, w->Buf[h], w->Fill[h], w->Offset[h]));
+    }
+    return NULL;
+}
+
+#ifdef ADS1263_HAVE_URING
+static void *Writer_Uring(void *Arg)
+{
+    ADS1263_WRITER *w = (ADS1263_WRITER *)Arg;
+    ADS1263_WRITER_IORING *u = w->Uring;
+    unsigned inflight = 0, submit, head, tail;
+    UBYTE closing = 0;
+    int h;
+
+    ADS1263_RT_EnterIo();
+    while(!closing || inflight > 0) {
+        // Block for work only when nothing is in flight
+        submit = 0;
+        if(!closing && inflight == 0) {
+            while(sem_wait(&w->Ready) != 0)
+                ;
+            if((h = Writer_Claim(w)) < 0)
+                closing = 1;
+            else {
+                Uring_Queue(u, w->Fd, w->Buf[h], w->Fill[h], w->Offset[h], h);
+                submit++;
+            }
+        }
+        while(!closing && sem_trywait(&w->Ready) == 0) {
+            if((h = Writer_Claim(w)) < 0) {
+                closing = 1;
+                break;
+            }
+            Uring_Queue(u, w->Fd, w->Buf[h], w->Fill[h], w->Offset[h], h);
+            submit++;
+        }
+        inflight += submit;
+        if(inflight == 0)
+            continue;
+        if(Uring_Enter(u, submit, 1) < 0) {
+            __atomic_fetch_add(&w->Stats.Errors, 1, __ATOMIC_RELAXED);
+            continue;
+        }
+
+        head = *u->CqHead;
+        tail = __atomic_load_n(u->CqTail, __ATOMIC_ACQUIRE);
+        for(; head != tail; head++) {
+            struct io_uring_cqe *cqe = &u->Cqes[head & *u->CqMask];
+            UBYTE b = (UBYTE)cqe->user_data;
+            UBYTE error = 0;
+            size_t done = cqe->res > 0 ? (size_t)cqe->res : 0;
+            // Old kernels without IORING_OP_WRITE, or a short write: finish here
+            if(cqe->res < 0 && cqe->res != -EINVAL && cqe->res != -EOPNOTSUPP)
+                error = 1;
+            else if(done < w->Fill[b])
+                error = Writer_Pwrite(w->Fd, w->Buf[b] + done, w->Fill[b] - done, w->Offset[b] + done);
+            Writer_Done(w, b, error);
+            inflight--;
+        }
+        __atomic_store_n(u->CqHead, head, __ATOMIC_RELEASE);
+    }
+    return NULL;
+}
+#endif
+
+void ADS1263_Writer_Defaults(ADS1263_WRITER_CONFIG *Config)
+{
+    memset(Config, 0, sizeof(*Config));
+    Config->BufferSize = 4u * 1024 * 1024;
+    Config->Buffers = 4;
+    Config->Threads = 2;
+}
+
+size_t ADS1263_Writer_Reserve(const ADS1263_WRITER_CONFIG *Config)
+{
+    return (size_t)Config->Buffers * (Config->BufferSize + ADS1263_WRITER_ALIGN)
+         + sizeof(ADS1263_WRITER_IORING) + ADS1263_ARENA_ALIGN;
+}
+
+UBYTE ADS1263_Writer_Open(ADS1263_WRITER *w, ADS1263_SESSION *Session, const char *Path, const ADS1263_WRITER_CONFIG *Config)
+{
+    void *(*run)(void *) = Writer_Pool;
+    UBYTE b, t;
+
+    memset(w, 0, sizeof(*w));
+    w->Config = *Config;
+    w->Failed = UINT64_MAX;
+    if(w->Config.Buffers < 2 || w->Config.Buffers > ADS1263_WRITER_MAX_BUFFERS ||
+       w->Config.BufferSize == 0 || w->Config.BufferSize % ADS1263_WRITER_ALIGN != 0) {
+        printf("Writer: bad buffer configuration \r\n");
+        return 1;
+    }
+    if(w->Config.Threads < 1)
+        w->Config.Threads = 1;
+    if(w->Config.Threads > ADS1263_WRITER_MAX_THREADS)
+        w->Config.Threads = ADS1263_WRITER_MAX_THREADS;
+
+    for(b = 0; b < w->Config.Buffers; b++) {
+        UBYTE *p = ADS1263_Session_Alloc(Session, w->Config.BufferSize + ADS1263_WRITER_ALIGN);
+        if(p == NULL)
+            return 1;
+        w->Buf[b] = (UBYTE *)(((uintptr_t)p + ADS1263_WRITER_ALIGN - 1) & ~(uintptr_t)(ADS1263_WRITER_ALIGN - 1));
+    }
+    w->Uring = ADS1263_Session_Alloc(Session, sizeof(ADS1263_WRITER_IORING));
+    if(w->Uring == NULL)
+        return 1;
+    w->Uring->Fd = -1;
+
+    w->Fd = open(Path, O_WRONLY | O_CREAT | (w->Config.Exclusive ? O_EXCL : O_TRUNC) | (w->Config.Direct ? O_DIRECT : 0), 0644);
+    if(w->Fd < 0 && w->Config.Direct && errno == EINVAL) {
+        // The refused open has created the file already, so it is ours to truncate
+        printf("Writer: %s does not take O_DIRECT, using buffered writes \r\n", Path);
+        w->Config.Direct = 0;
+        w->Fd = open(Path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    }
+    if(w->Fd < 0) {
+        printf("Writer: cannot create %s (%s) \r\n", Path, strerror(errno));
+        return 1;
+    }
+
+    w->Backend = ADS1263_WRITER_POOL;
+#ifdef ADS1263_HAVE_URING
+    if(!w->Config.NoUring && Uring_Setup(w->Uring, w->Config.Buffers) == 0) {
+        w->Backend = ADS1263_WRITER_URING;
+        run = Writer_Uring;
+    }
+#endif
+    sem_init(&w->Ready, 0, 0);
+    w->State[0] = BUF_FILLING;
+    w->Running = 1;
+    w->ThreadCount = w->Backend == ADS1263_WRITER_URING ? 1 : w->Config.Threads;
+    for(t = 0; t < w->ThreadCount; t++) {
+        if(pthread_create(&w->Thread[t], NULL, run, w) != 0) {
+            printf("Writer: thread start failed \r\n");
+            w->ThreadCount = t;
+            ADS1263_Writer_Close(w);
+            return 1;
+        }
+    }
+    printf("Writer: %s, %d x %zu KB buffers%s \r\n", w->Backend == ADS1263_WRITER_URING ? "io_uring" : "thread pool",
+           w->Config.Buffers, w->Config.BufferSize / 1024, w->Config.Direct ? ", O_DIRECT" : "");
+    return 0;
+}
+
+/* hand the buffer being filled to the back end and move to the next one */
+static void Writer_Queue(ADS1263_WRITER *w)
+{
+    UBYTE h = w->Head % w->Config.Buffers;
+    UDOUBLE queued;
+
+    __atomic_store_n(&w->State[h], BUF_QUEUED, __ATOMIC_RELEASE);
+    __atomic_store_n(&w->Head, w->Head + 1, __ATOMIC_RELEASE);
+    queued = w->Head - __atomic_load_n(&w->Tail, __ATOMIC_ACQUIRE);
+    if(queued <= w->Config.Buffers && queued > w->Stats.Queued)
+        w->Stats.Queued = (UBYTE)queued;
+    sem_post(&w->Ready);
+}
+
+/* make the buffer at Head the one being filled, if the back end is done with it */
+static UBYTE Writer_Take(ADS1263_WRITER *w)
+{
+    UBYTE h = w->Head % w->Config.Buffers;
+
+    if(w->State[h] == BUF_FILLING)
+        return 0;
+    if(__atomic_load_n(&w->State[h], __ATOMIC_ACQUIRE) != BUF_FREE)
+        return 1;
+    w->State[h] = BUF_FILLING;
+    w->Fill[h] = 0;
+    w->Offset[h] = w->End;
+    return 0;
+}
+
+UBYTE ADS1263_Writer_Write(ADS1263_WRITER *w, const void *Data, size_t Size)
+{
+    const UBYTE *src = (const UBYTE *)Data;
+    size_t room;
+    UBYTE h, next;
+
+    if(Size > w->Config.BufferSize || Writer_Take(w) != 0) {
+        w->Stats.Dropped += Size;
+        return 1;
+    }
+    h = w->Head % w->Config.Buffers;
+    room = w->Config.BufferSize - w->Fill[h];
+    if(Size > room) {
+        // Spills into the next buffer: only if that one is free already
+        next = (w->Head + 1) % w->Config.Buffers;
+        if(__atomic_load_n(&w->State[next], __ATOMIC_ACQUIRE) != BUF_FREE) {
+            w->Stats.Dropped += Size;
+            return 1;
+        }
+        memcpy(w->Buf[h] + w->Fill[h], src, room);
+        w->Fill[h] += room;
+        w->End += room;
+        src += room;
+        Size -= room;
+        w->Stats.Bytes += room;
+        Writer_Queue(w);
+        Writer_Take(w);
+        h = next;
+    }
+    memcpy(w->Buf[h] + w->Fill[h], src, Size);
+    w->Fill[h] += Size;
+    w->End += Size;
+    w->Stats.Bytes += Size;
+    if(w->Fill[h] == w->Config.BufferSize)
+        Writer_Queue(w);
+    return 0;
+}
+
+UBYTE ADS1263_Writer_WriteWait(ADS1263_WRITER *w, const void *Data, size_t Size)
+{
+    const UBYTE *src = (const UBYTE *)Data;
+    struct timespec ts = {0, 1000000};
+    UWORD idle = 0;
+    size_t n;
+    UBYTE next;
+
+    while(Size > 0) {
+        n = Size < w->Config.BufferSize ? Size : w->Config.BufferSize;
+        // Same test as ADS1263_Writer_Write, without counting a drop
+        next = (w->Head + 1) % w->Config.Buffers;
+        if(Writer_Take(w) != 0 ||
+           (n > w->Config.BufferSize - w->Fill[w->Head % w->Config.Buffers] &&
+            __atomic_load_n(&w->State[next], __ATOMIC_ACQUIRE) != BUF_FREE)) {
+            if(++idle > 5000)
+                return 1;
+            nanosleep(&ts, NULL);
+            continue;
+        }
+        ADS1263_Writer_Write(w, src, n);
+        src += n;
+        Size -= n;
+        idle = 0;
+    }
+    return 0;
+}
+
+uint64_t ADS1263_Writer_Offset(const ADS1263_WRITER *w)
+{
+    return w->End;
+}
+
+uint64_t ADS1263_Writer_Durable(const ADS1263_WRITER *w)
+{
+    uint64_t end = w->End;
+    uint64_t failed = __atomic_load_n(&w->Failed, __ATOMIC_ACQUIRE);
+    UBYTE b;
+
+    if(failed < end)
+        end = failed;
+    // Buffers at fixed offsets complete in any order: the first one not free bounds it
+    for(b = 0; b < w->Config.Buffers; b++) {
+        if(__atomic_load_n(&w->State[b], __ATOMIC_ACQUIRE) != BUF_FREE && w->Offset[b] < end)
+            end = w->Offset[b];
+    }
+    return end;
+}
+
+void ADS1263_Writer_Push(ADS1263_WRITER *w)
+{
+    UBYTE h = w->Head % w->Config.Buffers;
+
+    if(w->Config.Direct || w->ThreadCount == 0 || w->State[h] != BUF_FILLING || w->Fill[h] == 0)
+        return;
+    Writer_Queue(w);
+}
+
+UBYTE ADS1263_Writer_Close(ADS1263_WRITER *w)
+{
+    UBYTE h = w->Head % w->Config.Buffers;
+    UBYTE t;
+
+    if(w->ThreadCount > 0 && w->State[h] == BUF_FILLING && w->Fill[h] > 0) {
+        if(w->Config.Direct) {
+            // O_DIRECT writes whole blocks; the padding is truncated below
+            size_t pad = (ADS1263_WRITER_ALIGN - w->Fill[h] % ADS1263_WRITER_ALIGN) % ADS1263_WRITER_ALIGN;
+            memset(w->Buf[h] + w->Fill[h], 0, pad);
+            w->Fill[h] += pad;
+        }
+        Writer_Queue(w);
+    }
+    w->Running = 0;
+    for(t = 0; t < w->ThreadCount; t++)
+        sem_post(&w->Ready);
+    for(t = 0; t < w->ThreadCount; t++)
+        pthread_join(w->Thread[t], NULL);
+    w->ThreadCount = 0;
+
+#ifdef ADS1263_HAVE_URING
+    if(w->Backend == ADS1263_WRITER_URING)
+        Uring_Release(w->Uring);
+#endif
+    if(w->Fd >= 0) {
+        if(w->Config.Direct && ftruncate(w->Fd, (off_t)w->End) != 0)
+            w->Stats.Errors++;
+        close(w->Fd);
+        w->Fd = -1;
+    }
+    sem_destroy(&w->Ready);
+    return w->Stats.Errors != 0;
+}
+
+void ADS1263_Writer_GetStats(const ADS1263_WRITER *w, ADS1263_WRITER_STATS *Stats)
+{
+    Stats->Bytes = w->Stats.Bytes;
+    Stats->Dropped = w->Stats.Dropped;
+    Stats->Queued = w->Stats.Queued;
+    Stats->Written = __atomic_load_n(&w->Stats.Written, __ATOMIC_RELAXED);
+    Stats->Errors = __atomic_load_n(&w->Stats.Errors, __ATOMIC_RELAXED);
+}
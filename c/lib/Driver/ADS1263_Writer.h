@@ -0,0 +1,220 @@
+/*****************************************************************************
+* | File        :   ADS1263_Writer.h
+* | Author      :   Highz team
+* | Function    :   Streaming binary disk writer
+* | Info        :
+*----------------
+* | This version:   V1.0
+* | Date        :   2026-10-19
+* | Info        :
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documnetation files (the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to  whom the Software is
+# furished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included in
+# all copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS OR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+# THE SOFTWARE.
+#
+******************************************************************************/
+#ifndef _ADS1263_WRITER_H_
+#define _ADS1263_WRITER_H_
+
+#include <pthread.h>
+#include <semaphore.h>
+#include <stddef.h>
+#include "ADS1263.h"
+#include "ADS1263_Session.h"
+
+/******************************************************************************
+Streaming Writer
+
+Persists binary data (sweep frames, capture chunks) without ever making
+the caller wait on the disk. Data is copied into a ring of large aligned
+buffers taken from the session arena:
+
+    consumer --Write--> [ filling ][ full ][ full ][ writing ] --> file
+                          ^ one memcpy, never blocks          ^ I/O threads
+
+A full buffer is handed to the back end and the next free one is taken.
+When every buffer is still queued (the SD card stalls for longer than the
+ring covers) the data of that call is dropped and counted instead of
+blocking; ADS1263_WRITER_STATS.Dropped makes such gaps visible.
+
+Back ends:
+    io_uring   : one thread submits full buffers as IORING_OP_WRITE and
+                 reaps completions (raw system calls, no liburing needed)
+    thread pool: where io_uring is missing or refused, Threads threads
+                 each take the next full buffer and pwrite() it
+
+Buffers sit at fixed offsets of the file, so writes may complete in any
+order. With Direct set the file is opened O_DIRECT: buffers are page
+aligned and full-sized, the last one is padded and the file is truncated
+to its real length on close. All threads run on the I/O CPUs
+(ADS1263_RT_EnterIo).
+******************************************************************************/
+#define ADS1263_WRITER_MAX_BUFFERS  16
+#define ADS1263_WRITER_ALIGN        4096        // O_DIRECT buffer/offset alignment
+#define ADS1263_WRITER_MAX_THREADS  4
+
+typedef enum
+{
+    ADS1263_WRITER_URING = 0,
+    ADS1263_WRITER_POOL,
+}ADS1263_WRITER_BACKEND;
+
+typedef struct
+{
+    size_t BufferSize;      // Bytes per buffer, a multiple of ADS1263_WRITER_ALIGN
+    UBYTE  Buffers;         // Buffers in the ring, 2 .. ADS1263_WRITER_MAX_BUFFERS
+    UBYTE  Threads;         // Thread pool size, 1 .. ADS1263_WRITER_MAX_THREADS
+    UBYTE  Direct;          // Open with O_DIRECT
+    UBYTE  NoUring;         // Use the thread pool even if io_uring works
+    UBYTE  Exclusive;       // Fail rather than truncate a file that exists
+} ADS1263_WRITER_CONFIG;
+
+typedef struct
+{
+    uint64_t Bytes;         // Accepted by ADS1263_Writer_Write
+    uint64_t Written;       // On disk
+    uint64_t Dropped;       // Bytes refused because no buffer was free
+    uint64_t Errors;        // Failed writes
+    UBYTE    Queued;        // Most buffers queued at once
+} ADS1263_WRITER_STATS;
+
+typedef struct ADS1263_WRITER_IORING ADS1263_WRITER_IORING;
+
+typedef struct
+{
+    ADS1263_WRITER_CONFIG Config;
+    ADS1263_WRITER_BACKEND Backend;
+    int      Fd;
+    UBYTE   *Buf[ADS1263_WRITER_MAX_BUFFERS];
+    size_t   Fill[ADS1263_WRITER_MAX_BUFFERS];      // Bytes to write
+    uint64_t Offset[ADS1263_WRITER_MAX_BUFFERS];    // File offset of the buffer
+    UBYTE    State[ADS1263_WRITER_MAX_BUFFERS];     // Free, filling or queued
+    UDOUBLE  Head;          // Buffer being filled (producer)
+    UDOUBLE  Tail;          // Next queued buffer to write (back end)
+    uint64_t End;           // Logical file length
+    uint64_t Failed;        // Offset of the first buffer that failed, UINT64_MAX if none
+    sem_t    Ready;         // One post per queued buffer
+    volatile UBYTE Running;
+    UBYTE    ThreadCount;
+    pthread_t Thread[ADS1263_WRITER_MAX_THREADS];
+    ADS1263_WRITER_IORING *Uring;
+    ADS1263_WRITER_STATS Stats;
+} ADS1263_WRITER;
+
+/******************************************************************************
+function:   Default configuration
+parameter:
+    Config: Receives 4 x 4 MB buffers, 2 pool threads, buffered I/O
+Info:
+******************************************************************************/
+void ADS1263_Writer_Defaults(ADS1263_WRITER_CONFIG *Config);
+
+/******************************************************************************
+function:   Arena bytes a writer needs
+parameter:
+    Config: Writer configuration
+Info:
+    Add to the Reserve given to ADS1263_Session_Open
+******************************************************************************/
+size_t ADS1263_Writer_Reserve(const ADS1263_WRITER_CONFIG *Config);
+
+/******************************************************************************
+function:   Create the file and start the back end
+parameter:
+    Writer: Writer state, usually static
+    Session: Open session the buffers are taken from
+    Path: File to create (truncated if it exists, unless Config.Exclusive)
+    Config: Writer configuration
+Info:
+    Returns 0 on success, 1 on failure
+******************************************************************************/
+UBYTE ADS1263_Writer_Open(ADS1263_WRITER *Writer, ADS1263_SESSION *Session, const char *Path, const ADS1263_WRITER_CONFIG *Config);
+
+/******************************************************************************
+function:   Append data
+parameter:
+    Writer: Open writer
+    Data: Bytes to append
+    Size: Byte count, at most Config.BufferSize
+Info:
+    Never blocks. Data is appended whole or not at all
+    Returns 0 if queued, 1 if dropped
+******************************************************************************/
+UBYTE ADS1263_Writer_Write(ADS1263_WRITER *Writer, const void *Data, size_t Size);
+
+/******************************************************************************
+function:   Append data, waiting for buffers to come free
+parameter:
+    Writer: Open writer
+    Data: Bytes to append
+    Size: Byte count, any length
+Info:
+    For headers and indexes written outside the acquisition loop
+    Returns 0 if queued, 1 if the disk made no progress for 5 s
+******************************************************************************/
+UBYTE ADS1263_Writer_WriteWait(ADS1263_WRITER *Writer, const void *Data, size_t Size);
+
+/******************************************************************************
+function:   Logical length of the file so far
+parameter:
+    Writer: Open writer
+Info:
+    Offset the next accepted byte will land at
+******************************************************************************/
+uint64_t ADS1263_Writer_Offset(const ADS1263_WRITER *Writer);
+
+/******************************************************************************
+function:   Length of the file that has been written
+parameter:
+    Writer: Open writer
+Info:
+    Every byte below the returned offset has been handed to the kernel, so
+    it survives the process exiting or crashing (not a power loss). A failed
+    write pins it at the offset of that buffer for good
+******************************************************************************/
+uint64_t ADS1263_Writer_Durable(const ADS1263_WRITER *Writer);
+
+/******************************************************************************
+function:   Queue the buffer being filled without waiting for it to fill
+parameter:
+    Writer: Open writer
+Info:
+    Never blocks. Bounds how long data sits in memory at the cost of
+    smaller writes; ignored with O_DIRECT, which writes whole buffers only
+******************************************************************************/
+void ADS1263_Writer_Push(ADS1263_WRITER *Writer);
+
+/******************************************************************************
+function:   Flush, stop the back end and close the file
+parameter:
+    Writer: Open writer
+Info:
+    Waits for every queued buffer. Returns 0 if every write succeeded
+******************************************************************************/
+UBYTE ADS1263_Writer_Close(ADS1263_WRITER *Writer);
+
+/******************************************************************************
+function:   Read the writer counters
+parameter:
+    Writer: Open writer
+    Stats: Receives the counters
+Info:
+    Safe to call while the back end runs
+******************************************************************************/
+void ADS1263_Writer_GetStats(const ADS1263_WRITER *Writer, ADS1263_WRITER_STATS *Stats);
+
+#endif
@@ -0,0 +1,156 @@
+/*****************************************************************************
+* | File        :   alloccheck.c
+* | Author      :   Highz team
+* | Function    :   Heap allocation check of the acquisition loop
+* | Info        :
+*----------------
+* | This version:   V1.0
+* | Date        :   2026-10-19
+* | Info        :
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documnetation files (the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to  whom the Software is
+# furished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included in
+# all copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS OR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+# THE SOFTWARE.
+#
+******************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include "ADS1263.h"
+#include "ADS1263_Map.h"
+#include "ADS1263_Session.h"
+#include "ADS1263_Capture.h"
+#include "ADS1263_Pyramid.h"
+#include "ADS1263_Arrow.h"
+#include "ADS1263_Shm.h"
+#include "ADS1263_Latest.h"
+
+/******************************************************************************
+alloccheck: prove the steady-state loop makes no heap allocation
+
+    alloccheck [seconds] [map]
+
+Built by "make alloccheck" with -DADS1263_ALLOC_CHECK and the simulated bus
+of lib/Config/DEV_Stub.c, and run right away. It sets up a session the way
+examples/main.c and hzd do, with every consumer open (capture, pyramid,
+Arrow stream, sweep ring, latest snapshot), runs Acquire, convert, the
+consumers and Release for the given time (default 3 s), and exits 1 if any
+allocation was made after ADS1263_Session_Start. The default map spreads
+chips over both buses and uses hz= and adc=2 entries, so the divider and
+ADC2 paths run too.
+******************************************************************************/
+#define CHECK_SECONDS   3
+#define CHECK_SHM       "/hz_alloccheck"
+
+static const char CheckMap[] =
+    "chip adc1 cs=12 drdy=16 rate=38400\n"
+    "chip adc2 cs=22 drdy=17 rate=38400\n"
+    "chip adc3 bus=1 cs=26 drdy=27 rate=38400\n"
+    "ch * 0 det0\nch * 1 det1\nch * 2 det2\nch * 3 det3\n"
+    "ch * 4 det4\nch * 5 det5\nch * 6 det6\n"
+    "ch * 7 state hz=10\n"
+    "ch * temp temp adc=2\n";
+
+static const char *const Output[] = {"check.hzc", "check.hzp", "check.arrows"};
+
+static ADS1263_MAP Map;
+static ADS1263_SESSION Session;
+static ADS1263_CAPTURE Recorder;
+static ADS1263_PYRAMID Summary;
+static ADS1263_ARROW Table;
+static ADS1263_SHM Ring;
+static ADS1263_LATEST Newest;
+
+int main(int argc, char **argv)
+{
+    double seconds = argc > 1 ? atof(argv[1]) : CHECK_SECONDS;
+    char dir[] = "/tmp/alloccheck.XXXXXX", path[64];
+    ADS1263_CAPTURE_CONFIG Disk;
+    ADS1263_PYRAMID_CONFIG Zoom;
+    ADS1263_ARROW_CONFIG Columns;
+    uint64_t sweeps = 0, end, allocs;
+    UBYTE chip;
+    size_t i;
+
+    if(argc > 2 ? ADS1263_Map_Load(&Map, argv[2]) != 0 : ADS1263_Map_Parse(&Map, CheckMap) != 0)
+        return 2;
+    if(ADS1263_Map_Discover(&Map) != 0 || mkdtemp(dir) == NULL)
+        return 2;
+    ADS1263_Capture_Defaults(&Disk);
+    ADS1263_Pyramid_Defaults(&Zoom);
+    ADS1263_Arrow_Defaults(&Columns);
+    if(ADS1263_Session_Open(&Session, ADS1263_Capture_Reserve(&Disk) + ADS1263_Pyramid_Reserve(&Zoom, &Map) +
+                            ADS1263_Arrow_Reserve(&Columns, &Map), 0) != 0 ||
+       ADS1263_Map_Compile(&Map, Session.Scan) != 0 || ADS1263_Map_Init(&Map, NULL) != 0)
+        return 2;
+    for(chip = 0; chip < Session.Scan->ChipCount; chip++)
+        ADS1263_SetRef(chip, 5.0);
+
+    snprintf(path, sizeof(path), "%s/%s", dir, Output[0]);
+    if(ADS1263_Capture_Open(&Recorder, &Session, path, &Map, &Disk) != 0)
+        return 2;
+    snprintf(path, sizeof(path), "%s/%s", dir, Output[1]);
+    if(ADS1263_Pyramid_Open(&Summary, &Session, path, &Map, &Zoom) != 0)
+        return 2;
+    snprintf(path, sizeof(path), "%s/%s", dir, Output[2]);
+    if(ADS1263_Arrow_Open(&Table, &Session, path, &Map, &Columns) != 0)
+        return 2;
+    if(ADS1263_Shm_Create(&Ring, CHECK_SHM, 0) != 0 || ADS1263_Latest_Create(&Newest, NULL, &Map) != 0)
+        return 2;
+
+    printf("alloccheck: %d chips for %.1f s \r\n", Session.Scan->ChipCount, seconds);
+    fflush(stdout);
+    if(ADS1263_Session_Start(&Session) != 0)
+        return 2;
+    end = ADS1263_Clock_ns(CLOCK_MONOTONIC) + (uint64_t)(seconds * 1e9);
+    while(ADS1263_Clock_ns(CLOCK_MONOTONIC) < end) {
+        ADS1263_FRAME *Frame = ADS1263_MultiBus_Acquire(Session.MultiBus);
+        if(Frame == NULL)
+            break;
+        if(Frame->Header.End_ns > Session.Rates->Time_ns + 1000000000ull)
+            ADS1263_Sched_Update(Session.Scan, Session.Rates);
+        ADS1263_Frame_ToVolts(Frame);
+        ADS1263_Capture_Append(&Recorder, Frame);
+        ADS1263_Pyramid_Append(&Summary, Frame);
+        ADS1263_Arrow_Append(&Table, Frame);
+        ADS1263_Shm_Publish(&Ring, Frame);
+        ADS1263_Shm_Commit(&Ring, ADS1263_Capture_Saved(&Recorder));
+        ADS1263_Latest_Publish(&Newest, Frame);
+        ADS1263_MultiBus_Release(Session.MultiBus);
+        sweeps++;
+    }
+    allocs = ADS1263_Session_Check(&Session);
+
+    ADS1263_Capture_Close(&Recorder);
+    ADS1263_Pyramid_Close(&Summary);
+    ADS1263_Arrow_Close(&Table);
+    ADS1263_Shm_Close(&Ring);
+    shm_unlink(CHECK_SHM);
+    ADS1263_Latest_Close(&Newest);
+    ADS1263_Session_Close(&Session);
+    for(i = 0; i < sizeof(Output) / sizeof(Output[0]); i++) {
+        snprintf(path, sizeof(path), "%s/%s", dir, Output[i]);
+        unlink(path);
+    }
+    rmdir(dir);
+
+    printf("alloccheck: %llu sweeps, %s \r\n", (unsigned long long)sweeps, allocs == 0 ? "no allocation" : "FAILED");
+    return sweeps == 0 || allocs != 0;
+}
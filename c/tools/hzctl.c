@@ -0,0 +1,130 @@
+/*****************************************************************************
+* | File        :   hzctl.c
+* | Author      :   Highz team
+* | Function    :   Command-line client for the hzd control socket
+* | Info        :
+*----------------
+* | This version:   V1.0
+* | Date        :   2026-10-19
+* | Info        :
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documnetation files (the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to  whom the Software is
+# furished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included in
+# all copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS OR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+# THE SOFTWARE.
+#
+******************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+/******************************************************************************
+hzctl: send one command to a running hzd
+
+    hzctl [-s socket] command [argument]
+
+    -s       control socket (default /run/hzd.sock)
+
+Prints every line of the reply. Exits 0 if it ends in "ok", 1 if it ends
+in "err" or the daemon cannot be reached. For example:
+
+    hzctl stats
+    hzctl reconfigure /etc/hz/fast.map
+    hzctl snapshot
+******************************************************************************/
+#define HZCTL_SOCKET    "/run/hzd.sock"
+
+static void Usage(void)
+{
+    fprintf(stderr, "usage: hzctl [-s socket] start|stop|stats|snapshot|quit|reconfigure <map>\r\n");
+    exit(2);
+}
+
+int main(int argc, char **argv)
+{
+    const char *path = HZCTL_SOCKET;
+    struct sockaddr_un addr;
+    char line[1024], buf[4096];
+    size_t len = 0, n;
+    ssize_t got;
+    char *end;
+    int fd, opt, i;
+
+    while((opt = getopt(argc, argv, "s:")) != -1) {
+        switch(opt) {
+        case 's': path = optarg; break;
+        default: Usage();
+        }
+    }
+    if(optind >= argc)
+        Usage();
+
+    // The command and its arguments, one line
+    line[0] = '\0';
+    for(i = optind; i < argc; i++) {
+        n = strlen(line);
+        snprintf(line + n, sizeof(line) - n, "%s%s", i > optind ? " " : "", argv[i]);
+    }
+    n = strlen(line);
+    if(n + 1 >= sizeof(line))
+        Usage();
+    line[n++] = '\n';
+
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if(strlen(path) >= sizeof(addr.sun_path))
+        Usage();
+    strcpy(addr.sun_path, path);
+    fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if(fd < 0 || connect(fd, (struct sockaddr *)&addr, sizeof(addr)) != 0) {
+        fprintf(stderr, "hzctl: cannot reach %s \r\n", path);
+        return 1;
+    }
+    if(send(fd, line, n, MSG_NOSIGNAL) != (ssize_t)n) {
+        fprintf(stderr, "hzctl: send failed \r\n");
+        return 1;
+    }
+
+    // Reply lines until the closing "ok" or "err"
+    for(;;) {
+        got = recv(fd, buf + len, sizeof(buf) - 1 - len, 0);
+        if(got <= 0) {
+            fprintf(stderr, "hzctl: connection closed \r\n");
+            return 1;
+        }
+        len += got;
+        buf[len] = '\0';
+        while((end = strchr(buf, '\n')) != NULL) {
+            *end = '\0';
+            puts(buf);
+            if(strncmp(buf, "ok", 2) == 0 && (buf[2] == '\0' || buf[2] == ' ')) {
+                close(fd);
+                return 0;
+            }
+            if(strncmp(buf, "err", 3) == 0 && (buf[3] == '\0' || buf[3] == ' ')) {
+                close(fd);
+                return 1;
+            }
+            len -= end + 1 - buf;
+            memmove(buf, end + 1, len + 1);
+        }
+        if(len == sizeof(buf) - 1)
+            len = 0;
+    }
+}
@@ -0,0 +1,493 @@
+/*****************************************************************************
+* | File        :   hzquery.c
+* | Author      :   Highz team
+* | Function    :   Offline capture query and export
+* | Info        :
+*----------------
+* | This version:   V1.0
+* | Date        :   2026-10-19
+* | Info        :
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documnetation files (the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to  whom the Software is
+# furished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included in
+# all copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS OR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+# THE SOFTWARE.
+#
+******************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+#include "ADS1263_Capture.h"
+#include "ADS1263_Pyramid.h"
+#include "ADS1263_Convert.h"
+
+/******************************************************************************
+hzquery: select sweeps from a capture file and export them
+
+    hzquery [-f from] [-t to] [-c chips] [-n channels] [-s state]
+            [-v] [-b] [-j threads] [-o out] [-l] capture.hzc
+    hzquery -p pixels [-f from] [-t to] [-c chips] [-n channels]
+            [-v] [-b] [-o out] capture.hzp
+
+    -f, -t   time range, Unix seconds (fractions allowed); -t is exclusive
+    -c       only channels of these chips, comma separated
+    -n       these channels, comma separated, "channel" or "chip.channel"
+    -s       only sweeps taken in this calibration state (0-9)
+    -v       volts instead of raw codes
+    -b       binary rows instead of CSV: int64 time_ns, uint64 sequence,
+             then per channel a double (-v) or an int32 code
+    -j       decoding threads (default: online CPUs)
+    -l       list the chunks and channels instead of exporting
+    -p       read a summary pyramid instead: at most pixels + 1 rows over
+             the range, each the bucket start time and per channel the
+             min, max, mean and sample count (binary: int64 time_ns, then
+             per channel three doubles and a uint64 count)
+
+Chunks outside the time range or in another calibration state are skipped
+through the index without being decoded. The rest are decoded in batches,
+one chunk per thread at a time, and written out in file order. A pyramid
+query reads only the buckets of the level that fits the pixel count.
+******************************************************************************/
+#define MAX_COLUMNS     (ADS1263_MAX_CHIPS * ADS1263_FRAME_STRIDE)
+#define BATCH_PER_THREAD 4
+
+typedef struct
+{
+    char    *Data;
+    size_t   Len, Cap;
+} OUTPUT;
+
+static struct
+{
+    uint64_t From, To;
+    int      State;
+    UBYTE    Volts, Binary;
+    UWORD    Columns;
+    char     Name[MAX_COLUMNS][2 * ADS1263_MAP_NAME + 1];
+} Query = {.To = UINT64_MAX, .State = -1};
+
+static ADS1263_CAPTURE_READER Reader;
+static UDOUBLE BatchStart, BatchEnd;
+static UDOUBLE Next;
+static OUTPUT *Out;
+static pthread_barrier_t Start, Done;
+static volatile UBYTE Finished;
+
+static uint64_t Parse_Time(const char *Text)
+{
+    char *end;
+    uint64_t ns = strtoull(Text, &end, 10) * 1000000000ull;
+    uint64_t scale = 100000000ull;
+
+    if(*end == '.') {
+        for(end++; *end >= '0' && *end <= '9' && scale > 0; end++, scale /= 10)
+            ns += (uint64_t)(*end - '0') * scale;
+    }
+    return ns;
+}
+
+static void Output_Put(OUTPUT *o, const void *Data, size_t Size)
+{
+    if(o->Len + Size > o->Cap) {
+        size_t cap = o->Cap ? o->Cap : 65536;
+        while(cap < o->Len + Size)
+            cap *= 2;
+        char *grown = realloc(o->Data, cap);
+        if(grown == NULL) {
+            fprintf(stderr, "hzquery: out of memory \r\n");
+            exit(1);
+        }
+        o->Data = grown;
+        o->Cap = cap;
+    }
+    memcpy(o->Data + o->Len, Data, Size);
+    o->Len += Size;
+}
+
+/* chip of a column, for its reference voltage */
+static UBYTE Column_Chip(const ADS1263_CAPTURE_VIEW *v, int Column)
+{
+    UBYTE n;
+    for(n = 0; n + 1 < v->Header->ChipCount; n++) {
+        if(Column < v->First[n + 1])
+            break;
+    }
+    return n;
+}
+
+static UBYTE Chunk_Selected(UDOUBLE Chunk)
+{
+    const ADS1263_CAPTURE_INDEX *x = &Reader.Index[Chunk];
+    if(Query.State >= 0 && x->CalState != Query.State)
+        return 0;
+    return x->LastTime_ns >= Query.From && x->FirstTime_ns < Query.To;
+}
+
+static void Chunk_Export(UDOUBLE Chunk, ADS1263_CAPTURE_VIEW *v, OUTPUT *o, double *Volt)
+{
+    int column[MAX_COLUMNS];
+    double ref[MAX_COLUMNS];
+    UDOUBLE first, last, f;
+    UWORD i;
+    char line[64];
+
+    if(!Chunk_Selected(Chunk))
+        return;
+    if(ADS1263_Capture_View(&Reader, Chunk, v) != 0) {
+        fprintf(stderr, "hzquery: chunk %lu is damaged, skipped \r\n", (unsigned long)Chunk);
+        return;
+    }
+    first = ADS1263_Capture_FrameAt(v, Query.From);
+    last = ADS1263_Capture_FrameAt(v, Query.To);
+    for(i = 0; i < Query.Columns; i++) {
+        column[i] = ADS1263_Capture_Column(v, Query.Name[i]);
+        if(column[i] >= 0 && Query.Volts) {
+            ref[i] = v->Chip[Column_Chip(v, column[i])].Ref;
+            ADS1263_CodeToVolt_F64(v->Code + (size_t)column[i] * v->Header->Frames + first,
+                                   Volt + (size_t)i * v->Header->Frames, last - first, ref[i]);
+        }
+    }
+
+    for(f = first; f < last; f++) {
+        const ADS1263_CAPTURE_RECORD *r = &v->Record[f];
+        if(Query.Binary) {
+            Output_Put(o, &r->Time_ns, sizeof(r->Time_ns));
+            Output_Put(o, &r->Sequence, sizeof(r->Sequence));
+            for(i = 0; i < Query.Columns; i++) {
+                if(Query.Volts) {
+                    double x = column[i] < 0 ? 0.0 / 0.0 : Volt[(size_t)i * v->Header->Frames + f - first];
+                    Output_Put(o, &x, sizeof(x));
+                } else {
+                    int32_t x = column[i] < 0 ? 0 : (int32_t)v->Code[(size_t)column[i] * v->Header->Frames + f];
+                    Output_Put(o, &x, sizeof(x));
+                }
+            }
+            continue;
+        }
+        Output_Put(o, line, snprintf(line, sizeof(line), "%llu,%llu,%d,%lu",
+                   (unsigned long long)r->Time_ns, (unsigned long long)r->Sequence,
+                   v->Header->CalState, (unsigned long)r->Flags));
+        for(i = 0; i < Query.Columns; i++) {
+            int n;
+            if(column[i] < 0)
+                n = snprintf(line, sizeof(line), ",");
+            else if(Query.Volts)
+                n = snprintf(line, sizeof(line), ",%.9f", Volt[(size_t)i * v->Header->Frames + f - first]);
+            else
+                n = snprintf(line, sizeof(line), ",%d", (int32_t)v->Code[(size_t)column[i] * v->Header->Frames + f]);
+            Output_Put(o, line, n);
+        }
+        Output_Put(o, "\n", 1);
+    }
+}
+
+static void *Worker(void *Arg)
+{
+    ADS1263_CAPTURE_VIEW v;
+    double *volt = NULL;
+    size_t room = 0;
+    UDOUBLE chunk;
+
+    memset(&v, 0, sizeof(v));
+    while(1) {
+        pthread_barrier_wait(&Start);
+        if(Finished)
+            break;
+        while((chunk = __atomic_fetch_add(&Next, 1, __ATOMIC_RELAXED)) < BatchEnd) {
+            size_t need = (size_t)Query.Columns * Reader.Index[chunk].Frames;
+            if(Query.Volts && need > room) {
+                free(volt);
+                volt = malloc(need * sizeof(double));
+                if(volt == NULL) {
+                    // A chunk left out would go unnoticed in the export
+                    fprintf(stderr, "hzquery: out of memory \r\n");
+                    exit(1);
+                }
+                room = need;
+            }
+            Chunk_Export(chunk, &v, &Out[chunk - BatchStart], volt);
+        }
+        pthread_barrier_wait(&Done);
+    }
+    ADS1263_Capture_ViewFree(&v);
+    free(volt);
+    return NULL;
+}
+
+/* -n / -c: the columns to export, named "chip.channel" */
+static UBYTE Select_Columns(const char *Chips, const char *Channels)
+{
+    ADS1263_CAPTURE_VIEW v;
+    UDOUBLE chunk;
+    UBYTE n, i;
+    char list[1024], *tok, *save;
+
+    if(Channels != NULL) {
+        snprintf(list, sizeof(list), "%s", Channels);
+        for(tok = strtok_r(list, ",", &save); tok && Query.Columns < MAX_COLUMNS; tok = strtok_r(NULL, ",", &save))
+            snprintf(Query.Name[Query.Columns++], sizeof(Query.Name[0]), "%s", tok);
+        return Query.Columns == 0;
+    }
+    // Everything (of the given chips) in the first selected chunk
+    for(chunk = 0; chunk < Reader.Count && !Chunk_Selected(chunk); chunk++)
+        ;
+    memset(&v, 0, sizeof(v));
+    if(chunk == Reader.Count || ADS1263_Capture_View(&Reader, chunk, &v) != 0)
+        return 1;
+    for(n = 0; n < v.Header->ChipCount; n++) {
+        if(Chips != NULL) {
+            snprintf(list, sizeof(list), ",%s,", Chips);
+            char key[ADS1263_MAP_NAME + 2];
+            snprintf(key, sizeof(key), ",%s,", v.Chip[n].Name);
+            if(strstr(list, key) == NULL)
+                continue;
+        }
+        for(i = 0; i < v.Chip[n].Slots && Query.Columns < MAX_COLUMNS; i++)
+            snprintf(Query.Name[Query.Columns++], sizeof(Query.Name[0]), "%s.%s", v.Chip[n].Name, v.Chip[n].Channel[i]);
+    }
+    ADS1263_Capture_ViewFree(&v);
+    return Query.Columns == 0;
+}
+
+static void List(void)
+{
+    ADS1263_CAPTURE_VIEW v;
+    UDOUBLE chunk;
+    UBYTE n, i;
+
+    printf("%lu chunks, index %s \r\n", (unsigned long)Reader.Count, Reader.Complete ? "complete" : "rebuilt");
+    for(chunk = 0; chunk < Reader.Count; chunk++) {
+        const ADS1263_CAPTURE_INDEX *x = &Reader.Index[chunk];
+        printf("%6lu  %.3f - %.3f  %6lu frames  epoch %lu  state %d  %s \r\n", (unsigned long)chunk,
+               x->FirstTime_ns * 1e-9, x->LastTime_ns * 1e-9, (unsigned long)x->Frames, (unsigned long)x->Epoch,
+               x->CalState, x->Codec == ADS1263_CODEC_DELTA ? "delta" : "raw");
+    }
+    memset(&v, 0, sizeof(v));
+    if(Reader.Count > 0 && ADS1263_Capture_View(&Reader, Reader.Count - 1, &v) == 0) {
+        for(n = 0; n < v.Header->ChipCount; n++) {
+            for(i = 0; i < v.Chip[n].Slots; i++)
+                printf("%s.%s  IN%d  ADC%d \r\n", v.Chip[n].Name, v.Chip[n].Channel[i], v.Chip[n].Input[i], v.Chip[n].Adc[i]);
+        }
+    }
+    ADS1263_Capture_ViewFree(&v);
+}
+
+/* -p: one row per bucket of the level that fits Pixels */
+static int Pyramid_Export(const char *Path, UDOUBLE Pixels, const char *Chips, const char *Channels, FILE *Out)
+{
+    ADS1263_PYRAMID_READER r;
+    ADS1263_PYRAMID_BUCKET *bucket;
+    int column[MAX_COLUMNS];
+    double lsb[MAX_COLUMNS];
+    uint64_t from = Query.From, to = Query.To, span0, span1;
+    UDOUBLE n = 0, b;
+    UBYTE level = 0;
+    UWORD i, c;
+    char list[1024], *tok, *save;
+
+    if(ADS1263_Pyramid_OpenRead(&r, Path) != 0)
+        return 1;
+    if(ADS1263_Pyramid_Span(&r, &span0, &span1) != 0) {
+        fprintf(stderr, "hzquery: %s holds no buckets yet \r\n", Path);
+        ADS1263_Pyramid_CloseRead(&r);
+        return 1;
+    }
+    if(from < span0)
+        from = span0;
+    if(to > span1)
+        to = span1;
+
+    if(Channels != NULL) {
+        snprintf(list, sizeof(list), "%s", Channels);
+        for(tok = strtok_r(list, ",", &save); tok && Query.Columns < MAX_COLUMNS; tok = strtok_r(NULL, ",", &save)) {
+            snprintf(Query.Name[Query.Columns], sizeof(Query.Name[0]), "%s", tok);
+            column[Query.Columns++] = ADS1263_Pyramid_Column(&r, tok);
+        }
+    } else {
+        for(c = 0; c < r.Header->Columns && Query.Columns < MAX_COLUMNS; c++) {
+            if(Chips != NULL) {
+                char key[ADS1263_PYRAMID_NAME + 2];
+                snprintf(list, sizeof(list), ",%s,", Chips);
+                snprintf(key, sizeof(key), ",%.*s,", (int)strcspn(r.Column[c].Name, "."), r.Column[c].Name);
+                if(strstr(list, key) == NULL)
+                    continue;
+            }
+            snprintf(Query.Name[Query.Columns], sizeof(Query.Name[0]), "%s", r.Column[c].Name);
+            column[Query.Columns++] = c;
+        }
+    }
+    bucket = malloc((size_t)Query.Columns * (Pixels + 1) * sizeof(*bucket));
+    if(Query.Columns == 0 || bucket == NULL) {
+        fprintf(stderr, "hzquery: nothing selected \r\n");
+        ADS1263_Pyramid_CloseRead(&r);
+        return 1;
+    }
+    for(i = 0; i < Query.Columns; i++) {
+        UDOUBLE one = 1;
+        lsb[i] = 1.0;
+        if(column[i] >= 0 && Query.Volts)
+            ADS1263_CodeToVolt_F64(&one, &lsb[i], 1, r.Column[column[i]].Ref);
+        if(column[i] >= 0)
+            n = ADS1263_Pyramid_Fetch(&r, column[i], from, to, Pixels, bucket + (size_t)i * (Pixels + 1), &level);
+    }
+
+    if(!Query.Binary) {
+        fprintf(Out, "time_ns");
+        for(i = 0; i < Query.Columns; i++)
+            fprintf(Out, ",%s.min,%s.max,%s.mean,%s.count", Query.Name[i], Query.Name[i], Query.Name[i], Query.Name[i]);
+        fprintf(Out, "\n");
+    }
+    for(b = 0; b < n; b++) {
+        UBYTE shift = r.Header->BaseLog2 + level;
+        int64_t time = (int64_t)(((from >> shift) + b) << shift);
+        if(Query.Binary)
+            fwrite(&time, sizeof(time), 1, Out);
+        else
+            fprintf(Out, "%lld", (long long)time);
+        for(i = 0; i < Query.Columns; i++) {
+            const ADS1263_PYRAMID_BUCKET *x = bucket + (size_t)i * (Pixels + 1) + b;
+            uint64_t count = column[i] < 0 ? 0 : x->Count;
+            double v[3] = {0.0 / 0.0, 0.0 / 0.0, 0.0 / 0.0};
+            if(count > 0) {
+                v[0] = x->Min * lsb[i];
+                v[1] = x->Max * lsb[i];
+                v[2] = (double)x->Sum / count * lsb[i];
+            }
+            if(Query.Binary) {
+                fwrite(v, sizeof(v), 1, Out);
+                fwrite(&count, sizeof(count), 1, Out);
+            } else if(count == 0) {
+                fprintf(Out, ",,,,0");
+            } else if(Query.Volts) {
+                fprintf(Out, ",%.9f,%.9f,%.9f,%llu", v[0], v[1], v[2], (unsigned long long)count);
+            } else {
+                fprintf(Out, ",%d,%d,%.3f,%llu", x->Min, x->Max, v[2], (unsigned long long)count);
+            }
+        }
+        if(!Query.Binary)
+            fprintf(Out, "\n");
+    }
+    free(bucket);
+    ADS1263_Pyramid_CloseRead(&r);
+    return 0;
+}
+
+static void Usage(void)
+{
+    fprintf(stderr, "usage: hzquery [-f from] [-t to] [-c chips] [-n channels] [-s state] [-v] [-b] [-j threads] [-o out] [-l] capture.hzc\r\n"
+                    "       hzquery -p pixels [-f from] [-t to] [-c chips] [-n channels] [-v] [-b] [-o out] capture.hzp\r\n");
+    exit(2);
+}
+
+int main(int argc, char **argv)
+{
+    const char *chips = NULL, *channels = NULL, *path = NULL;
+    long threads = sysconf(_SC_NPROCESSORS_ONLN);
+    UBYTE list = 0;
+    UDOUBLE pixels = 0;
+    FILE *out = stdout;
+    pthread_t *thread;
+    UDOUBLE chunk, first, batch;
+    int opt;
+    long t;
+    UWORD i;
+
+    while((opt = getopt(argc, argv, "f:t:c:n:s:vbj:o:lp:")) != -1) {
+        switch(opt) {
+        case 'f': Query.From = Parse_Time(optarg); break;
+        case 't': Query.To = Parse_Time(optarg); break;
+        case 'c': chips = optarg; break;
+        case 'n': channels = optarg; break;
+        case 's': Query.State = atoi(optarg); break;
+        case 'v': Query.Volts = 1; break;
+        case 'b': Query.Binary = 1; break;
+        case 'j': threads = atol(optarg); break;
+        case 'o': path = optarg; break;
+        case 'l': list = 1; break;
+        case 'p': pixels = strtoul(optarg, NULL, 10); break;
+        default: Usage();
+        }
+    }
+    if(optind + 1 != argc)
+        Usage();
+    if(pixels > 0) {
+        int ret;
+        if(path != NULL && (out = fopen(path, "wb")) == NULL) {
+            fprintf(stderr, "hzquery: cannot create %s \r\n", path);
+            return 1;
+        }
+        ret = Pyramid_Export(argv[optind], pixels, chips, channels, out);
+        if(out != stdout)
+            fclose(out);
+        return ret;
+    }
+    if(ADS1263_Capture_OpenRead(&Reader, argv[optind]) != 0)
+        return 1;
+    if(list) {
+        List();
+        return 0;
+    }
+    if(Select_Columns(chips, channels) != 0) {
+        fprintf(stderr, "hzquery: nothing selected \r\n");
+        return 1;
+    }
+    if(path != NULL && (out = fopen(path, "wb")) == NULL) {
+        fprintf(stderr, "hzquery: cannot create %s \r\n", path);
+        return 1;
+    }
+    if(!Query.Binary) {
+        fprintf(out, "time_ns,sequence,state,flags");
+        for(i = 0; i < Query.Columns; i++)
+            fprintf(out, ",%s", Query.Name[i]);
+        fprintf(out, "\n");
+    }
+
+    if(threads < 1)
+        threads = 1;
+    batch = (UDOUBLE)threads * BATCH_PER_THREAD;
+    Out = calloc(batch, sizeof(OUTPUT));
+    thread = calloc(threads, sizeof(pthread_t));
+    if(Out == NULL || thread == NULL)
+        return 1;
+    pthread_barrier_init(&Start, NULL, threads + 1);
+    pthread_barrier_init(&Done, NULL, threads + 1);
+    for(t = 0; t < threads; t++)
+        pthread_create(&thread[t], NULL, Worker, NULL);
+
+    // The index is in time order: start at the first chunk that can match
+    first = ADS1263_Capture_Seek(&Reader, Query.From);
+    for(chunk = first; chunk < Reader.Count && Reader.Index[chunk].FirstTime_ns < Query.To; chunk = BatchEnd) {
+        BatchStart = Next = chunk;
+        BatchEnd = chunk + batch < Reader.Count ? chunk + batch : Reader.Count;
+        pthread_barrier_wait(&Start);
+        pthread_barrier_wait(&Done);
+        for(i = 0; i < BatchEnd - BatchStart; i++) {
+            fwrite(Out[i].Data, 1, Out[i].Len, out);
+            Out[i].Len = 0;
+        }
+    }
+    Finished = 1;
+    pthread_barrier_wait(&Start);
+    for(t = 0; t < threads; t++)
+        pthread_join(thread[t], NULL);
+
+    if(out != stdout)
+        fclose(out);
+    ADS1263_Capture_CloseRead(&Reader);
+    return 0;
+}
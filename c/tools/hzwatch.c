@@ -0,0 +1,223 @@
+/*****************************************************************************
+* | File        :   hzwatch.c
+* | Author      :   Highz team
+* | Function    :   Live sweep monitor over shared memory
+* | Info        :
+*----------------
+* | This version:   V1.0
+* | Date        :   2026-10-19
+* | Info        :
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documnetation files (the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to  whom the Software is
+# furished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included in
+# all copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS OR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+# THE SOFTWARE.
+#
+******************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+#include <time.h>
+#include <unistd.h>
+#include "ADS1263_Shm.h"
+#include "ADS1263_Latest.h"
+
+/******************************************************************************
+hzwatch: follow the shared-memory sweep ring of a running acquisition
+
+    hzwatch [-n name] [-o] [-d delay_us] [-r]
+    hzwatch -l [-n name] [channel ...]
+
+    -n       shared-memory object (default /hz_sweeps)
+    -o       start at the oldest sweep still in the ring, not the newest
+    -d       pretend to be a slow consumer: sleep this long per sweep
+    -r       print the volts of every new sweep instead of a summary
+    -l       poll the latest-sweep snapshot (default /hz_latest) instead,
+             as a control loop would, and print the named channels
+
+Once a second it prints the sweeps read and missed and the newest sweep's
+header. Any number of hzwatch (or other readers) can run next to the
+acquisition; none of them can slow it down. With -l it prints the reads
+per second and the time one read of the whole snapshot takes.
+******************************************************************************/
+static volatile sig_atomic_t Stop;
+
+static void Handler(int signo)
+{
+    (void)signo;
+    Stop = 1;
+}
+
+static uint64_t Now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static void Usage(void)
+{
+    fprintf(stderr, "usage: hzwatch [-n name] [-o] [-d delay_us] [-r] | -l [-n name] [channel ...]\r\n");
+    exit(2);
+}
+
+/* spin on the snapshot like a control loop, report once a second */
+static int Poll(const char *Name, char **Channel, int Channels)
+{
+    static ADS1263_LATEST_SWEEP sweep;
+    ADS1263_LATEST latest;
+    UDOUBLE epoch = 0;
+    int index[16], c;
+    UBYTE found = 0, abandoned = 0;
+    uint64_t reads = 0, last = 0, changes = 0, report;
+
+    if(ADS1263_Latest_Attach(&latest, Name) != 0) {
+        fprintf(stderr, "hzwatch: no snapshot %s \r\n", Name);
+        return 1;
+    }
+    if(Channels > 16)
+        Channels = 16;
+    signal(SIGINT, Handler);
+    report = Now_ns() + 1000000000ull;
+    while(!Stop) {
+        UBYTE ret = ADS1263_Latest_Read(&latest, &sweep);
+        if(ret == 2) {
+            // The producer died mid-write; wait for its successor's new object
+            if(!abandoned)
+                fprintf(stderr, "hzwatch: snapshot abandoned, attaching again \r\n");
+            abandoned = 1;
+            ADS1263_Latest_Detach(&latest);
+            do {
+                usleep(100000);
+            } while(!Stop && ADS1263_Latest_Attach(&latest, Name) != 0);
+            found = 0;
+            continue;
+        }
+        abandoned = 0;
+        if(ret != 0) {
+            usleep(10000);
+            continue;
+        }
+        reads++;
+        if(sweep.Sequence != last)
+            changes++;
+        last = sweep.Sequence;
+        if(Now_ns() < report)
+            continue;
+        // Look the names up again when the map changed
+        if(!found || sweep.Epoch != epoch) {
+            for(c = 0; c < Channels; c++)
+                index[c] = ADS1263_Latest_Find(&latest, Channel[c], &epoch);
+            found = 1;
+        }
+        printf("%llu reads/s (%.0f ns each), %llu sweeps/s, sweep %llu, %d values", (unsigned long long)reads,
+               1e9 / reads, (unsigned long long)changes, (unsigned long long)sweep.Sequence, sweep.Count);
+        for(c = 0; c < Channels; c++) {
+            if(index[c] >= 0 && sweep.Epoch == epoch)
+                printf(", %s %.6f V", Channel[c], sweep.Value[index[c]].Volt);
+            else
+                printf(", %s ?", Channel[c]);
+        }
+        printf(" \r\n");
+        reads = changes = 0;
+        report += 1000000000ull;
+    }
+    ADS1263_Latest_Detach(&latest);
+    return 0;
+}
+
+int main(int argc, char **argv)
+{
+    const char *name = NULL;
+    const ADS1263_FRAME *frame;
+    ADS1263_SHM ring;
+    ADS1263_FRAME_HEADER last;
+    uint64_t report = 0, read = 0, missed = 0;
+    long delay = 0;
+    UBYTE oldest = 0, rows = 0, poll = 0, chip, i;
+    int opt;
+
+    while((opt = getopt(argc, argv, "n:od:rl")) != -1) {
+        switch(opt) {
+        case 'n': name = optarg; break;
+        case 'l': poll = 1; break;
+        case 'o': oldest = 1; break;
+        case 'd': delay = atol(optarg); break;
+        case 'r': rows = 1; break;
+        default: Usage();
+        }
+    }
+    if(poll)
+        return Poll(name ? name : ADS1263_LATEST_NAME, argv + optind, argc - optind);
+    if(name == NULL)
+        name = ADS1263_SHM_NAME;
+    if(ADS1263_Shm_Attach(&ring, name) != 0) {
+        fprintf(stderr, "hzwatch: no sweep ring %s \r\n", name);
+        return 1;
+    }
+    if(oldest && ring.Next >= ring.Header->Slots)
+        ring.Next = ring.Next - ring.Header->Slots + 1;
+    else if(oldest)
+        ring.Next = 0;
+    printf("%s: producer %lu, %lu slots, %llu sweeps published, %lu restarts \r\n", name,
+           (unsigned long)ring.Header->Pid, (unsigned long)ring.Header->Slots, (unsigned long long)ring.Header->Head,
+           (unsigned long)ring.Header->Restarts);
+    signal(SIGINT, Handler);
+    memset(&last, 0, sizeof(last));
+    report = Now_ns() + 1000000000ull;
+
+    while(!Stop) {
+        ADS1263_SHM_STATUS status = ADS1263_Shm_Peek(&ring, &frame);
+        if(status == ADS1263_SHM_CLOSED) {
+            printf("producer closed the ring \r\n");
+            break;
+        }
+        if(status == ADS1263_SHM_EMPTY)
+            ADS1263_Shm_Wait(&ring, 200);
+        if(status == ADS1263_SHM_OK) {
+            ADS1263_FRAME_HEADER header = frame->Header;
+            if(rows) {
+                printf("%llu", (unsigned long long)header.Sequence);
+                for(chip = 0; chip < header.ChipCount && chip < ADS1263_MAX_CHIPS; chip++) {
+                    for(i = 0; i < frame->Count[chip] && i < ADS1263_FRAME_STRIDE; i++)
+                        printf(" %.6f", frame->Volt[chip][i]);
+                }
+            }
+            // Only what survived the check is trusted
+            if(ADS1263_Shm_Done(&ring) == ADS1263_SHM_OK) {
+                last = header;
+                if(rows)
+                    printf(" \r\n");
+            } else if(rows) {
+                printf(" (overwritten) \r\n");
+            }
+            if(delay > 0)
+                usleep(delay);
+        }
+        if(Now_ns() >= report) {
+            printf("read %llu/s, missed %llu/s, sweep %llu, state %d, flags 0x%lx \r\n",
+                   (unsigned long long)(ring.Read - read), (unsigned long long)(ring.Missed - missed),
+                   (unsigned long long)last.Sequence, last.CalState, (unsigned long)last.Flags);
+            read = ring.Read;
+            missed = ring.Missed;
+            report += 1000000000ull;
+        }
+    }
+    printf("read %llu, missed %llu \r\n", (unsigned long long)ring.Read, (unsigned long long)ring.Missed);
+    ADS1263_Shm_Detach(&ring);
+    return 0;
+}